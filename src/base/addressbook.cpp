@@ -35,7 +35,9 @@ bool AddressBook::loadFromFile() {
 		return false;
 
 	nOT::nUtils::cConfigManager utils;
-	utils.Load(path, contacts);
+	map<string, string> loaded;
+	utils.Load(path, loaded);
+	contacts.FromMap(loaded);
 
 	if (getCount() == 0)
 		_warn("Empty address book");
@@ -64,7 +66,7 @@ bool AddressBook::add(const string & nymName, const string & nymID) {
 	nOT::nUtils::cConfigManager utils;
 
 	try {
-		contacts.insert(contact);
+		contacts.Set(contact.first, contact.second);
 		utils.SaveStr(path, contact);
 		_dbg3("all ok");
 	} catch (...) {
@@ -75,16 +77,9 @@ bool AddressBook::add(const string & nymName, const string & nymID) {
 }
 
 bool AddressBook::nymExist(const string &nymID) const {
-	auto count = contacts.count(nymID);
-	_dbg3("check existance nym: " << nymID << " ->" << count);
-	if (count == 0) {
-		return false;
-	} else if (count == 1)
-		return true;
-	else {
-		throw "duplicate entry in AddressBook!";
-		return false;
-	}
+	const bool exists = contacts.Has(nymID);
+	_dbg3("check existance nym: " << nymID << " ->" << exists);
+	return exists;
 }
 
 bool AddressBook::nymNameExist(const string & nymName) const {
@@ -92,20 +87,18 @@ bool AddressBook::nymNameExist(const string & nymName) const {
 }
 
 string AddressBook::nymGetID(const string & nymName) const {
-	for (auto it = contacts.begin(); it != contacts.end(); ++it)
-		if (it->second == nymName) {
-			_info("nym " << nymName << " exists in addressBook");
-			return it->first;
-		}
+	const string nymID = contacts.IdOf(nymName);
+	if (!nymID.empty()) {
+		_info("nym " << nymName << " exists in addressBook");
+		return nymID;
+	}
 	_info("nym " << nymName << " DOESN'T exist in addressBook");
 	return "";
 }
 
 string AddressBook::nymGetName(const string & id) const {
-	auto it = contacts.find(id);
-	if (it == contacts.end())
-		return "";
-	return it->second;
+	const string * name = contacts.FindName(id);
+	return name ? *name : "";
 }
 
 void AddressBook::display() {
@@ -121,7 +114,7 @@ void AddressBook::display() {
 	tp.PrintHeader();
 
 	int i = 0;
-	for (auto pair : contacts) {
+	for (const auto & pair : contacts.ToMap()) {
 		tp << i << pair.second << pair.first;
 		++i;
 	}
@@ -134,15 +127,14 @@ bool AddressBook::remove(const string & nymID) {
 		_warn("Can't find nym: " << nymID);
 		return false;
 	}
-	auto copyOfConacts = this->contacts;
+	auto copyOfConacts = contacts.ToMap();
 	try {
-		contacts.erase(nymID);
-		saveContacts(contacts);
+		contacts.Erase(nymID);
+		saveContacts();
 		_info("removing nym: " << nymID << " successfull");
 	} catch (...) {
-		contacts.clear();
-		contacts = copyOfConacts;
-		saveContacts(contacts);
+		contacts.FromMap(copyOfConacts);
+		saveContacts(copyOfConacts);
 		_erro("can't remove nym: " << nymID << ", aborting");
 		return false;
 	}
@@ -152,8 +144,8 @@ bool AddressBook::remove(const string & nymID) {
 
 void AddressBook::removeAll() {
 	_warn("deleting all entires from address book");
-	for(auto nym : contacts)
-		remove(nym.first);
+	for(const auto & nymID : contacts.GetIds())
+		remove(nymID);
 }
 
 void AddressBook::saveContacts(map<string, string> contacts) {
@@ -169,7 +161,7 @@ void AddressBook::saveContacts(map<string, string> contacts) {
 }
 
 void AddressBook::saveContacts() {
-	saveContacts(this->contacts);
+	saveContacts(contacts.ToMap());
 }
 
 bool AddressBook::nymExport(const string & nymName, const string &nymID, const string & filename) {
@@ -207,12 +199,7 @@ bool AddressBook::nymImport(const string & filename) {
 }
 
 vector<string> AddressBook::getAllNames() {
-	vector<string> nyms;
-	nyms.reserve(contacts.size());
-	for (auto pair : contacts) {
-		nyms.push_back(pair.second);
-	}
-	return nyms;
+	return contacts.GetNames();
 }
 
 AddressBook::~AddressBook() {
@@ -2,6 +2,7 @@
 #define ADDRESSBOOK_HPP_
 
 #include "lib_common2.hpp"
+#include "compact_id.hpp"
 
 namespace nOT {
 class AddressBook {
@@ -10,7 +11,7 @@ public:
 public:
 	AddressBook(const string & nymID); ///< constructor, should be called only from Load() function @see Load()
 	static shared_ptr<AddressBook> Load(const string &nymID); ///< creates AddressBook object and returns shared pointer to it, this function should be used only from AddressBookSorade
-	size_t getCount() { return contacts.size(); }; ///< get numbers of contact
+	size_t getCount() { return contacts.Size(); }; ///< get numbers of contact
 
 	bool add(const string & nymName, const string & nymID); ///< adding new nym to address book
 	bool nymExist(const string & nymID) const; ///< check nym exists (by ID)
@@ -48,7 +49,7 @@ private:
 
 	const string ownerNymID;
 	string path;
-	map<string, string> contacts;
+	nUtils::cIdNameMap contacts; ///< nym ID -> name
 };
 
 class AddressBookStorage {
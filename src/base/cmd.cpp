@@ -6,6 +6,8 @@
 
 #include "lib_common3.hpp"
 #include "ccolor.hpp"
+#include "stats.hpp"
+#include "fuzzy_match.hpp"
 #include <iomanip>
 
 
@@ -24,6 +26,19 @@ ostream& operator<<(ostream &stream, const cParseEntity & obj) {
 	return stream;
 }
 
+/// Kind of entity for a word as classified by the grammar
+static cParseEntity::tKind EntityKind(cCmdGrammar::tToken token) {
+	switch (token) {
+		case cCmdGrammar::tToken::cmdname: return cParseEntity::tKind::cmdname;
+		case cCmdGrammar::tToken::variable: return cParseEntity::tKind::variable;
+		case cCmdGrammar::tToken::variable_ext: return cParseEntity::tKind::variable_ext;
+		case cCmdGrammar::tToken::option_name: return cParseEntity::tKind::option_name;
+		case cCmdGrammar::tToken::option_value: return cParseEntity::tKind::option_value;
+		case cCmdGrammar::tToken::none: break;
+	}
+	return cParseEntity::tKind::unknown;
+}
+
 // ========================================================================================================================
 
 void cCmdParser_pimpl::BuildCache_CmdNames() {
@@ -63,6 +78,17 @@ void cCmdParser_pimpl::BuildCache_CmdNames() {
 
 }
 
+void cCmdParser_pimpl::BuildGrammar() {
+	vector<cCmdGrammar::cFormatSpec> specs;
+	mGrammarFormat.clear();
+	for (const auto &elem : mTree) {
+		const cCmdFormat & format = *elem.second;
+		specs.push_back( cCmdGrammar::cFormatSpec{ elem.first, format.mVar.size(), format.mVarExt.size() } );
+		mGrammarFormat.push_back(elem.second);
+	}
+	mGrammar.Compile(specs);
+}
+
 // ------------------------------------------------------------------------------------------------------------------------
 
 // *** cCmdParser ***
@@ -161,6 +187,14 @@ const vector<string> & cCmdParser::GetCmdNamesWord2(const string &word1) const {
 		return mNoWords;
 }
 
+const cCmdGrammar & cCmdParser::GetGrammar() const {
+	return mI->mGrammar;
+}
+
+shared_ptr<cCmdFormat> cCmdParser::GetGrammarFormat(int ix) const {
+	return mI->mGrammarFormat.at(ix);
+}
+
 // ========================================================================================================================
 
 cCmdName::cCmdName(const string &name) :
@@ -207,6 +241,7 @@ void cCmdProcessing::Validate() {
 }
 
 void cCmdProcessing::_Validate() {
+	_stats_scope("cmd::_Validate"); // includes _Parse if not parsed yet
 	if (mStateParse != tState::succeeded)
 		Parse();
 	if (mStateParse != tState::succeeded) {
@@ -228,8 +263,7 @@ void cCmdProcessing::_Validate() {
 	for (size_t nr = 1; nr <= sizeAll; ++nr) { // TODO:nrix
 		auto var = mData->Var(nr); // get the var
 		const cParamInfo & info = mFormat->GetParamInfo(nr);
-		auto func = info.GetFuncValid();
-		bool ok = func(*mUse, *mData, nr - 1); // ***
+		bool ok = info.Valid(*mUse, *mData, nr - 1); // ***
 		if (!ok) {
 			const string err = ToStr("Validation failed at nr=") + ToStr(nr) + " for var=" + ToStr(var);
 			_warn(err);
@@ -264,6 +298,7 @@ void cCmdProcessing::Parse(bool allowBadCmdname) {
 }
 
 void cCmdProcessing::_Parse(bool allowBadCmdname) {
+	_stats_scope("cmd::_Parse");
 	// int _dbg_ignore=50;
 	const string logname = "parser";
 	bool dbg = 1;
@@ -285,6 +320,10 @@ void cCmdProcessing::_Parse(bool allowBadCmdname) {
 	{ // initial parsing
 
 		mCommandLine.clear();
+		const size_t words_max = std::count(mCommandLineString.begin(), mCommandLineString.end(), ' ') + 2; // +1 for "ot" added to "help"
+		mCommandLine.reserve(words_max);
+		mData->mWordIx2Entity.reserve(words_max);
+		mData->ReserveText(mCommandLineString.size());
 
 		// [doc] praser documentation
 
@@ -374,7 +413,6 @@ void cCmdProcessing::_Parse(bool allowBadCmdname) {
 	if (dbg)
 		_dbg3_c(logname, "Shift: mCharShift=" << mData->mCharShift << " mFirstWord="<<mData->mFirstWord);
 
-	int phase = 0; // 0: cmd name  1:var, 2:varExt  3:opt   9:end
 	try {
 		if (mCommandLine.size() == 0) {
 			const string s = "No words (besides pre ot)";
@@ -382,32 +420,14 @@ void cCmdProcessing::_Parse(bool allowBadCmdname) {
 			throw cErrParseSyntax(s);
 		}
 
-		// phase0 - the command name
-		string name_tmp = mCommandLine.at(0); // build the name of command, start with 1st word like "msg" or "help"
-		if (mCommandLine.size() > 1) {// if NOT one-word command like "help", then:
-			string name_tmp2 = name_tmp + " " + mCommandLine.at(1);
-			if (mParser->FindFormatExists(name_tmp) && mParser->FindFormatExists(name_tmp2)) { // if the second word is CmdName
-				if (mCommandLine.size() > 1) { // take 2nd word as part of the name
-					namepart_words++;
-					name_tmp += " " + mCommandLine.at(1);
-				}
-			} else if (mParser->FindFormatExists(name_tmp2)) { // if the second word is CmdName
-				if (mCommandLine.size() > 1) { // take 2nd word as part of the name
-					namepart_words++;
-					name_tmp += " " + mCommandLine.at(1);
-				}
-			} else if (!mParser->FindFormatExists(name_tmp)) { // like "msg" - this can not be a 1word command
-				if (mCommandLine.size() > 1) { // take 2nd word as part of the name
-					namepart_words++;
-					name_tmp += " " + mCommandLine.at(1);
-				}
-			}
-		} // more then 1 word
+		// one pass of the compiled grammar: which words are the command name, arguments, options
+		const cCmdGrammar::cRun run = mParser->GetGrammar().Run(mCommandLine, allowBadCmdname);
 
+		string name_tmp = mCommandLine.at(0); // "msg send" or "help"
+		if (run.mNameWords > 1) name_tmp += " " + mCommandLine.at(1);
 		const string name = name_tmp;
-		namepart_words++;
+		namepart_words += run.mNameWords;
 
-		// "msg send" or "help"
 		_dbg1_c(logname, "Name of command is: " << name << " namepart_words="<<namepart_words);
 		mData->mFirstArgAfterWord = namepart_words;
 
@@ -418,182 +438,53 @@ void cCmdProcessing::_Parse(bool allowBadCmdname) {
 		if (dbg)
 			_dbg2_c(logname, "Words position mWordIx2Entity=" << DbgVector(mData->mWordIx2Entity));
 
-		try {
-			mFormat = mParser->FindFormat(name); // <---
-		} catch (cErrParseName &e) {
+		if (run.mStatus == cCmdGrammar::tStatus::bad_name) {
 			if (allowBadCmdname) {
 				mFailedAfterBadCmdname = true;
 				return; // <=== RETURN.  exit, but report that we given up early  <===========================
-			} else {
-				throw;
-			} // else just panic - throw // <======
+			}
+			throw cErrParseName("No such ot command=" + name); // else just panic - throw // <======
 		}
+		mFormat = mParser->GetGrammarFormat(run.mFormat); // <---
 		_info_c(logname, "Got format for name="<<name);
 
-		// msg send
-		// msg ls
-		// always 2 words are the command (we assume there are no sub-command)
-		const size_t words_count = mCommandLine.size();
-		const cCmdFormat & format = *mFormat; // const to be sure to just read from it (we are friends of this class)
-		const size_t var_size_normal = format.mVar.size(); // number of the normal (mandatory) part of variables
-		const size_t var_size_all = format.mVar.size() + format.mVarExt.size(); // number of the size of all variables (normal + extra)
-		_dbg2_c(logname, "Format: size of vars: " << var_size_normal << " normal, and all is: " << var_size_all);
-
-		size_t pos = 2; // number of currently parsed word "msg send"
-		if (name.find(" ") == string::npos)
-			pos = 1; // in case of 1-word name
-
-		phase = 1;
-		const size_t offset_to_var = pos; // skip this many words before we have first var, to conver pos(word number) to var number
-		size_t quotes_offset_to_var = 0;
-		if (phase == 1) { // phase: parse variable
-			while (true) { // parse var normal
-				const int var_nr = pos - offset_to_var - quotes_offset_to_var;
-				_dbg2_c(logname, "phase="<<phase<<" pos="<<pos<<" var_nr="<<var_nr);
-				if (pos >= words_count) {
-					_dbg1_c(logname, "reached END, pos="<<pos);
-					phase = 9;
-					break;
-				}
-				if ( var_nr >= (xsize_t)var_size_normal) {
-					_dbg1_c(logname, "reached end of var normal, var_nr="<<var_nr);
-					phase = 2;
-					break;
-				}
-
-				string word = mCommandLine.at(pos);
-				_dbg1_c(logname, "phase="<<phase<<" pos="<<pos<<" word="<<word);
-				++pos;
-				mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::variable, var_nr);
-
-				if (nUtils::CheckIfBegins("\"", word)) { // TODO review memory access
-					_dbg1_c(logname, "Quotes detected in: " + word);
-					word.erase(0, 1);
-					while (!nUtils::CheckIfEnds("\"", word)) {
-						word += " " + mCommandLine.at(pos);
-						++pos;
-						++quotes_offset_to_var;
+		for (size_t ix = run.mNameWords; ix < run.mWord.size(); ++ix) { // the words after name, as classified (up to error, if any)
+			const cCmdGrammar::cWord & word = run.mWord.at(ix);
+			const size_t entity_ix = ix + mData->mFirstWord;
+			if (entity_ix < mData->mWordIx2Entity.size())
+				mData->mWordIx2Entity.at(entity_ix).SetKind(EntityKind(word.mToken), word.mSub);
+
+			switch (word.mToken) {
+				case cCmdGrammar::tToken::variable:
+				case cCmdGrammar::tToken::variable_ext: {
+					if (word.mJoin) break; // already added with the word that started the quote
+					string text = mCommandLine.at(ix);
+					for (size_t next = ix + 1; (next < run.mWord.size()) && run.mWord.at(next).mJoin; ++next)
+						text += " " + mCommandLine.at(next);
+					if (nUtils::CheckIfBegins("\"", text)) {
+						text = text.substr(1, text.size() - 2); // without the quotes
+						_dbg1_c(logname, "Quoted word is:"<<text);
 					}
-					word.erase(word.end() - 1, word.end()); // ease the closing " of last mCommandLine[..] that is not at end of word
-					_dbg1_c(logname, "Quoted word is:"<<word);
-				}
-				if (nUtils::CheckIfBegins("--", word)) { // --bcc foo
-					phase = 3;
-					--pos; // this should be re-prased in proper phase
-					_dbg1_c(logname, "Got an --option, so jumping to phase="<<phase);
-					break; // continue to phase 3 - the options
-				}
-
-				_dbg1_c(logname, "adding var "<<word);
-				mData->mVar.push_back(word);
-			}
-		} // parse var phase 1
-
-		_mark_c(logname, "Words position mWordIx2Entity=" << DbgVector(mData->mWordIx2Entity));
-
-		if (phase == 2) {
-			while (true) { // parse var extra
-				const int var_nr = pos - offset_to_var - quotes_offset_to_var;
-				_dbg2_c(logname, "phase="<<phase<<" pos="<<pos<<" var_nr="<<var_nr);
-				if (pos >= words_count) {
-					_dbg1_c(logname, "reached END, pos="<<pos);
-					phase = 9;
-					break;
-				}
-				if (var_nr >= xsize_t(var_size_all)) {
-					_dbg1_c(logname, "reached end of var ALL, var_nr="<<var_nr);
-					phase = 3;
-					break;
-				}
-
-				string word = mCommandLine.at(pos);
-				_dbg1_c(logname, "phase="<<phase<<" pos="<<pos<<" word="<<word);
-				++pos;
-				mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::variable_ext, var_nr);
-
-				if (nUtils::CheckIfBegins("\"", word)) { // TODO review memory access
-					_dbg1_c(logname, "Quotes detected in: " + word);
-					word.erase(0, 1);
-					while (!nUtils::CheckIfEnds("\"", word)) {
-						word += " " + mCommandLine.at(pos);
-						++pos;
-						++quotes_offset_to_var;
-					}
-					word.erase(word.end() - 1, word.end()); // ease the closing " of last mCommandLine[..] that is not at end of word
-					_dbg1_c(logname, "Quoted word is:"<<word);
-				}
-				if (nUtils::CheckIfBegins("--", word)) { // --bcc foo
-					phase = 3;
-					--pos; // this should be re-prased in proper phase
-					_dbg1_c(logname, "Got an --option, so jumping to phase="<<phase);
-					break; // continue to phase 3 - the options
-				}
-
-				_dbg1_c(logname, "adding var ext "<<word);
-				mData->mVarExt.push_back(word);
+					_dbg1_c(logname, "adding var "<<text);
+					if (word.mToken == cCmdGrammar::tToken::variable) mData->AddVar(text);
+					else mData->AddVarExt(text);
+				} break;
+				case cCmdGrammar::tToken::option_name: {
+					const bool has_value = (ix + 1 < run.mWord.size()) && (run.mWord.at(ix + 1).mToken == cCmdGrammar::tToken::option_value);
+					const string value = has_value ? mCommandLine.at(ix + 1) : "";
+					mData->AddOpt(mCommandLine.at(ix), value);
+					_dbg1_c(logname, "got option "<<mCommandLine.at(ix)<<" with value="<<value);
+				} break;
+				default: break; // option value (added with its name), or 2nd word of command name tolerated in completion
 			}
-		} // phase 2
-
-		if (phase == 3) {
-			string prev_name = "";
-			bool inside_opt = false; // are we now in middle of --option ?  curr_name is the opt name like "--cc"
-			int token_nr = 0;
-			while (true) { // parse options
-				++token_nr;
-				if (pos >= words_count) {
-					_dbg1_c(logname, "reached END, pos="<<pos);
-					phase = 9;
-					break;
-				}
-
-				string word = mCommandLine.at(pos);
-				_dbg1_c(logname, "phase="<<phase<<" pos="<<pos<<" word="<<word<<" (token_nr="<<token_nr<<")");
-				++pos;
-
-				bool is_newopt = nUtils::CheckIfBegins("--", word); // word is opt name like "--cc"
-
-				if (is_newopt) { // some new option like --private or --cc
-					if (inside_opt) { // finish the previos option, that didn't got a value then.  --fast [--private]
-						inside_opt = false;
-						mData->AddOpt(prev_name, ""); // ***
-						mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::option_name); // TODO sub number!
-						_dbg1_c(logname, "got option "<<prev_name<<" (empty)");
-					}
-					inside_opt = true;
-					prev_name = word; // we now started the new option (and next iteration will finish it)
-					_dbg3_c(logname, "started new option: prev_name="<<prev_name);
-				} else { // not an --option, so should be a value to finish previous one
-					if (inside_opt) { // we are in middle of option, now we have the argment that ends it: --cc [alice]
-						string value = word; // like "alice"
-						inside_opt = false;
-						mData->AddOpt(prev_name, value);
-						mData->mWordIx2Entity.at(pos - 1).SetKind(cParseEntity::tKind::option_name); // e.g. "--cc" // TODO sub number!
-						mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::option_value); // e.g. "alice" // TODO sub number!
-						_dbg1_c(logname, "got option "<<prev_name<<" with value="<<value);
-					} else { // we have a word like "bob", but we are not in middle of an option - syntax error
-							 // this is the special case of "ot nym inf" the word "inf" might be not a wrong use of --option, but 2nd word of command name being entered
-						_dbg3_c(logname, "TOLERATE? token_nr"<<token_nr<<" namepart_words="<<namepart_words<<" allowBadCmdname="<<allowBadCmdname);
-						if ((token_nr == 1) && (namepart_words == 1) && (allowBadCmdname)) {
-							_dbg2_c(logname, "Tollerating this option-or-nameword2 here at pos="<<pos);
-							mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::cmdname, 2); // assume this is 2nd word of command
-						} else {
-							throw cErrParseSyntax("Expected an --option here, but got a word=" + ToStr(word) + " at pos=" + ToStr(pos));
-						}
-					}
-				}
-			} // all words
-			if (inside_opt) { // finish the previos LAST option, that didn't got a value then.  --fast [--private] (END)
-				inside_opt = false;
-				mData->AddOpt(prev_name, "");
-				mData->mWordIx2Entity.at(pos).SetKind(cParseEntity::tKind::option_name); // TODO sub number!
-				_dbg1_c(logname, "got option "<<prev_name<<" (empty) - on end");
-			}
-		} // phase 3
+		}
+		if (run.mStatus == cCmdGrammar::tStatus::syntax)
+			throw cErrParseSyntax(run.mError);
 
 		_note_c(logname, "Entities:" << DbgVector(mData->mWordIx2Entity));
-		_note_c(logname, "mVar parsed:    " + DbgVector(mData->mVar));
-		_note_c(logname, "mVarExt parsed: " + DbgVector(mData->mVarExt));
-		_note_c(logname, "mOption parsed  " + DbgMap(mData->mOption));
+		_note_c(logname, "mVar parsed:    " + DbgVector(mData->getmVar()));
+		_note_c(logname, "mVarExt parsed: " + DbgVector(mData->getmVarExt()));
+		_note_c(logname, "mOption parsed  " + DbgMap(mData->getmOption()));
 	} catch (cErrParse &e) {
 		_info_c(logname, "Command can not be parsed " << e.what());
 		throw;
@@ -606,7 +497,14 @@ void cCmdProcessing::_Parse(bool allowBadCmdname) {
 	}
 }
 
+/// Candidates from hint sources (names of nyms, accounts...) - with +fuzzy also the ones with typos, ranked
+static vector<string> HintsThatMatch(const string & sofar, const vector<string> & hints) {
+	if (gRunOptions.getFuzzyCompletion()) return nUtils::WordsThatMatchFuzzy(sofar, hints);
+	return WordsThatMatch(sofar, hints);
+}
+
 vector<string> cCmdProcessing::UseComplete(int char_pos) {
+	_stats_scope("cmd::UseComplete"); // hint generation
 	const string logname = "completition";
 	_mark_c(logname, "Will complete command line: ["<<mCommandLineString<<"] at char_pos="<<char_pos); // mCommandLine is not parsed yet
 	const vector<string> allowed_pre_words = { "ot", "help" };
@@ -746,12 +644,14 @@ vector<string> cCmdProcessing::UseComplete(int char_pos) {
 
 		// handle empty word (the Parser did not told us what is/would be the type of token that is now beginning:
 		if (entity.mKind == cParseEntity::tKind::fake_empty) { // we are finishg an empty word - we are now creating a new word
-			// *** DUAL: handling DUAL choice, where user might be starting now an option or something else ***
-			// try to make an --option out of the DUAL
+			// the grammar run over the words before this one tells what can come next
+			const size_t words_before = std::min<size_t>(std::max(word_ix - mData->mFirstWord, 0), this->mCommandLine.size());
+			const vector<string> before(this->mCommandLine.begin(), this->mCommandLine.begin() + words_before);
+			const cCmdGrammar::cRun run = mParser->GetGrammar().Run(before, true);
+			_fact_c(logname, "next after " << DbgVector(before) << " is token=" << int(run.mNext) << " sub=" << run.mNextSub << " at mFormat:" << ( (mFormat!=nullptr) ? "yes":"null"));
 
-			cParseEntity entity_previous = mData->mWordIx2Entity.at(word_ix - 1);
-			_fact_c(logname, "checking DUAL vs entity_previous="<<entity_previous<<" at mFormat:" << ( (mFormat!=nullptr) ? "yes":"null"));
-			if ((entity_previous.mKind == cParseEntity::tKind::cmdname) && (entity_previous.mSub == 1) && (mFormat != nullptr)) {
+			// *** DUAL: handling DUAL choice, where user might be starting now an option or something else ***
+			if (run.mNextMayBeOption && (mFormat != nullptr)) {
 				// "msg ~" (or maybe... "msg -~" or "msg ad~") and "msg" is a valid command, so we add all options here, like "msg --dryrun"
 				// yes obviously "msg a~" will not be an option but this is ok e.g. code will add 0 options here and continue
 				_mark_c(logname, " OPTIONS NAMES: " << DbgVector(mFormat->GetPossibleOptionNames()));
@@ -759,50 +659,10 @@ vector<string> cCmdProcessing::UseComplete(int char_pos) {
 			}
 
 			// now finish the normal (not-options) part of DUAL:
-
-			if (entity_previous.mKind == cParseEntity::tKind::pre) { // we are adding new word after pre: so it will be command name
-				entity = cParseEntity(cParseEntity::tKind::cmdname, char_pos, 0);
-			} else if (entity_previous.mKind == cParseEntity::tKind::cmdname) { // after command name: 2nd word of command name or jump further to e.g. var/varExt/opt
-				// nym --> cmd (has 1-word variant)   [we assumed there will never be "nym arg1 ..." no args after 1-word cmd]
-				// msg     (has no 1-word variant)  --> cmd
-				// nym ls --> arg
-				// msg ls --> arg
-
-				if (entity_previous.mSub == 1) { // "nym" "msg"
-					if (mFormat != nullptr) { // "nym"
-						entity = cParseEntity(cParseEntity::tKind::cmdname, char_pos, 2); // now continue to parse this empty as command, word 2
-					} else { // "msg"
-						entity = cParseEntity(cParseEntity::tKind::cmdname, char_pos, 2); // now continue to parse this empty as command, word 2
-					}
-				} else if (entity_previous.mSub == 2) { // "nym ls" "msg ls"
-					entity = cParseEntity(cParseEntity::tKind::argument_somekind, char_pos, 1);
-				}
-			} // after a command
-			else if (entity_previous.mKind == cParseEntity::tKind::option_name) {
-				entity = cParseEntity(cParseEntity::tKind::option_value, char_pos, 0); // after option_name goes option_value
-			} else {
-				entity = cParseEntity(cParseEntity::tKind::argument_somekind, char_pos, 0); // else var/varExt/opt
-			}
+			if (run.mNext != cCmdGrammar::tToken::none)
+				entity = cParseEntity(EntityKind(run.mNext), char_pos, run.mNextSub);
 		} // fake empty
 
-		if (entity.mKind == cParseEntity::tKind::argument_somekind) {
-			_dbg1_c(logname, "Finding out which kind of argument is here, from entity="<<entity);
-			if (!mFormat) { // we do not yet have a format even
-				if (allwords.size() <= 1)
-					entity.SetKind(cParseEntity::tKind::cmdname); // in commad name... is 0 correct?
-				if (allwords.size() <= 2)
-					entity.SetKind(cParseEntity::tKind::cmdname); // in commad name... is 1 correct?
-			} else {
-				ASRT(mFormat);
-				if (arg_nr <= xsize_t(mFormat->mVar.size())) {
-					entity.SetKind(cParseEntity::tKind::variable);
-				} else if (arg_nr <= xsize_t(mFormat->SizeAllVar())) {
-					entity.SetKind(cParseEntity::tKind::variable_ext);
-				} else {
-					entity.SetKind(cParseEntity::tKind::option_name);
-				}
-			}
-		}
 		_fact_c(logname, "matching after DUAL: " << DbgVector(matching) << " and now entity="<<entity);
 
 		if (entity.mKind == cParseEntity::tKind::option_name) {
@@ -818,9 +678,8 @@ vector<string> cCmdProcessing::UseComplete(int char_pos) {
 				return vector<string> { }; // if we did not understood command name, then return empty vector
 			try {
 				const cParamInfo &info = format->mOption.at(option_name);
-				auto funcHint = info.GetFuncHint(); // typedef function< bool ( nUse::cUseOT &, cCmdData &, size_t ) > tFuncValid;
-				auto hint = (funcHint)(*mUse, *mData, word_ix);
-				matching += WordsThatMatch(word_sofar, hint);
+				auto hint = info.Hint(*mUse, *mData, word_ix, *mParser);
+				matching += HintsThatMatch(word_sofar, hint);
 				// TODO check if the word_ix here is correct
 				return matching;
 			} catch (std::exception &e) {
@@ -831,17 +690,17 @@ vector<string> cCmdProcessing::UseComplete(int char_pos) {
 			ASRT(mFormat);
 			//if (!fake_empty) ASRT( mData->V(arg_nr) == word_sofar ); // the current work == current arg. (unless this is new word) VYRLY - dont wan't it because there can be more words than args
 			cParamInfo param_info = mFormat->GetParamInfo(arg_nr); // eg. pNymFrom  <--- info about kind (completion function etc) of argument that we now are tab-completing
-			auto completions = param_info.GetFuncHint()(*mUse, *mData, arg_nr);
+			auto completions = param_info.Hint(*mUse, *mData, arg_nr, *mParser);
 			_info_c(logname, "Var completions: " << DbgVector(completions));
-			return matching + WordsThatMatch(word_sofar, completions);
+			return matching + HintsThatMatch(word_sofar, completions);
 		} else if (entity.mKind == cParseEntity::tKind::variable_ext) {
 			_info_c(logname, "Completing variable_ext as arg_nr="<<arg_nr);
 			ASRT(mFormat);
 			if (!fake_empty)
 				ASRT(mData->v(arg_nr) == word_sofar); // the current work == current arg. (unless this is new word)
 			cParamInfo param_info = mFormat->GetParamInfo(arg_nr); // eg. pNymFrom  <--- info about kind (completion function etc) of argument that we now are tab-completing
-			auto completions = param_info.GetFuncHint()(*mUse, *mData, arg_nr);
-			return matching + WordsThatMatch(word_sofar, completions);
+			auto completions = param_info.Hint(*mUse, *mData, arg_nr, *mParser);
+			return matching + HintsThatMatch(word_sofar, completions);
 		} else if (entity.mKind == cParseEntity::tKind::cmdname) {
 			const int cmd_word_nr = entity.mSub;
 			_info_c(logname, "Completing command name cmd_word_nr="<<cmd_word_nr<<" after_word="<<after_word<<" word_sofar="<<word_sofar);
@@ -921,6 +780,7 @@ void cCmdProcessing::UseExecute() { // TODO write as a template for all the 3 wr
 }
 
 void cCmdProcessing::_UseExecute() {
+	_stats_scope("cmd::_UseExecute"); // includes the OTAPI calls
 	if (!mFormat) {
 		_warn("Can not execute this command - mFormat is empty");
 		return;
@@ -938,11 +798,13 @@ void cValidateError::Print() const {
 
 // ========================================================================================================================
 
-cParamInfo::cParamInfo(const string &name, tFuncDescr descr, tFuncValid valid, tFuncHint hint, tFlags mFlags) :
+static_assert( std::is_trivially_copyable<cParamInfo>::value , "cParamInfo is copied into every format, keep it plain" );
+
+cParamInfo::cParamInfo(const char *name, tFuncDescr descr, tFuncValid valid, tFuncHint hint, tFlags mFlags) :
 		mName(name), funcDescr(descr), funcValid(valid), funcHint(hint), mFlags(mFlags) {
 }
 
-cParamInfo::cParamInfo(const string &name, tFuncDescr descr) :
+cParamInfo::cParamInfo(const char *name, tFuncDescr descr) :
 		mName(name), funcDescr(descr) {
 }
 
@@ -958,7 +820,7 @@ cParamInfo cParamInfo::operator<<(const cParamInfo &B) const {
 }
 
 bool cParamInfo::IsValid() const {
-	if (mName.length() < 1) {
+	if ((!mName) || (!mName[0])) {
 		_warn("Invalid cParamInfo with empty name!");
 		return false;
 	}
@@ -1139,7 +1001,27 @@ size_t cCmdData::SizeAllVar() const { // return size of required mVar + optional
 	return mVar.size() + mVarExt.size();
 }
 
-string cCmdData::VarAccess(int nr, const string &def, bool doThrow) const { // see [nr] ; if doThrow then will throw on missing var, else returns def
+void cCmdData::ReserveText(size_t line_size) {
+	mText.Reserve(2 * line_size + 1); // each word at most twice (as typed, and spaced) - so views never move
+}
+
+cCmdData::cVarSpan cCmdData::MakeVar(const string &word) {
+	cVarSpan var;
+	var.mRaw = mText.Add(word);
+	var.mSpaced = var.mRaw;
+	if (word.find('#') != string::npos) var.mSpaced = mText.Add(nUtils::SpaceFromSpecial(word)); // see SpecialFromEscape
+	return var;
+}
+
+void cCmdData::AddVar(const string &word) {
+	mVar.push_back(MakeVar(word));
+}
+
+void cCmdData::AddVarExt(const string &word) {
+	mVarExt.push_back(MakeVar(word));
+}
+
+const cCmdData::cVarSpan * cCmdData::VarAccess(int nr, bool doThrow) const { // see [nr] ; if doThrow then will throw on missing var, else returns nullptr
 	if (nr <= 0)
 		throw cErrArgIllegal("Illegal number for var, nr=" + ToStr(nr) + " (1,2,3... is expected)");
 	const int ix = nr - 1;
@@ -1149,14 +1031,14 @@ string cCmdData::VarAccess(int nr, const string &def, bool doThrow) const { // s
 			if (doThrow) {
 				throw cErrArgMissing("Missing argument: out of range number for var, nr=" + ToStr(nr) + " ix=" + ToStr(ix) + " ix_ext=" + ToStr(ix_ext) + " vs size=" + ToStr(mVarExt.size()));
 			}
-			return def; // just return the default
+			return nullptr; // caller uses the default
 		}
-		return mVarExt.at(ix_ext);
+		return & mVarExt[ix_ext];
 	}
-	return mVar.at(ix);
+	return & mVar[ix];
 }
 
-void cCmdData::AssertLegalOptName(const string &name) const {
+void cCmdData::AssertLegalOptName(tView name) const {
 	if (name.size() < 1)
 		throw cErrArgIllegal("option name can not be empty");
 	const size_t maxlen = 100;
@@ -1165,85 +1047,84 @@ void cCmdData::AssertLegalOptName(const string &name) const {
 	// TODO test [a-zA-Z0-9_.-]*
 }
 
-vector<string> cCmdData::OptIf(const string& name) const {
+std::pair<const cCmdData::cOptSpan *, const cCmdData::cOptSpan *> cCmdData::OptRange(tView name) const {
 	AssertLegalOptName(name);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
-		return vector<string> { };
-	}
-	return find->second;
+	auto less_name = [this] (const cOptSpan & opt, tView n) { return mText.Get(opt.mName) < n; };
+	auto name_less = [this] (tView n, const cOptSpan & opt) { return n < mText.Get(opt.mName); };
+	const cOptSpan * first = std::lower_bound(mOption.begin(), mOption.end(), name, less_name);
+	const cOptSpan * last = std::upper_bound(first, mOption.end(), name, name_less);
+	return std::make_pair(first, last);
 }
 
-string cCmdData::Opt1If(const string& name, const string &def) const { // same but requires the 1st element; therefore we need def argument again
-	AssertLegalOptName(name);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
-		return def;
-	}
-	const auto &vec = find->second;
-	if (vec.size() < 1) {
-		_warn("Not normalized opt for name="<<name);
+vector<string> cCmdData::OptIf(tView name) const {
+	auto range = OptRange(name);
+	vector<string> values;
+	values.reserve(range.second - range.first);
+	for (auto opt = range.first; opt != range.second; ++opt) values.push_back( mText.Get(opt->mValue) );
+	return values;
+}
+
+cCmdData::tView cCmdData::Opt1If(tView name, tView def) const { // same but requires the 1st element; therefore we need def argument again
+	auto range = OptRange(name);
+	if (range.first == range.second) {
 		return def;
 	}
-	return vec.at(0);
+	return mText.Get(range.first->mValue);
 }
 
-string cCmdData::VarDef(int nr, const string &def, bool doThrow) const {
-	return VarAccess(nr, def, false);
+cCmdData::tView cCmdData::VarDef(int nr, tView def, bool doThrow) const {
+	const cVarSpan * var = VarAccess(nr, false);
+	return var ? mText.Get(var->mRaw) : def;
 }
 
-string cCmdData::Var(int nr) const { // nr: 1,2,3,4 including both arg and argExt
-	static string nothing;
-	return nUtils::SpaceFromSpecial(VarAccess(nr, nothing, true));
+cCmdData::tView cCmdData::Var(int nr) const { // nr: 1,2,3,4 including both arg and argExt
+	return mText.Get(VarAccess(nr, true)->mSpaced);
 }
 
-vector<string> cCmdData::Opt(const string& name) const {
-	AssertLegalOptName(name);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
-		_warn("Map was: [TODO]");
+vector<string> cCmdData::Opt(tView name) const {
+	auto range = OptRange(name);
+	if (range.first == range.second) {
 		throw cErrArgMissing("Option " + name + " was missing");
 	}
-	return find->second;
+	return OptIf(name);
 }
 
-string cCmdData::Opt1(const string& name) const {
-	AssertLegalOptName(name);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
+cCmdData::tView cCmdData::Opt1(tView name) const {
+	auto range = OptRange(name);
+	if (range.first == range.second) {
 		throw cErrArgMissing("Option " + name + " was missing");
 	}
-	const auto &vec = find->second;
-	if (vec.size() < 1) {
-		_warn("Not normalized opt for name="<<name);
-		throw cErrArgMissing("Option " + name + " was missing (not-normalized empty vector)");
-	}
-	return vec.at(0);
+	return mText.Get(range.first->mValue);
 }
 
-bool cCmdData::IsOpt(const string &name) const {
-	AssertLegalOptName(name);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
-		return false; // no such option entry
-	}
-	auto &vect = find->second;
-	if (vect.size()) {
-		return true; // yes, there is an option
-	}
-
-	_warn("Not normalized options for name="<<name<<" an empty vector exists there:" << DbgVector(vect));
-	return false; // there was a vector for this options but it's empty now (maybe deleted?)
+bool cCmdData::IsOpt(tView name) const {
+	auto range = OptRange(name);
+	return range.first != range.second;
 }
 
 void cCmdData::AddOpt(const string &name, const string &value) { // append an option with value (value can be empty
 	_dbg3("adding option ["<<name<<"] with value="<<value);
-	auto find = mOption.find(name);
-	if (find == mOption.end()) {
-		mOption.insert(std::make_pair(name, vector<string> { value }));
-	} else {
-		find->second.push_back(value);
-	}
+	auto range = OptRange(name);
+	const cOptSpan opt = { mText.Add(name), mText.Add(value) };
+	mOption.insert(range.second - mOption.begin(), opt); // after values given before
+}
+
+cCmdData::tVar cCmdData::getmVar() const {
+	tVar vars;
+	for (const auto & var : mVar) vars.push_back( mText.Get(var.mRaw) );
+	return vars;
+}
+
+cCmdData::tVar cCmdData::getmVarExt() const {
+	tVar vars;
+	for (const auto & var : mVarExt) vars.push_back( mText.Get(var.mRaw) );
+	return vars;
+}
+
+cCmdData::tOption cCmdData::getmOption() const {
+	tOption options;
+	for (const auto & opt : mOption) options[ mText.Get(opt.mName) ].push_back( mText.Get(opt.mValue) );
+	return options;
 }
 
 // ========================================================================================================================
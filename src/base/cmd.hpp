@@ -9,6 +9,7 @@ Template for new files, replace word "template" and later delete this line here.
 #include "lib_common1.hpp"
 
 #include "useot.hpp"
+#include "text_arena.hpp"
 
 namespace nOT {
 namespace nNewcli {
@@ -30,6 +31,7 @@ class cParamString;
 class cCmdExecutable;
 
 class cCmdParser_pimpl;
+class cCmdGrammar;
 
 // ============================================================================
 
@@ -151,6 +153,9 @@ class cCmdParser : public enable_shared_from_this<cCmdParser> { MAKE_CLASS_NAME(
 		shared_ptr<cCmdFormat> FindFormat( const cCmdName &name ) const;
 		bool FindFormatExists( const cCmdName &name ) const;
 
+		const cCmdGrammar & GetGrammar() const; // compiled command tree (after Init)
+		shared_ptr<cCmdFormat> GetGrammarFormat( int ix ) const; // format selected by a grammar run
+
 		void Init();
 		void Test();
 
@@ -227,6 +232,7 @@ class cCmdFormat {  MAKE_CLASS_NAME("cCmdFormat");
 		cCmdExecutable mExec;
 
 		friend class cCmdProcessing; // allow direct access (should be read-only!)
+		friend class cCmdParser_pimpl; // reads the sizes to compile grammar
 
 	public:
 		cCmdFormat(const cCmdExecutable &exec, const tVar &var, const tVar &varExt, const tOption &opt);
@@ -252,18 +258,35 @@ class cCmdData {  MAKE_CLASS_NAME("cCmdData");
 	public:
 		typedef vector<string> tVar;
 		typedef map<string, vector<string> > tOption; // even single (not-multi) options will be placed in vector (1-element)
+		typedef nUtils::cStrView tView; // points into this object - valid as long as it is
 
 	protected:
 
 		friend class cCmdProcessing; // it will fill-in this class fields directly
-		tVar mVar, mVarExt;
-		tOption mOption;
 
+		// all parsed text is in one buffer (reserved for the whole command line, so parsing allocates it once), the rest are spans into it:
+		struct cVarSpan {
+			nUtils::cTextSpan mRaw; // as typed (escaped space is the special character)
+			nUtils::cTextSpan mSpaced; // special character back to space (same span as mRaw if there was none)
+		};
+		struct cOptSpan {
+			nUtils::cTextSpan mName, mValue;
+		};
+
+		nUtils::cTextArena mText;
+		nUtils::cSmallVec<cVarSpan, 8> mVar, mVarExt;
+		nUtils::cSmallVec<cOptSpan, 8> mOption; // sorted by name, values of same option kept in order given
+
+		void ReserveText(size_t line_size); // before adding anything: views given out later stay valid
+		void AddVar(const string &word);
+		void AddVarExt(const string &word);
 		void AddOpt(const string &name, const string &value); // append an option with value (value can be empty)
 
 		// [nr] REMARK: the argument "nr" is indexed like 1,2,3,4 (not from 0) and is including both arg and argExt.
 
-		string VarAccess(int nr, const string &def, bool doThrow) const; // see [nr] ; if doThrow then will throw on missing var, else returns def
+		cVarSpan MakeVar(const string &word);
+		const cVarSpan * VarAccess(int nr, bool doThrow) const; // see [nr] ; if doThrow then will throw on missing var, else returns nullptr
+		std::pair<const cOptSpan *, const cOptSpan *> OptRange(tView name) const; // values of option name (empty range if none)
 
 	public:
 		cCmdData()=default;
@@ -280,44 +303,47 @@ class cCmdData {  MAKE_CLASS_NAME("cCmdData");
 			Var(3) throws exception
 			VarDef(3) returns "" and VarDef(3,"unknown") returns "unknown"
 
+		Single values are returned as views into this object (no copy); they convert to string when passed where string is needed.
+		A def given as temporary string lives only until end of the full expression - same as with const string & results.
 
 		Exceptions: please note, that the Var, Opt are throwing when the argument is not found normally, e.g. var nr=3 was requested but just 2 are present
 		the VarDef and OptIf avoid throwing usually - but they might throw cErrArgIllegal if the requested argument not just is not present but is totally illegal and can not be
 		ever present, e.g. if requestion var number -1 or option named "" or other illegal operation (so in programming error usually)
 		*/
 
-		string VarDef(int nr, const string &def="",  bool doThrow=0) const; // see [nr] ; return def if this var was missing
-		vector<string> OptIf(const string& name) const; // returns option values, or empty vector if missing (if none)
-		string Opt1If(const string& name, const string &def="") const; // same but requires the 1st element; therefore we need def argument again
+		tView VarDef(int nr, tView def="",  bool doThrow=0) const; // see [nr] ; return def if this var was missing
+		vector<string> OptIf(tView name) const; // returns option values, or empty vector if missing (if none)
+		tView Opt1If(tView name, tView def="") const; // same but requires the 1st element; therefore we need def argument again
 
-		string Var(int nr) const; // see [nr] ; throws if this var was missing
-		vector<string> Opt(const string& name) const; // --cc bob --bob alice returns option values, throws if missing (if none)
-		string Opt1(const string& name) const; // --prio 100 same but requires the 1st element
+		tView Var(int nr) const; // see [nr] ; throws if this var was missing
+		vector<string> Opt(tView name) const; // --cc bob --bob alice returns option values, throws if missing (if none)
+		tView Opt1(tView name) const; // --prio 100 same but requires the 1st element
 
-		bool IsOpt(const string &name) const; // --dryrun
+		bool IsOpt(tView name) const; // --dryrun
 
 		size_t SizeAllVar() const ; // return size of required mVar + optional mVarExt
 
-	public: // aliases ; I hope it will be fully optimized out/elided (TODO if not then copy/paste code of above methods)
+	public: // aliases, inlined
 	// public? compiler bug? would prefer to have it as private, but lambdas made in cCmdProcessing should access this fields
-		string v(int nr, const string &def="",  bool doThrow=0) const { return VarDef(nr,def,doThrow); }
-		vector<string> o(const string& name) const  { return OptIf(name); }
-		string o1(const string& name, const string &def="") const { return Opt1If(name,def); }
+		tView v(int nr, tView def="",  bool doThrow=0) const { return VarDef(nr,def,doThrow); }
+		vector<string> o(tView name) const  { return OptIf(name); }
+		tView o1(tView name, tView def="") const { return Opt1If(name,def); }
 
-		string V(int nr) const { return Var(nr); }
-		vector<string> O(const string& name) const { return Opt(name); }
-		string O1(const string& name) const { return Opt1(name); }
+		tView V(int nr) const { return Var(nr); }
+		vector<string> O(tView name) const { return Opt(name); }
+		tView O1(tView name) const { return Opt1(name); }
 
-		bool has(const string &name) const { return IsOpt(name); }
+		bool has(tView name) const { return IsOpt(name); }
 
 //		virtual const cCmdProcessing* MetaGetProcessing() const; // return optional pointer to the processing information
 //		virtual cCmdProcessing MetaGetProcessing() const; // return optional pointer to the processing information
-	const tVar & getmVar() const{return this->mVar;}
-	const tOption & getmOption() const{return this->mOption;}
-	const tVar & getmVarExt() const{return this->mVarExt;}
+	// copies, for tests and debug:
+	tVar getmVar() const;
+	tOption getmOption() const;
+	tVar getmVarExt() const;
 
 	protected:
-		void AssertLegalOptName(const string & name) const; // used internally to catch programming errors e.g. in binding lambdas
+		void AssertLegalOptName(tView name) const; // used internally to catch programming errors e.g. in binding lambdas
 };
 
 // ============================================================================
@@ -404,6 +430,8 @@ class cValidateError {
 
 /**
 Info about Parameter: How to validate and how to complete this argument
+Plain functions (not std::function) and a literal name, so this is trivially copyable - it is copied into every
+cCmdFormat that uses this kind of argument, and looked up on each validation/completion.
 */
 class cParamInfo {  MAKE_CLASS_NAME("cParamInfo");
 	public:
@@ -413,15 +441,16 @@ class cParamInfo {  MAKE_CLASS_NAME("cParamInfo");
 		// use: this function should validate the curr_word_ix out of data - data.ArgDef
 		// warning: the curr_word_ix might NOT exist
 		// ot msg sendfrom alice %%% hel<--validate --prio 4   ( use , data["alice", "%%%", "hel"  ], 2 )
-		typedef function< bool ( nUse::cUseOT &, cCmdData &, size_t ) > tFuncValid;
+		typedef bool (*tFuncValid)( nUse::cUseOT &, cCmdData &, size_t );
 
 		// vector<string>   hint_function ( otuse, partial_data, curr_word_ix )
 		// warning: the curr_word_ix might NOT exist
 		// ot msg sendfrom alice bo<TAB> hello --prio 4   ( use , data["alice", "bo", "hello"  ], 1 )
 		// ot msg sendfrom alice bob hel<TAB> --prio 4   ( use , data["alice", "bob", "hel"  ], 2 )
-		typedef function< vector<string> ( nUse::cUseOT &, cCmdData &, size_t ) > tFuncHint;
+		// parser: the one doing the completion (e.g. to list command names, or to enable filename completion)
+		typedef vector<string> (*tFuncHint)( nUse::cUseOT &, cCmdData &, size_t, cCmdParser & );
 
-		typedef function< string () > tFuncDescr;
+		typedef string (*tFuncDescr)();
 
 		enum eFlags {
 				takesValue = 1 << 0,// if used as option, then: YES it take a value, or NO is it an boolean option like --dry-run
@@ -439,24 +468,24 @@ class cParamInfo {  MAKE_CLASS_NAME("cParamInfo");
 		}; // now you can access the data both ways
 
 	protected:
-		string mName; // short name
+		const char * mName = ""; // short name (a literal)
 //		string mDescr; // medium description
 
-		tFuncDescr funcDescr;
-		tFuncValid funcValid;
-		tFuncHint funcHint;
+		tFuncDescr funcDescr = nullptr;
+		tFuncValid funcValid = nullptr;
+		tFuncHint funcHint = nullptr;
 
 		tFlags mFlags;
 	public:
 		cParamInfo()=default;
-		cParamInfo(const string &name, tFuncDescr descr, tFuncValid valid, tFuncHint hint, tFlags mFlags = tFlags());
-		cParamInfo(const string &name, tFuncDescr descr); // to be used for renaming
+		cParamInfo(const char *name, tFuncDescr descr, tFuncValid valid, tFuncHint hint, tFlags mFlags = tFlags());
+		cParamInfo(const char *name, tFuncDescr descr); // to be used for renaming
 
 		bool IsValid() const;
 
 		operator string() const NOEXCEPT { return mName; }
 		std::string getName() const NOEXCEPT { return mName; }
-		std::string getName2() const NOEXCEPT { return mName+"("+funcDescr()+")"; }
+		std::string getName2() const NOEXCEPT { return string(mName)+"("+funcDescr()+")"; }
 		std::string getDescr() const NOEXCEPT { return funcDescr(); }
 		bool getTakesValue() const NOEXCEPT { return mFlags.n.takesValue; }
 		tFlags getFlags() const NOEXCEPT { return mFlags; }
@@ -465,6 +494,15 @@ class cParamInfo {  MAKE_CLASS_NAME("cParamInfo");
 
 		tFuncValid GetFuncValid() const { return funcValid; }
 		tFuncHint GetFuncHint() const { return funcHint; }
+
+		bool Valid(nUse::cUseOT & use, cCmdData & data, size_t curr_word_ix) const {
+			if (!funcValid) throw cErrInternalParse(string("Param ") + mName + " has no validation function");
+			return funcValid(use, data, curr_word_ix);
+		}
+		vector<string> Hint(nUse::cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & parser) const {
+			if (!funcHint) return vector<string>(); // nothing to propose
+			return funcHint(use, data, curr_word_ix, parser);
+		}
 };
 
 
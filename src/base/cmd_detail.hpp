@@ -2,6 +2,7 @@
 /* See header file .hpp for info */
 
 #include "cmd.hpp"
+#include "cmd_grammar.hpp"
 
 #include "lib_common2.hpp"
 #include "ccolor.hpp"
@@ -28,7 +29,11 @@ class cCmdParser_pimpl {
 		map<string, vector<string> > mCache_CmdNamesVect2; // word2 vectors
 		vector<string> mCache_CmdNamesVect1; // word1 vector
 
+		cCmdGrammar mGrammar; // the tree compiled for parsing and completion
+		vector< shared_ptr<cCmdFormat> > mGrammarFormat; // format of each mGrammar format index
+
 		void BuildCache_CmdNames();
+		void BuildGrammar();
 
 };
 
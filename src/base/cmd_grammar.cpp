@@ -0,0 +1,151 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "cmd_grammar.hpp"
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nNewcli {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+int cCmdGrammar::Step(int node, const string & word) const {
+	const auto & edges = mNode.at(node).mEdge;
+	auto found = std::lower_bound(edges.begin(), edges.end(), word,
+		[] (const std::pair<string, int> & edge, const string & w) { return edge.first < w; } );
+	if ((found == edges.end()) || (found->first != word)) return -1;
+	return found->second;
+}
+
+int cCmdGrammar::AddEdge(int node, const string & word) {
+	int next = Step(node, word);
+	if (next >= 0) return next;
+	next = mNode.size();
+	mNode.push_back(cNameNode());
+	auto & edges = mNode.at(node).mEdge; // (after push_back, that could move the nodes)
+	auto pos = std::lower_bound(edges.begin(), edges.end(), word,
+		[] (const std::pair<string, int> & edge, const string & w) { return edge.first < w; } );
+	edges.insert(pos, std::make_pair(word, next));
+	return next;
+}
+
+void cCmdGrammar::Compile(const vector<cFormatSpec> & formats) {
+	mFormat = formats;
+	mNode.assign(1, cNameNode());
+	for (size_t ix = 0; ix < mFormat.size(); ++ix) {
+		const string & name = mFormat.at(ix).mName;
+		const auto space_pos = name.find(' ');
+		int node = AddEdge(0, name.substr(0, space_pos));
+		if (space_pos != string::npos) node = AddEdge(node, name.substr(space_pos + 1));
+		if (mNode.at(node).mFormat >= 0) _warn("Command name given twice: " << name);
+		mNode.at(node).mFormat = ix;
+	}
+	_dbg1("Compiled grammar of " << mFormat.size() << " formats into " << mNode.size() << " name nodes");
+}
+
+int cCmdGrammar::FindFormat(const string & name) const {
+	if (mNode.empty()) return -1;
+	const auto space_pos = name.find(' ');
+	int node = Step(0, name.substr(0, space_pos));
+	if ((node >= 0) && (space_pos != string::npos)) node = Step(node, name.substr(space_pos + 1));
+	return (node >= 0) ? mNode.at(node).mFormat : -1;
+}
+
+cCmdGrammar::cRun cCmdGrammar::Run(const vector<string> & words, bool allowBadName) const {
+	cRun run;
+	const size_t count = words.size();
+	run.mWord.reserve(count);
+	if ((count == 0) || mNode.empty()) return run; // next is 1st word of command name
+
+	// command name: 2nd word is part of it if such command exists, or if the 1st word alone is not a command ("msg")
+	const int node1 = Step(0, words.at(0));
+	const int node2 = ((node1 >= 0) && (count > 1)) ? Step(node1, words.at(1)) : -1;
+	if ((node2 >= 0) && (mNode.at(node2).mFormat >= 0)) {
+		run.mNameWords = 2;
+		run.mFormat = mNode.at(node2).mFormat;
+	} else if ((node1 >= 0) && (mNode.at(node1).mFormat >= 0)) {
+		run.mNameWords = 1;
+		run.mFormat = mNode.at(node1).mFormat;
+	} else {
+		run.mNameWords = std::min<size_t>(2, count);
+	}
+	for (size_t i = 0; i < run.mNameWords; ++i) run.mWord.push_back( cWord{ tToken::cmdname, int(i + 1), false } );
+
+	if (run.mFormat < 0) {
+		run.mStatus = tStatus::bad_name;
+		if (count == 1) { run.mNext = tToken::cmdname; run.mNextSub = 2; } // "msg" -> "msg ls"
+		else run.mNext = tToken::none;
+		return run;
+	}
+	if (count == 1) { // "nym" could become "nym ls", or get options
+		run.mNext = tToken::cmdname;
+		run.mNextSub = 2;
+		run.mNextMayBeOption = true;
+	}
+
+	// arguments: required then extra ones, until an --option
+	const cFormatSpec & format = mFormat.at(run.mFormat);
+	const size_t var_all = format.mVar + format.mVarExt;
+	size_t var_nr = 0; // arguments taken so far
+	size_t i = run.mNameWords;
+	for ( ; (i < count) && (var_nr < var_all); ++i) {
+		const string & word = words.at(i);
+		if (nUtils::CheckIfBegins("--", word)) break;
+		const tToken token = (var_nr < format.mVar) ? tToken::variable : tToken::variable_ext;
+		++var_nr;
+		run.mWord.push_back( cWord{ token, int(var_nr), false } );
+		if (nUtils::CheckIfBegins("\"", word)) { // "quoted argument" - continues up to the word ending with the quote
+			bool closed = (word.size() > 1) && nUtils::CheckIfEnds("\"", word);
+			while (!closed) {
+				if (i + 1 >= count) {
+					run.mStatus = tStatus::syntax;
+					run.mErrorWord = run.mWord.size() - 1;
+					run.mError = "Missing closing quote in argument nr=" + ToStr(var_nr);
+					return run;
+				}
+				++i;
+				closed = nUtils::CheckIfEnds("\"", words.at(i));
+				run.mWord.push_back( cWord{ token, int(var_nr), true } );
+			}
+		}
+	}
+	if (count > 1) {
+		if (var_nr < format.mVar) { run.mNext = tToken::variable; run.mNextSub = var_nr + 1; }
+		else if (var_nr < var_all) { run.mNext = tToken::variable_ext; run.mNextSub = var_nr + 1; }
+		else run.mNext = tToken::option_name;
+	}
+
+	// options: --name or --name value (value is any following word that is not an --option)
+	std::map<string, int> seen; // occurrences of each option name
+	int pending = -1; // in mWord: the option name that can still get a value
+	const size_t options_start = i;
+	for ( ; i < count; ++i) {
+		const string & word = words.at(i);
+		if (nUtils::CheckIfBegins("--", word)) {
+			run.mWord.push_back( cWord{ tToken::option_name, seen[word]++, false } );
+			pending = run.mWord.size() - 1;
+		} else if (pending >= 0) {
+			run.mWord.push_back( cWord{ tToken::option_value, run.mWord.at(pending).mSub, false } );
+			pending = -1;
+		} else if ((i == options_start) && (run.mNameWords == 1) && allowBadName) { // "nym inf" being completed to "nym info"
+			run.mWord.push_back( cWord{ tToken::cmdname, 2, false } );
+		} else {
+			run.mStatus = tStatus::syntax;
+			run.mErrorWord = i;
+			run.mError = "Expected an --option here, but got a word=" + word + " at word nr=" + ToStr(i);
+			return run;
+		}
+		run.mNext = tToken::option_name;
+		run.mNextSub = 0;
+	}
+	if (pending >= 0) { // "--cc ~" expects the value
+		run.mNext = tToken::option_value;
+		run.mNextSub = run.mWord.at(pending).mSub;
+	}
+	return run;
+}
+
+} // namespace nNewcli
+} // namespace nOT
+
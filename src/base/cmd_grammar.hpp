@@ -0,0 +1,91 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+The command tree compiled into tables: one pass over the words of a command line classifies every word
+(command name, variable, option name/value), selects the format, and tells what kind of word can come next
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_cmd_grammar
+#define INCLUDE_OT_NEWCLI_cmd_grammar
+
+#include "lib_common1.hpp"
+
+namespace nOT {
+namespace nNewcli {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+/**
+Automaton built once from all formats (cCmdParser::Init). Command names are a trie of words (sorted edges),
+the arguments of each format are a row of counts; the options part needs no table (any --word is a name,
+a following plain word is its value).
+Run() is one pass over the words; parsing and completion both use it.
+*/
+class cCmdGrammar {
+	public:
+		enum class tToken : unsigned char {
+			cmdname, // mSub: 1 or 2 - which word of command name
+			variable, // mSub: number of argument (from 1)
+			variable_ext, // same, for the extra (optional) arguments
+			option_name, // mSub: occurrence of this option name (from 0), e.g. 1 for second --cc
+			option_value, // mSub: same as for its option name
+			none // nothing can be here (after an unknown command name)
+		};
+
+		enum class tStatus : unsigned char {
+			ok,
+			bad_name, // command name is not known; only the name words are classified
+			syntax // e.g. a plain word where only --option can be; mErrorWord and mError tell more
+		};
+
+		struct cFormatSpec { // what the grammar needs to know about one format
+			string mName; // "msg send" or "help"
+			size_t mVar, mVarExt; // count of required and of extra arguments
+		};
+
+		struct cWord {
+			tToken mToken;
+			int mSub;
+			bool mJoin; // continues the "quoted argument" of previous word
+		};
+
+		struct cRun {
+			vector<cWord> mWord; // one for each given word that was reached
+			int mFormat = -1; // index of the selected format, or -1
+			size_t mNameWords = 0; // how many words are the command name (also for unknown name)
+			tStatus mStatus = tStatus::ok;
+			size_t mErrorWord = 0;
+			string mError;
+
+			// what a next (new) word after the given ones would be - for completion:
+			tToken mNext = tToken::cmdname;
+			int mNextSub = 0; // as in cWord; 0 for cmdname means there are no words yet
+			bool mNextMayBeOption = false; // it could also be an --option (e.g. after 1-word command "nym" that has also "nym ls")
+		};
+
+		void Compile(const vector<cFormatSpec> & formats);
+
+		/// Classifies words (without the pre word "ot"). allowBadName tolerates a 2nd command name word where
+		/// a 1-word command (with no arguments) expects options - e.g. "nym inf" while completing "nym info"
+		cRun Run(const vector<string> & words, bool allowBadName) const;
+
+		const cFormatSpec & Format(int ix) const { return mFormat.at(ix); }
+		int FindFormat(const string & name) const; // -1 if none
+		size_t Size() const { return mFormat.size(); }
+
+	private:
+		struct cNameNode {
+			vector< std::pair<string, int> > mEdge; // next word -> node, sorted by the word
+			int mFormat = -1; // format when the name ends here
+		};
+		vector<cNameNode> mNode; // [0] is the root, then word1 nodes, then word2 nodes
+		vector<cFormatSpec> mFormat;
+
+		int Step(int node, const string & word) const; // -1 if there is no such edge
+		int AddEdge(int node, const string & word);
+};
+
+} // namespace nNewcli
+} // namespace nOT
+
+#endif
+
@@ -63,7 +63,7 @@ void cCmdParser::Init() {
 			_dbg3("Nym validation");
 			return use.CheckIfExists(nUtils::eSubjectType::User, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Nym hinting");
 			return use.NymGetAllNames();
 		}
@@ -74,7 +74,7 @@ void cCmdParser::Init() {
 			_dbg3("Nym validation");
 				return use.CheckIfExists(nUtils::eSubjectType::User, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Nym hinting");
 			return use.NymGetAllNames();
 		}
@@ -85,14 +85,14 @@ void cCmdParser::Init() {
 			_dbg3("Nym to validation " << curr_word_ix);
 
 			// if curr_word_ix is 0 then this is the first param, so we will validate using default nym
-			auto nymFrom = (curr_word_ix == 0)? use.NymGetName(use.NymGetDefault()) : data.Var(curr_word_ix);
+			auto nymFrom = (curr_word_ix == 0)? use.NymGetName(use.NymGetDefault()) : data.Var(curr_word_ix).str();
 
 			if(use.CheckIfExists(nUtils::eSubjectType::User, data.Var(curr_word_ix + 1))) return true;
 			return AddressBookStorage::Get(use.NymGetId(nymFrom))->nymNameExist(data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Nym hinting " << curr_word_ix);
-			auto nymFrom = (curr_word_ix == 1)? use.NymGetName(use.NymGetDefault()) : data.Var(curr_word_ix-1);
+			auto nymFrom = (curr_word_ix == 1)? use.NymGetName(use.NymGetDefault()) : data.Var(curr_word_ix-1).str();
 			_dbg3("Nym from: " << nymFrom);
 			using namespace nOT::nUtils::nOper;
 			auto nyms = use.NymGetAllNames() + AddressBookStorage::GetAllNames(use.NymGetAllIDs()) - nymFrom;
@@ -105,7 +105,7 @@ void cCmdParser::Init() {
 			_dbg3("id validation");
 			return true;
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("id hinting");
 			return vector<string> {"otx"};
 		}
@@ -116,13 +116,13 @@ void cCmdParser::Init() {
 			_dbg3("Nym to validation " << curr_word_ix);
 			// ot command acc [nym]
 			//
-			auto acc = (curr_word_ix == 0)? use.AccountGetDefault() : data.Var(curr_word_ix);
+			auto acc = (curr_word_ix == 0)? use.AccountGetDefault() : data.Var(curr_word_ix).str();
 			auto nym = data.Var(curr_word_ix+1);
 			_dbg2("nym: " << nym << ", account: " << acc);
 			return use.AccountIsOwnerNym(acc, nym);
 
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Nym hinting");
 			_dbg2(use.AccountGetNym(data.Var(curr_word_ix-1)));
 			return vector<string>{use.AccountGetNym(data.Var(curr_word_ix-1))};
@@ -136,7 +136,7 @@ void cCmdParser::Init() {
 			_dbg3("Nym name validation");
 			return !use.NymNameExist(data.Var(curr_word_ix+1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Nym name hinting");
 			return vector<string> {}; // No hinting for new Nym name
 		}
@@ -148,7 +148,7 @@ void cCmdParser::Init() {
 			_dbg3("Account validation");
 				return use.CheckIfExists(nUtils::eSubjectType::Account, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Account hinting");
 			return use.AccountGetAllNames();
 		}
@@ -160,7 +160,7 @@ void cCmdParser::Init() {
 			auto accounts = use.AccountGetAllIds();
 			return std::find(accounts.begin(), accounts.end(), data.Var(curr_word_ix + 1))!=accounts.end();
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Account hinting");
 			return use.AccountGetAllIds();
 		}
@@ -171,7 +171,7 @@ void cCmdParser::Init() {
 			_dbg3("Account validation");
 			return use.CheckIfExists(nUtils::eSubjectType::Account, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Account hinting");
 			return use.AccountGetAllNames();
 		}
@@ -179,12 +179,12 @@ void cCmdParser::Init() {
 	cParamInfo pAccountTo("account-to", [] () -> string { return Tr(eDictType::help, "account-to") },
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			_dbg3("Account validation: " <<  data.Var(curr_word_ix+1));
-			auto accFrom = (curr_word_ix == 0)? use.AccountGetName(use.AccountGetDefault()) : data.Var(curr_word_ix);
+			auto accFrom = (curr_word_ix == 0)? use.AccountGetName(use.AccountGetDefault()) : data.Var(curr_word_ix).str();
 
 			return use.CheckIfExists(nUtils::eSubjectType::Account, data.Var(curr_word_ix + 1), accFrom);
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
-			auto accFrom = (curr_word_ix == 1)? use.AccountGetName(use.AccountGetDefault()) : data.Var(curr_word_ix-1);
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
+			auto accFrom = (curr_word_ix == 1)? use.AccountGetName(use.AccountGetDefault()) : data.Var(curr_word_ix-1).str();
 			using namespace nOT::nUtils::nOper;
 			_dbg3("Account hinting");
 			_dbg2("Account from " << accFrom);
@@ -199,7 +199,7 @@ void cCmdParser::Init() {
 			_dbg3("Account name validation");
 				return true; // Takes all input TODO check if Account with this name exists
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Account name hinting");
 			return vector<string> {}; // No hinting for new Nym name
 		}
@@ -211,7 +211,7 @@ void cCmdParser::Init() {
 			_dbg3("Asset validation");
 			return use.CheckIfExists(nUtils::eSubjectType::Asset, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Asset hinting");
 			return use.AssetGetAllNames();
 		}
@@ -223,7 +223,7 @@ void cCmdParser::Init() {
 //				return true;
 //
 //			} ,
-//			[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+//			[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 //
 //			}
 //		);
@@ -233,7 +233,7 @@ void cCmdParser::Init() {
 			_dbg3("Server validation");
 				return use.CheckIfExists(nUtils::eSubjectType::Server, data.Var(curr_word_ix + 1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			_dbg3("Server hinting");
 			return use.ServerGetAllNames();
 		}
@@ -243,7 +243,7 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return nUtils::isNumber(data.Var(curr_word_ix+1));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> { "-1", "0", "1", "2", "100" };
 		}
 	);
@@ -252,16 +252,25 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return nUtils::isNumber(data.Var(curr_word_ix+1), true);
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {"1", "10", "100" };
 		}
 	);
 
+	cParamInfo pSummaryBy( "summary-by", [] () -> string { return Tr(eDictType::help, "summary-by") },
+		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
+			return true; // unknown grouping is reported by AccountSummary
+		} ,
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
+			return vector<string> { "asset", "nym", "server", "nym,server" };
+		}
+	);
+
 	cParamInfo pSubject( "subject", [] () -> string { return Tr(eDictType::help, "subject") },
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return true;
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> { "hello","hi","test","subject" };
 		}
 	);
@@ -270,7 +279,7 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return true; // option's value should be null
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {}; // this should be empty option, let's continue
 		}
 		, 0
@@ -285,7 +294,7 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return true;
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {}; // this should be empty option, let's continue
 		}
 	);
@@ -294,9 +303,8 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return true;
 		} ,
-		[this_weak] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
-			shared_ptr<cCmdParser> this_lock( this_weak );
-			return this_lock->GetCmdNamesWord1();
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & parser ) -> vector<string> {
+			return parser.GetCmdNamesWord1();
 		}
 	);
 
@@ -304,10 +312,9 @@ void cCmdParser::Init() {
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			return true;
 		} ,
-		[this_weak] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
-			shared_ptr<cCmdParser> this_lock( this_weak );
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & parser ) -> vector<string> {
 			try {
-				return this_lock->GetCmdNamesWord2( data.V(1) );
+				return parser.GetCmdNamesWord2( data.V(1) );
 			} catch(const cErrParseName &e) { return vector<string>{}; }
 		}
 	);
@@ -328,7 +335,7 @@ void cCmdParser::Init() {
 			}
 			return false;
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {}; //TODO hinting function for msg index
 		}
 	);
@@ -345,7 +352,7 @@ void cCmdParser::Init() {
 			}
 			return false;
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 
 			return vector<string> {}; //TODO hinting function for msg index
 		}
@@ -356,7 +363,7 @@ void cCmdParser::Init() {
 			const int nr = curr_word_ix+1;
 			return nUtils::isNumber(data.Var(nr)); // TODO
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {}; //TODO hinting function for msg index
 		}
 	);
@@ -367,7 +374,7 @@ void cCmdParser::Init() {
 			if(!nUtils::isNumber(data.Var(nr))) return false;
 			return use.OutpaymentCheckIndex(data.Var(nr-1), std::stoi( data.Var(nr)));
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			auto count = use.OutpaymantGetCount(data.Var(curr_word_ix-1));
 			if(count == -1) return vector<string> {};
 			return vector<string> {"0", ToStr(count-1)};
@@ -380,21 +387,21 @@ void cCmdParser::Init() {
 			if(!nUtils::isNumber(data.Var(nr))) return false;
 			return true; //TODO
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return vector<string> {}; //TODO
 		}
 	);
 
 	cParamInfo pReadFile( "from-file", [] () -> string { return Tr(eDictType::help, "from-file") },
-		[&] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
+		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			const int nr = curr_word_ix+1;
 			auto filename = nUtils::cFilesystemUtils::TildeToHome(data.Var(nr));
 			auto exist = opentxs::OTPaths::PathExists(filename);
 			_dbg2("file: " << filename << " exist: " << exist);
 			return exist;
 		} ,
-		[this] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
-			mEnableFilenameCompletion = true; // Enable filename autocompletion
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & parser ) -> vector<string> {
+			parser.mEnableFilenameCompletion = true; // Enable filename autocompletion
 			return vector<string> {};
 		}
 	);
@@ -407,18 +414,22 @@ void cCmdParser::Init() {
 			_dbg2("file: " << filename << " exist: " << fileExist);
 			return !fileExist; // if this file exist, return false
 		} ,
-		[this] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
-			mEnableFilenameCompletion = true; // Enable filename autocompletion
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & parser ) -> vector<string> {
+			parser.mEnableFilenameCompletion = true; // Enable filename autocompletion
 			return vector<string> {};
 		}
 	);
 
+	cParamInfo pOutFile( "to-file", [] () -> string { return Tr(eDictType::help, "to-file") }, // an existing file is refused by the command itself (unless --overwrite)
+		pText.funcValid , pWriteFile.funcHint
+	);
+
 	cParamInfo pLang( "lang", [] () -> string { return Tr(eDictType::help, "lang") },
 		[] (cUseOT & use, cCmdData & data, size_t curr_word_ix ) -> bool {
 			const int nr = curr_word_ix+1;
 			return true; //TODO
 		} ,
-		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix  ) -> vector<string> {
+		[] ( cUseOT & use, cCmdData & data, size_t curr_word_ix, cCmdParser & ) -> vector<string> {
 			return gTranslations->GetLanguages(true);
 		}
 	);
@@ -535,6 +546,9 @@ void cCmdParser::Init() {
 	AddFormat("account show", {}, {pAccount}, NullMap,
 		LAMBDA { auto &D=*d; return U.AccountDisplay( D.v(1, U.AccountGetName(U.AccountGetDefault()) ), D.has("--dryrun") ); } );
 
+	AddFormat("account summary", {}, {}, { {"--by", pSummaryBy}, {"--jsonl", pBool} },
+		LAMBDA { auto &D=*d; return U.AccountSummary( D.o1("--by", "asset"), D.has("--jsonl"), D.has("--dryrun") ); } );
+
 	AddFormat("account rename", {pAccount, pAccountNewName}, {}, NullMap,
 		LAMBDA { auto &D=*d; return U.AccountRename(D.V(1), D.V(2), D.has("--dryrun") ); } );
 
@@ -649,6 +663,9 @@ void cCmdParser::Init() {
 	AddFormat("cheque new", {pAccountFrom, pNymFrom, pNymTo, pAmount}, {pServer}, { {"--memo",pText} },
 		LAMBDA { auto &D=*d; return U.ChequeCreate(D.V(1), D.V(2), D.V(3), stoi(D.V(4)), D.v(5, U.ServerGetName(U.ServerGetDefault())),  D.o1("--memo", ""), D.has("--dryrun") ); } );
 
+	AddFormat("cheque new-batch", {pAccountFrom, pNymFrom, pReadFile}, {pServer}, { {"--manifest",pOutFile}, {"--overwrite",pBool} },
+		LAMBDA { auto &D=*d; return U.ChequeCreateBatch(D.V(1), D.V(2), D.V(3), D.v(4, U.ServerGetName(U.ServerGetDefault())), D.o1("--manifest", D.V(3) + ".manifest.csv"), D.has("--overwrite"), D.has("--dryrun") ); } );
+
 	AddFormat("cheque discard", {pAccount, pNym}, {pOutpaymentIndex}, {},
 		LAMBDA { auto &D=*d; return U.ChequeDiscard(D.V(1), D.V(2), stoi(D.v(3, "-1")), D.has("--dryrun") ); } );
 
@@ -672,16 +689,26 @@ void cCmdParser::Init() {
 	AddFormat( "msg-out show", {}, {pNym, pMsgOutIndex}, NullMap,
 		LAMBDA { auto &D=*d; return U.MsgDisplayForNymOutbox( D.v(1, U.NymGetName(U.NymGetDefault())) , stoi(D.v(2,"0")) ,  D.has("--dryrun") ); } );
 
+	//======== ot contract ========
+
+	AddFormat("contract sign", {pNymMy}, {pReadFile, pWriteFile}, { {"--dir", pText}, {"--glob", pText}, {"--out-dir", pText} },
+		LAMBDA { auto &D=*d;
+			if (D.has("--dir")) return U.ContractSignBatch( D.V(1), D.o1("--dir"), D.o1("--glob", "*"), D.o1("--out-dir", ""), D.has("--dryrun") );
+			return U.ContractSign( D.V(1), D.V(2), D.v(3, ""), D.has("--dryrun") ); } );
+
+	AddFormat("contract verify", {pNym}, {pReadFile}, { {"--dir", pText}, {"--glob", pText} },
+		LAMBDA { auto &D=*d; return U.ContractVerify( D.V(1), D.v(2, ""), D.o1("--dir", ""), D.o1("--glob", "*"), D.has("--dryrun") ); } );
+
 	//======== ot msg ========
 
 	AddFormat("msg ls", {}, {pNym}, NullMap,
 		LAMBDA { auto &D=*d; return U.MsgDisplayForNym( D.v(1, U.NymGetName(U.NymGetDefault())), D.has("--dryrun") ); } );
 
 	AddFormat("msg send-from", {pFrom, pTo}, {pSubj, pMsg}, { {"--cc",pNym} , {"--bcc",pNym} , {"--prio",pInt}, {"--file",pReadFile} },
-		LAMBDA { auto &D=*d; return U.MsgSend(D.V(1), D.V(2) + D.o("--cc") , D.v(3,"nosubject"), D.v(4), stoi(D.o1("--prio","0")), D.o1("--file",""), D.has("--dryrun")); }	);
+		LAMBDA { auto &D=*d; return U.MsgSend(D.V(1), D.V(2).str() + D.o("--cc") , D.v(3,"nosubject"), D.v(4), stoi(D.o1("--prio","0")), D.o1("--file",""), D.has("--dryrun")); }	);
 
 	AddFormat("msg send-to", {pTo}, {pSubj, pMsg}, { {"--cc",pNym} , {"--bcc",pNym} , {"--prio",pInt}, {"--file",pReadFile} },
-		LAMBDA { auto &D=*d; return U.MsgSend(U.NymGetName(U.NymGetDefault()), D.V(1) + D.o("--cc"), D.v(2,"nosubject"), D.v(3), stoi(D.o1("--prio","0")), D.o1("--file",""), D.has("--dryrun")); }	);
+		LAMBDA { auto &D=*d; return U.MsgSend(U.NymGetName(U.NymGetDefault()), D.V(1).str() + D.o("--cc"), D.v(2,"nosubject"), D.v(3), stoi(D.o1("--prio","0")), D.o1("--file",""), D.has("--dryrun")); }	);
 
 	AddFormat("msg rm", {pNym, pOnceInt}, {}, NullMap /*{"--all", pBool}*/ , // FIXME proper handle option without parameter!
 		LAMBDA { auto &D=*d; return U.MsgInRemoveByIndex(D.V(1), stoi(D.V(2)), D.has("--dryrun"));} );
@@ -715,8 +742,11 @@ void cCmdParser::Init() {
 	AddFormat("nym remove", {pNym}, {}, { {"--force", pBool} },
 		LAMBDA { auto &D=*d; return U.NymRemove( D.V(1), D.has("--force"), D.has("--dryrun") ); } );
 
-	AddFormat("nym new", {pNymNewName}, {}, { {"--register", pBool} },
-		LAMBDA { auto &D=*d; return U.NymCreate( D.V(1), D.has("--register"), D.has("--dryrun") ); } );
+	AddFormat("nym new", {}, {pNymNewName}, { {"--register", pBool}, {"--count", pInt}, {"--name-pattern", pText} },
+		LAMBDA { auto &D=*d;
+			if (D.has("--count")) return U.NymCreateBulk( D.o1("--name-pattern", D.v(1, "nym-{n}")), stoi(D.o1("--count")), D.has("--register"), D.has("--dryrun") );
+			if (D.v(1, "").empty()) return nUtils::reportError("", "missing nym name", "Missing nym name: give one, or use --count");
+			return U.NymCreate( D.V(1), D.has("--register"), D.has("--dryrun") ); } );
 
 	AddFormat("nym set-default", {pNym}, {}, NullMap,
 		LAMBDA { auto &D=*d; return U.NymSetDefault( D.V(1), D.has("--dryrun") ); } );
@@ -797,8 +827,11 @@ void cCmdParser::Init() {
 	AddFormat("server new", {}, {pNymMy, pReadFile}, NullMap,
 		LAMBDA { auto &D=*d; return U.ServerCreate(D.v(1, U.NymGetName( U.NymGetDefault())), D.v(2, ""), D.has("--dryrun") ); } );
 
-	AddFormat("server ping", {}, {pServer, pNym}, NullMap,
-		LAMBDA { auto &D=*d; return U.ServerPing(D.v(1, U.ServerGetName( U.ServerGetDefault())), D.v(2, U.NymGetName( U.NymGetDefault())), D.has("--dryrun") ); } );
+	AddFormat("server ping", {}, {pServer, pNym}, { {"--all", pBool}, {"--count", pInt}, {"--timeout", pInt}, {"--interval", pInt} },
+		LAMBDA { auto &D=*d;
+			if (D.has("--all") || D.has("--count") || D.has("--timeout") || D.has("--interval"))
+				return U.ServerPingMany(D.v(1, ""), D.v(2, ""), D.has("--all"), stoi(D.o1("--count", "1")), stoi(D.o1("--timeout", "5000")), stoi(D.o1("--interval", "0")), D.has("--dryrun") );
+			return U.ServerPing(D.v(1, U.ServerGetName( U.ServerGetDefault())), D.v(2, U.NymGetName( U.NymGetDefault())), D.has("--dryrun") ); } );
 
 	AddFormat("server rm", {pServer}, {}, NullMap,
 		LAMBDA { auto &D=*d; return U.ServerRemove(D.V(1), D.has("--dryrun") ); } );
@@ -838,6 +871,9 @@ void cCmdParser::Init() {
 	AddFormat("voucher new", {pAccountFrom, pNymAcc, pNymTo, pAmount}, {}, { {"--memo",pText} },
 		LAMBDA { auto &D=*d; return U.VoucherWithdraw(D.V(1), D.V(2), D.V(3), stoi(D.V(4)), D.o1("--memo", ""), D.has("--dryrun") ); } );
 
+	AddFormat("voucher new-batch", {pAccountFrom, pNymAcc, pReadFile}, {}, { {"--manifest",pOutFile}, {"--overwrite",pBool} },
+		LAMBDA { auto &D=*d; return U.VoucherWithdrawBatch(D.V(1), D.V(2), D.V(3), D.o1("--manifest", D.V(3) + ".manifest.csv"), D.has("--overwrite"), D.has("--dryrun") ); } );
+
 	AddFormat("voucher new-for", {pNymTo, pAmount}, {}, { {"--memo",pText} },
 		LAMBDA {auto &D=*d; return U.VoucherWithdraw(U.AccountGetName(U.AccountGetDefault()), U.NymGetName(U.NymGetDefault()), D.V(1), stoi(D.V(2)), D.o1("--memo", ""), D.has("--dryrun") );});
 
@@ -845,6 +881,7 @@ void cCmdParser::Init() {
 		LAMBDA { auto &D=*d; return U.VoucherCancel(D.V(1), D.V(2), stoi(D.v(3, "-1")), D.has("--dryrun") ); } );
 
 	mI->BuildCache_CmdNames();
+	mI->BuildGrammar();
 }
 
 
@@ -0,0 +1,163 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "compact_id.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+// ====================================================================
+
+cInternTable::cInternTable() : mSize(0) {
+	for (auto & chunk : mChunks) chunk.store(nullptr, std::memory_order_relaxed);
+	Intern(""); // index 0
+}
+
+cInternTable::~cInternTable() {
+	for (auto & chunk : mChunks) delete[] chunk.load(std::memory_order_relaxed);
+}
+
+uint32_t cInternTable::Intern(const string & text) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto found = mIndex.find(text);
+	if (found != mIndex.end()) return found->second;
+
+	const size_t index = mSize.load(std::memory_order_relaxed);
+	if (index >= mChunkSize * mMaxChunks) throw std::length_error("Intern table is full");
+	auto added = mIndex.insert( std::make_pair(text, static_cast<uint32_t>(index)) ).first;
+	const string ** chunk = mChunks[index >> mChunkBits].load(std::memory_order_relaxed);
+	if (!chunk) {
+		chunk = new const string * [mChunkSize];
+		mChunks[index >> mChunkBits].store(chunk, std::memory_order_release);
+	}
+	chunk[index & (mChunkSize - 1)] = & added->first;
+	mSize.store(index + 1, std::memory_order_release); // handle is given out after its entry is written
+	return static_cast<uint32_t>(index);
+}
+
+bool cInternTable::Lookup(const string & text, uint32_t & index) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto found = mIndex.find(text);
+	if (found == mIndex.end()) return false;
+	index = found->second;
+	return true;
+}
+
+const string & cInternTable::Get(uint32_t index) const {
+	return * mChunks[index >> mChunkBits].load(std::memory_order_acquire)[index & (mChunkSize - 1)];
+}
+
+size_t cInternTable::Size() const {
+	return mSize.load(std::memory_order_acquire);
+}
+
+// ====================================================================
+
+void cIdNameMap::Set(const string & id, const string & name) {
+	const cCompactId compactId = cCompactId::Intern(id);
+	const cCompactName compactName = cCompactName::Intern(name);
+	auto found = mNames.find(compactId);
+	if (found != mNames.end()) {
+		if (found->second == compactName) return;
+		EraseIndex(found->second, compactId);
+		found->second = compactName;
+	}
+	else mNames.insert( std::make_pair(compactId, compactName) );
+	mIds.insert( std::make_pair(compactName, compactId) );
+}
+
+bool cIdNameMap::Erase(const string & id) {
+	cCompactId compactId;
+	if (!cCompactId::Lookup(id, compactId)) return false;
+	auto found = mNames.find(compactId);
+	if (found == mNames.end()) return false;
+	EraseIndex(found->second, compactId);
+	mNames.erase(found);
+	return true;
+}
+
+void cIdNameMap::EraseIndex(cCompactName name, cCompactId id) {
+	auto range = mIds.equal_range(name);
+	for (auto it = range.first; it != range.second; ++it) {
+		if (it->second == id) { mIds.erase(it); return; }
+	}
+}
+
+void cIdNameMap::Clear() {
+	mNames.clear();
+	mIds.clear();
+}
+
+bool cIdNameMap::Has(const string & id) const {
+	return FindName(id) != nullptr;
+}
+
+size_t cIdNameMap::Size() const {
+	return mNames.size();
+}
+
+bool cIdNameMap::Empty() const {
+	return mNames.empty();
+}
+
+const string * cIdNameMap::FindName(const string & id) const {
+	cCompactId compactId;
+	if (!cCompactId::Lookup(id, compactId)) return nullptr;
+	auto found = mNames.find(compactId);
+	return (found == mNames.end()) ? nullptr : & found->second.Str();
+}
+
+const string & cIdNameMap::NameOf(const string & id) const {
+	const string * name = FindName(id);
+	if (!name) throw std::out_of_range("No name for ID " + id);
+	return *name;
+}
+
+string cIdNameMap::IdOf(const string & name) const {
+	cCompactName compactName;
+	if (!cCompactName::Lookup(name, compactName)) return "";
+	auto range = mIds.equal_range(compactName);
+	if (range.first == range.second) return "";
+	const string * first = & range.first->second.Str(); // same name is rare, but the answer must not depend on hashing
+	for (auto it = std::next(range.first); it != range.second; ++it) {
+		if (it->second.Str() < *first) first = & it->second.Str();
+	}
+	return *first;
+}
+
+vector<string> cIdNameMap::GetIds() const {
+	vector<string> ids;
+	ids.reserve(mNames.size());
+	for (const auto & entry : mNames) ids.push_back(entry.first.Str());
+	std::sort(ids.begin(), ids.end());
+	return ids;
+}
+
+vector<string> cIdNameMap::GetNames() const {
+	vector<string> names;
+	names.reserve(mNames.size());
+	for (const auto & entry : mNames) names.push_back(entry.second.Str());
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+map<string, string> cIdNameMap::ToMap() const {
+	map<string, string> idToName;
+	for (const auto & entry : mNames) idToName.insert( std::make_pair(entry.first.Str(), entry.second.Str()) );
+	return idToName;
+}
+
+void cIdNameMap::FromMap(const map<string, string> & idToName) {
+	Clear();
+	mNames.reserve(idToName.size());
+	for (const auto & entry : idToName) Set(entry.first, entry.second);
+}
+
+} // namespace nUtils
+} // namespace nOT
+
@@ -0,0 +1,132 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Compact interned IDs and names: 4 byte handles to strings kept once per process
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_compact_id
+#define INCLUDE_OT_NEWCLI_compact_id
+
+#include "lib_common1.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+/**
+Append-only table of strings, each kept once; index 0 is "".
+Get() does not lock (entries never move), Intern() and Lookup() lock.
+*/
+class cInternTable {
+	public:
+		cInternTable();
+		~cInternTable();
+
+		uint32_t Intern(const string & text); ///< index of text, added if new
+		bool Lookup(const string & text, uint32_t & index) const; ///< index of text if it was interned (does not add)
+		const string & Get(uint32_t index) const;
+		size_t Size() const;
+
+	private:
+		cInternTable(const cInternTable &) = delete;
+		cInternTable & operator=(const cInternTable &) = delete;
+
+		static const size_t mChunkBits = 12;
+		static const size_t mChunkSize = size_t(1) << mChunkBits;
+		static const size_t mMaxChunks = 4096; ///< 16M strings per table
+
+		mutable std::mutex mMutex;
+		std::unordered_map<string, uint32_t> mIndex; ///< keys are the stored strings (node based - never move)
+		std::atomic<const string **> mChunks[mMaxChunks]; ///< index -> key in mIndex
+		std::atomic<size_t> mSize;
+};
+
+/**
+Handle of an interned string: 4 bytes, trivially copyable, compared and hashed as integer.
+Each tag has its own table (IDs and names do not mix). Converted back to string only at OTAPI / terminal.
+*/
+template <class tTag>
+class cInterned {
+	public:
+		cInterned() : mIndex(0) { } ///< ""
+
+		static cInterned Intern(const string & text) { return cInterned( Table().Intern(text) ); }
+		static bool Lookup(const string & text, cInterned & found) {
+			uint32_t index = 0;
+			if (!Table().Lookup(text, index)) return false;
+			found = cInterned(index);
+			return true;
+		}
+		static size_t GetTableSize() { return Table().Size(); }
+
+		const string & Str() const { return Table().Get(mIndex); }
+		uint32_t GetIndex() const { return mIndex; }
+		bool IsEmpty() const { return mIndex == 0; }
+
+		bool operator==(const cInterned & other) const { return mIndex == other.mIndex; }
+		bool operator!=(const cInterned & other) const { return mIndex != other.mIndex; }
+		bool operator<(const cInterned & other) const { return mIndex < other.mIndex; } ///< order of interning, not of text
+
+	private:
+		explicit cInterned(uint32_t index) : mIndex(index) { }
+		static cInternTable & Table() { static cInternTable table; return table; }
+
+		uint32_t mIndex;
+};
+
+struct cIdTag { };
+struct cNameTag { };
+typedef cInterned<cIdTag> cCompactId; ///< nym, account, asset, server ID
+typedef cInterned<cNameTag> cCompactName; ///< name (alias) of such object
+
+} // namespace nUtils
+} // namespace nOT
+
+namespace std {
+template <class tTag>
+struct hash< nOT::nUtils::cInterned<tTag> > {
+	size_t operator()(const nOT::nUtils::cInterned<tTag> & value) const { return value.GetIndex(); } // indexes are dense - no collisions
+};
+} // namespace std
+
+namespace nOT {
+namespace nUtils {
+
+/**
+ID -> name map (as cache of wallet nyms, or address book), with name -> ID index for finding by name without a scan.
+Holds only handles; strings are looked up in intern tables when asked for.
+*/
+class cIdNameMap {
+	public:
+		void Set(const string & id, const string & name); ///< adds, or renames
+		bool Erase(const string & id);
+		void Clear();
+
+		bool Has(const string & id) const;
+		size_t Size() const;
+		bool Empty() const;
+		const string & NameOf(const string & id) const; ///< throws std::out_of_range if missing (like map::at)
+		const string * FindName(const string & id) const; ///< nullptr if missing
+		string IdOf(const string & name) const; ///< ID with that name, or ""; if more have it, the first in ID order (as FindMapValue)
+
+		vector<string> GetIds() const; ///< sorted
+		vector<string> GetNames() const; ///< sorted
+		map<string, string> ToMap() const; ///< for display and saving (sorted by ID)
+		void FromMap(const map<string, string> & idToName);
+
+	private:
+		std::unordered_map<cCompactId, cCompactName> mNames;
+		std::unordered_multimap<cCompactName, cCompactId> mIds;
+
+		void EraseIndex(cCompactName name, cCompactId id);
+};
+
+} // namespace nUtils
+} // namespace nOT
+
+#endif
+
@@ -0,0 +1,55 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "completion_cache.hpp"
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cCompletionCache::cCompletionCache(size_t capacity)
+: mCapacity(capacity), mHits(0), mMisses(0)
+{ }
+
+bool cCompletionCache::IsRefinement(const string & previous, const string & line) {
+	if (line.size() < previous.size()) return false;
+	if (line.compare(0, previous.size(), previous) != 0) return false;
+	// new word (space) or escaped characters change what is completed - then compute it again
+	return line.find_first_of(" \\", previous.size()) == string::npos;
+}
+
+bool cCompletionCache::Narrow(const string & line, uint64_t generation, vector<string> & completions) {
+	auto best = mEntries.end();
+	for (auto it = mEntries.begin(); it != mEntries.end(); ++it) { // the longest matching line has the fewest candidates
+		if (it->mGeneration != generation || !IsRefinement(it->mLine, line)) continue;
+		if (best == mEntries.end() || it->mLine.size() > best->mLine.size()) best = it;
+	}
+	if (best == mEntries.end()) { ++mMisses; return false; }
+
+	const size_t word_start = line.rfind(' ') == string::npos ? 0 : line.rfind(' ') + 1;
+	const string word_sofar = line.substr(word_start);
+	if (word_sofar.find('\\') != string::npos) { ++mMisses; return false; }
+
+	completions.clear();
+	for (const auto & candidate : best->mCompletions)
+		if (nUtils::CheckIfBegins(word_sofar, candidate)) completions.push_back(candidate);
+	++mHits;
+	_dbg2("Completions for [" << line << "] narrowed from [" << best->mLine << "]: " << best->mCompletions.size() << " -> " << completions.size());
+	Remember(line, generation, completions); // next letter narrows from this smaller set
+	return true;
+}
+
+void cCompletionCache::Remember(const string & line, uint64_t generation, const vector<string> & completions) {
+	for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+		if (it->mLine == line) { mEntries.erase(it); break; }
+	}
+	mEntries.push_front( cEntry{ line, generation, completions } );
+	if (mEntries.size() > mCapacity) mEntries.pop_back();
+}
+
+} // namespace nOTHint
+} // namespace nOT
+
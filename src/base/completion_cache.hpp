@@ -0,0 +1,54 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Reusing completions of previous line in the completion daemon, when user just typed more letters of the same word
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_completion_cache
+#define INCLUDE_OT_NEWCLI_completion_cache
+
+#include "lib_common2.hpp"
+
+#include <deque>
+
+namespace nOT {
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Completions are always the candidates for the current (last) word that begin with what is typed so far.
+So when "ot msg send ali" extends a remembered "ot msg send al" with no new word (no space, no escapes),
+the answer is the remembered completions filtered by the longer word - without parsing and asking OTAPI again.
+Entries are valid only for the same wallet generation (@see cWalletWatcher), as hints come from the wallet.
+Keyed by line, not by client: the result does not depend on who asks, and many clients typing at once each find their line.
+*/
+class cCompletionCache { MAKE_CLASS_NAME("cCompletionCache");
+	public:
+		cCompletionCache(size_t capacity = 16);
+
+		/// true if completions for line could be derived from a remembered line (then they are in completions)
+		bool Narrow(const string & line, uint64_t generation, vector<string> & completions);
+		void Remember(const string & line, uint64_t generation, const vector<string> & completions);
+
+		size_t GetHits() const { return mHits; }
+		size_t GetMisses() const { return mMisses; }
+
+		static bool IsRefinement(const string & previous, const string & line); ///< line is previous + more letters of its last word
+
+	protected:
+		struct cEntry {
+			string mLine;
+			uint64_t mGeneration;
+			vector<string> mCompletions;
+		};
+
+		const size_t mCapacity;
+		std::deque<cEntry> mEntries; ///< newest at front
+		size_t mHits, mMisses;
+};
+
+} // namespace nOTHint
+} // namespace nOT
+
+#endif
+
@@ -27,6 +27,14 @@ string cDaemoninfoComplete::GetPathIn() const {
 	return "/tmp/ot.in";
 }
 
+string cDaemoninfoHost::GetDir() const {
+	return "/tmp/ot.host." + ToStr(getuid());
+}
+
+string cDaemoninfoHost::GetPathIn() const {
+	return GetDir() + "/in";
+}
+
 string cDaemoninfoComplete::GetPathOut() const {
 	if (!mOutCreated) throw std::runtime_error("Trying to read PatchOut before creating it");
 	return mOutFilename;
@@ -42,6 +50,11 @@ void cDaemoninfoComplete::CreateOut() {
 	mOutCreated = true;
 }
 
+void cDaemoninfoHost::CreateOut() {
+	mOutFilename = GetDir() + "/" + ToStr(getpid()) + "." + ToStr(rand()%10000) + ToStr(time(NULL)) + ".out";
+	mOutCreated = true;
+}
+
 bool cDaemoninfoComplete::IsReadyPatchOut() const {
 	string fname = GetPathOutFlag();
 	struct stat buf;
@@ -35,6 +35,14 @@ class cDaemoninfoComplete : public cDaemoninfo {
 		virtual void CreateOut();
 };
 
+/// wallet host (@see nUse::cWalletHost): request pipe and reply files in a private directory of the user
+class cDaemoninfoHost : public cDaemoninfoComplete {
+	public:
+		string GetDir() const ; ///< mode 0700, created by the host
+		virtual string GetPathIn() const ;
+		virtual void CreateOut(); ///< only names the reply file - worker creates it (and fails if it exists)
+};
+
 
 } // namespace nOT
 
@@ -0,0 +1,80 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "fan_out.hpp"
+
+#include "lib_common2.hpp"
+#include "ccolor.hpp"
+
+#include <thread>
+#include <atomic>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cFanOut::cFanOut(size_t inFlight, size_t retries, std::chrono::milliseconds backoff)
+: mInFlight(std::max<size_t>(inFlight, 1)), mRetries(retries), mBackoff(backoff)
+{ }
+
+cFanOut::cStatus cFanOut::SendOne(const string & target, tSender & send) const {
+	cStatus status{ target, eResult::failed, 0, 0 };
+	auto start = std::chrono::steady_clock::now();
+	auto delay = mBackoff;
+	while (true) {
+		++status.mAttempts;
+		try {
+			status.mResult = send(target);
+		} catch(const std::exception & e) {
+			_warn("Sending to " << target << " failed: " << e.what());
+			status.mResult = eResult::failed;
+		}
+		if ((status.mResult != eResult::transient) || (status.mAttempts > mRetries)) break;
+		_info("Transient failure sending to " << target << ", retry " << status.mAttempts << " of " << mRetries << " in " << delay.count() << "ms");
+		std::this_thread::sleep_for(delay);
+		delay *= 2;
+	}
+	status.mMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return status;
+}
+
+vector<cFanOut::cStatus> cFanOut::Run(const vector<string> & targets, tSender send) const {
+	vector<cStatus> statuses(targets.size());
+	const size_t threads = std::min(mInFlight, targets.size());
+	if (threads <= 1) {
+		for (size_t i=0; i<targets.size(); ++i) statuses[i] = SendOne(targets[i], send);
+		return statuses;
+	}
+
+	std::atomic<size_t> next(0);
+	auto work = [&]() {
+		for (size_t i = next++; i < targets.size(); i = next++) statuses[i] = SendOne(targets[i], send); // each thread writes only its own statuses
+	};
+	vector<std::thread> pool;
+	for (size_t t=1; t<threads; ++t) pool.emplace_back(work);
+	work();
+	for (auto & thread : pool) thread.join();
+	return statuses;
+}
+
+size_t cFanOut::CountOk(const vector<cStatus> & statuses) {
+	return std::count_if(statuses.begin(), statuses.end(), [](const cStatus & s) { return s.mResult == eResult::ok; });
+}
+
+void cFanOut::PrintSummary(ostream & out, const vector<cStatus> & statuses, function<string(const string &)> targetName) {
+	double slowest = 0;
+	for (const auto & status : statuses) {
+		slowest = std::max(slowest, status.mMs);
+		if (status.mResult == eResult::ok) continue;
+		out << zkr::cc::fore::lightred << "failed" << zkr::cc::console << ": " << targetName(status.mTarget) << " (" << status.mTarget << ")"
+			<< " after " << status.mAttempts << " attempt(s)" << ((status.mResult == eResult::transient) ? ", not sent (no connection)" : "") << endl;
+	}
+	const size_t ok = CountOk(statuses);
+	out << ((ok == statuses.size()) ? zkr::cc::fore::lightgreen : zkr::cc::fore::yellow)
+		<< "Sent to " << ok << " of " << statuses.size() << zkr::cc::console << " (slowest " << static_cast<int64_t>(slowest) << "ms)" << endl;
+}
+
+} // namespace nUtils
+} // namespace nOT
+
@@ -0,0 +1,74 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Sending one thing to many targets (e.g. message to many nyms) with bounded concurrency and retries
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_fan_out
+#define INCLUDE_OT_NEWCLI_fan_out
+
+#include "lib_common2.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Runs send(target) for every target, at most mInFlight at the same time (use one cFanOut per notary, so the bound is per notary).
+Failure of one target does not stop others. Transient failures are retried with growing delay - the sender must return
+transient only when the request surely did not reach the server (e.g. no connection), as a retry would send it again.
+Other failures (server rejected, or sent but no reply) are not retried. Status of each target is returned in order of targets.
+*/
+class cFanOut { MAKE_CLASS_NAME("cFanOut");
+	public:
+		enum class eResult { ok, failed, transient };
+		struct cStatus {
+			string mTarget;
+			eResult mResult;
+			size_t mAttempts;
+			double mMs; ///< time of all attempts (with waiting between them)
+		};
+		typedef function<eResult(const string & target)> tSender;
+
+		cFanOut(size_t inFlight, size_t retries=2, std::chrono::milliseconds backoff=std::chrono::milliseconds(250));
+
+		vector<cStatus> Run(const vector<string> & targets, tSender send) const;
+
+		static size_t CountOk(const vector<cStatus> & statuses);
+		static void PrintSummary(ostream & out, const vector<cStatus> & statuses, function<string(const string &)> targetName);
+
+		/**
+		Is the server reachable - for senders, to return transient only for requests that were not sent.
+		Checked once before the fan-out (by the constructor), and again only after some request got no reply:
+		the requests that succeed do not pay for the check.
+		*/
+		class cReachable {
+			public:
+				cReachable(function<bool()> check) : mCheck(check), mOk(check()) { }
+				bool IsOk() const { return mOk; }
+				bool BeforeSend() { return mOk || (mOk = mCheck()); } ///< false: do not send (return transient)
+				void ReplyLost() { mOk = false; } ///< next sends check again
+
+			protected:
+				function<bool()> mCheck;
+				std::atomic<bool> mOk;
+		};
+
+	protected:
+		cStatus SendOne(const string & target, tSender & send) const;
+
+		const size_t mInFlight;
+		const size_t mRetries; ///< attempts after the first one
+		const std::chrono::milliseconds mBackoff; ///< delay before first retry, doubled for each next one
+};
+
+} // namespace nUtils
+} // namespace nOT
+
+
+
+#endif
+
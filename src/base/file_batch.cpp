@@ -0,0 +1,88 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "file_batch.hpp"
+#include "parallel_rows.hpp"
+
+#include "lib_common2.hpp"
+
+#include <cstdio>
+#include <iomanip>
+#include <dirent.h>
+#include <fnmatch.h>
+#include <sys/stat.h>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+bool cFileBatch::Find(const string & dir, const string & glob) {
+	mFiles.clear();
+	const string path = nUtils::cFilesystemUtils::TildeToHome(dir);
+	DIR * directory = opendir(path.c_str());
+	if (!directory) return nUtils::reportError("", dir, "Can not open directory " + dir);
+	while (struct dirent * entry = readdir(directory)) {
+		const string name = entry->d_name;
+		if (fnmatch(glob.c_str(), name.c_str(), FNM_PERIOD) != 0) continue; // FNM_PERIOD: no hidden files, nor . and ..
+		const string file = path + (path.back() == '/' ? "" : "/") + name;
+		struct stat info;
+		if ((stat(file.c_str(), &info) == 0) && S_ISREG(info.st_mode)) mFiles.push_back(file);
+	}
+	closedir(directory);
+	std::sort(mFiles.begin(), mFiles.end());
+	if (mFiles.empty()) return nUtils::reportError("", dir + "/" + glob, "No files matching " + glob + " in " + dir);
+	_info("Found " << mFiles.size() << " files matching " << glob << " in " << dir);
+	return true;
+}
+
+bool cFileBatch::WriteAtomic(const string & path, const string & content) {
+	const string tmpFile = path + ".tmp";
+	{
+		std::ofstream file(tmpFile, std::ios::out | std::ios::trunc | std::ios::binary);
+		file.write(content.data(), content.size());
+		file.flush();
+		if (!file.good()) { std::remove(tmpFile.c_str()); return false; }
+	}
+	return std::rename(tmpFile.c_str(), path.c_str()) == 0;
+}
+
+vector<cFileBatch::cResult> cFileBatch::Run(tWork work, bool writeOutput, const string & outDir, size_t threads) {
+	return nUtils::DecodeRowsParallel<cResult>(mFiles.size(), [&] (size_t i) -> cResult {
+		const string & file = mFiles.at(i);
+		cResult result{ file, false, "", 0 };
+		const string content = nUtils::cEnvUtils().ReadFromFile(file);
+		result.mBytes = content.size();
+		if (content.empty()) { result.mDetail = "empty or unreadable"; return result; }
+
+		string output;
+		result.mOk = work(content, output, result.mDetail);
+		if (result.mOk && writeOutput) {
+			const string target = outDir.empty() ? file : outDir + "/" + file.substr(file.rfind('/') + 1);
+			if (!WriteAtomic(target, output)) { result.mOk = false; result.mDetail = "can not write " + target; }
+		}
+		return result;
+	}, threads);
+}
+
+void cFileBatch::PrintReport(ostream & out, const vector<cResult> & results, double seconds, const string & action) {
+	size_t ok = 0, bytes = 0;
+	for (const auto & result : results) {
+		bytes += result.mBytes;
+		if (result.mOk) ++ok;
+		else out << zkr::cc::fore::lightred << "FAILED " << result.mFile << ": " << result.mDetail << zkr::cc::console << endl;
+	}
+	const double safeSeconds = std::max(seconds, 1e-6);
+	const auto oldPrecision = out.precision();
+	out << (ok == results.size() ? zkr::cc::fore::lightgreen : zkr::cc::fore::lightyellow)
+		<< action << " " << ok << " of " << results.size() << " files" << zkr::cc::console
+		<< " in " << std::fixed << std::setprecision(3) << seconds << " s"
+		<< " (" << std::setprecision(1) << results.size() / safeSeconds << " files/s, "
+		<< std::setprecision(2) << bytes / safeSeconds / (1024*1024) << " MB/s)" << endl;
+	out.unsetf(std::ios::floatfield);
+	out.precision(oldPrecision);
+}
+
+} // namespace nUse
+} // namespace nOT
+
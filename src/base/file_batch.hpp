@@ -0,0 +1,49 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Batch of files (e.g. contracts to sign or verify) from a directory, processed on many threads
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_file_batch
+#define INCLUDE_OT_NEWCLI_file_batch
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Files are read (mapped, @see cEnvUtils::ReadFromFile) and written on a pool of threads.
+The work function is called from those threads too - it must lock what is not thread safe (e.g. OTAPI).
+Output is written to temporary file and renamed, so a file is never left half written (also when overwritten in place).
+*/
+class cFileBatch { MAKE_CLASS_NAME("cFileBatch");
+	public:
+		struct cResult {
+			string mFile;
+			bool mOk;
+			string mDetail; ///< why it failed
+			size_t mBytes; ///< size of input
+		};
+
+		typedef function< bool (const string & content, string & output, string & detail) > tWork; ///< false if failed (detail says why)
+
+		bool Find(const string & dir, const string & glob); ///< files in dir (not recursive) matching glob, sorted; false (reported) if none
+		const vector<string> & GetFiles() const { return mFiles; }
+
+		/// outDir="" writes output over the input file; writeOutput=false for checks (verification)
+		vector<cResult> Run(tWork work, bool writeOutput, const string & outDir, size_t threads = 0);
+
+		static bool WriteAtomic(const string & path, const string & content);
+		static void PrintReport(ostream & out, const vector<cResult> & results, double seconds, const string & action); ///< with throughput
+
+	protected:
+		vector<string> mFiles;
+};
+
+} // namespace nUse
+} // namespace nOT
+
+#endif
+
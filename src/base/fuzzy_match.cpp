@@ -0,0 +1,91 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "fuzzy_match.hpp"
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cFuzzyMatcher::cFuzzyMatcher(const string & pattern, int maxErrors)
+: mPattern(pattern), mMaxErrors(maxErrors), mBitParallel(!pattern.empty() && pattern.size() <= 64), mLastBit(0), mPatternMask(0)
+{
+	mPeq.fill(0);
+	if (!mBitParallel) return;
+	for (size_t i=0; i<pattern.size(); ++i) mPeq[ static_cast<unsigned char>(pattern[i]) ] |= uint64_t(1) << i;
+	mLastBit = uint64_t(1) << (pattern.size() - 1);
+	mPatternMask = mLastBit | (mLastBit - 1);
+}
+
+int cFuzzyMatcher::PopCount(uint64_t bits) {
+#ifdef __GNUC__
+	return __builtin_popcountll(bits);
+#else
+	int count = 0;
+	for (; bits; bits &= bits - 1) ++count;
+	return count;
+#endif
+}
+
+int cFuzzyMatcher::DefaultMaxErrors(size_t patternSize) {
+	if (patternSize < 3) return 0;
+	if (patternSize < 6) return 1;
+	return 2;
+}
+
+int cFuzzyMatcher::PrefixDistance(const string & text) const {
+	if (!mBitParallel || mMaxErrors == 0) return CheckIfBegins(mPattern, text) ? 0 : -1;
+
+	const int m = mPattern.size();
+	uint64_t VP = ~uint64_t(0), VN = 0; // vertical deltas of current column: D[i][0] = i
+	int score = m; // D[m][j]
+	int best = m; // empty prefix: delete whole pattern
+	// D[m][j] >= j-m, so prefixes longer than m+maxErrors can not be better
+	const size_t end = std::min(text.size(), size_t(m + mMaxErrors));
+
+	// filter: pattern position whose character is nowhere in the window costs an edit in any alignment
+	uint64_t present = 0;
+	for (size_t j=0; j<end; ++j) present |= mPeq[ static_cast<unsigned char>(text[j]) ];
+	if (PopCount(~present & mPatternMask) > mMaxErrors) return -1;
+
+	for (size_t j=0; j<end; ++j) {
+		const uint64_t Eq = mPeq[ static_cast<unsigned char>(text[j]) ];
+		const uint64_t Xv = Eq | VN;
+		const uint64_t Xh = (((Eq & VP) + VP) ^ VP) | Eq;
+		uint64_t HP = VN | ~(Xh | VP);
+		uint64_t HN = VP & Xh;
+		if (HP & mLastBit) ++score;
+		else if (HN & mLastBit) --score;
+		HP = (HP << 1) | 1; // row 0 grows by 1 per character: prefix of text is anchored at its start
+		HN <<= 1;
+		VP = HN | ~(Xv | HP);
+		VN = HP & Xv;
+		best = std::min(best, score);
+	}
+	return (best <= mMaxErrors) ? best : -1;
+}
+
+vector<string> WordsThatMatchFuzzy(const std::string & sofar, const vector<string> & possib) {
+	const string sofar_ = SpaceFromSpecial(sofar);
+	const cFuzzyMatcher matcher(sofar_, cFuzzyMatcher::DefaultMaxErrors(sofar_.size()));
+
+	vector<std::pair<int, size_t>> found; // distance, index in possib
+	for (size_t i=0; i<possib.size(); ++i) {
+		int distance = matcher.PrefixDistance(possib[i]);
+		if (distance >= 0) found.push_back( std::make_pair(distance, i) );
+	}
+	std::stable_sort(found.begin(), found.end(),
+		[] (const std::pair<int, size_t> & a, const std::pair<int, size_t> & b) { return a.first < b.first; } );
+
+	vector<string> ret;
+	ret.reserve(found.size());
+	for (const auto & match : found) ret.push_back( EscapeFromSpace(possib[match.second]) );
+	return ret;
+}
+
+} // namespace nUtils
+} // namespace nOT
+
@@ -0,0 +1,49 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Typo tolerant (fuzzy) matching of completion candidates - bit-parallel edit distance
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_fuzzy_match
+#define INCLUDE_OT_NEWCLI_fuzzy_match
+
+#include "lib_common2.hpp"
+
+#include <array>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Edit distance between the typed pattern and the best prefix of a candidate ("alcie" vs "alice_savings" is 2),
+computed by Myers/Hyyro bit-parallel algorithm: one 64-bit word holds whole column of the DP table,
+so a candidate costs few operations per character, and only its first pattern+maxErrors characters are read.
+Patterns longer than 64 characters are matched exactly (as prefix).
+*/
+class cFuzzyMatcher {
+	public:
+		cFuzzyMatcher(const string & pattern, int maxErrors);
+
+		int PrefixDistance(const string & text) const; ///< distance to best prefix of text, or -1 if above maxErrors
+		static int DefaultMaxErrors(size_t patternSize); ///< 0 for very short words (too many matches otherwise), then 1, then 2
+
+	protected:
+		const string mPattern;
+		const int mMaxErrors;
+		bool mBitParallel; ///< false for too long pattern
+		std::array<uint64_t, 256> mPeq; ///< for each character: bits of pattern positions where it is
+		uint64_t mLastBit;
+		uint64_t mPatternMask; ///< bits of all pattern positions
+
+		static int PopCount(uint64_t bits);
+};
+
+/// As WordsThatMatch, but also candidates with few typos; ranked: exact prefix matches first, then by distance (else in given order)
+vector<string> WordsThatMatchFuzzy(const std::string & sofar, const vector<string> & possib);
+
+} // namespace nUtils
+} // namespace nOT
+
+#endif
+
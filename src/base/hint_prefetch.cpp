@@ -0,0 +1,155 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "hint_prefetch.hpp"
+
+#include "lib_common2.hpp"
+#include "cmd.hpp"
+#include "useot.hpp"
+#include "trace.hpp"
+
+namespace nOT {
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+namespace {
+
+vector<string> ComputeWithParser(shared_ptr<nNewcli::cCmdParser> parser, shared_ptr<nUse::cUseOT> use, const string & line, bool & filenames) {
+	// hint functions may request filename completion by setting this flag, we do not want it as side effect
+	const bool old_filenames = parser->mEnableFilenameCompletion;
+	parser->mEnableFilenameCompletion = false;
+	auto processing = parser->StartProcessing(line, use);
+	vector<string> completions = processing.UseComplete( line.size() );
+	filenames = parser->mEnableFilenameCompletion;
+	parser->mEnableFilenameCompletion = old_filenames;
+	return completions;
+}
+
+} // namespace
+
+cHintPrefetcher::cHintPrefetcher(shared_ptr<nNewcli::cCmdParser> parser, shared_ptr<nUse::cUseOT> use)
+: cHintPrefetcher(
+	[parser, use] (const string & line, bool & filenames) { return ComputeWithParser(parser, use, line, filenames); },
+	[use] () {
+		if (!use->Init()) return; // first call loads the wallet - the slow part of first TAB
+		use->NymGetAll();
+	},
+	[use] () { use->TransNumReplenish(); } )
+{ }
+
+cHintPrefetcher::cHintPrefetcher(tCompute compute, tWork warm, tWork replenish)
+: mCompute(compute), mWarm(warm), mReplenish(replenish), mWarmPending(true), mReplenishPending(false), mFinish(false), mGeneration(0)
+{
+	mThread = std::thread( [this]() { Worker(); } );
+}
+
+cHintPrefetcher::~cHintPrefetcher() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFinish = true;
+	}
+	mCond.notify_all();
+	if (mThread.joinable()) mThread.join();
+}
+
+cHintPrefetcher::tApiLock cHintPrefetcher::LockApi() {
+	return tApiLock(mApiMutex);
+}
+
+cHintPrefetcher::tApiLock cHintPrefetcher::TryLockApi() {
+	return tApiLock(mApiMutex, std::try_to_lock);
+}
+
+void cHintPrefetcher::Predict(const string & line) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mReady.count(line)) return; // already have it
+		mPending.remove(line);
+		mPending.push_front(line); // newest first - older predictions are less likely to be asked
+		while (mPending.size() > mPendingMax) mPending.pop_back();
+	}
+	mCond.notify_one();
+}
+
+void cHintPrefetcher::PredictAfter(const string & line, const vector<string> & completions) {
+	if (completions.size() != 1) return; // user still has to choose, we can not guess the next slot
+	auto pos = line.rfind(' ');
+	const string head = (pos == string::npos) ? "" : line.substr(0, pos+1);
+	Predict( head + completions.at(0) + " " );
+}
+
+void cHintPrefetcher::Invalidate() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mReady.clear();
+		mPending.clear();
+		++mGeneration; // a Compute running now sees old data
+		mWarmPending = true;
+		mReplenishPending = true;
+	}
+	mCond.notify_one();
+}
+
+bool cHintPrefetcher::TryGet(const string & line, vector<string> & completions) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto found = mReady.find(line);
+	if (found == mReady.end()) return false;
+	completions = found->second;
+	return true;
+}
+
+void cHintPrefetcher::Worker() {
+	_dbg1("Hint prefetcher started");
+	nUtils::gTrace.SetThreadName("hint-prefetch");
+	while (true) {
+		string line;
+		bool warm = false, replenish = false;
+		uint64_t generation = 0;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCond.wait(lock, [this]() { return mFinish || mWarmPending || !mPending.empty() || mReplenishPending; } );
+			if (mFinish) break;
+			generation = mGeneration; // taken with the line, before Compute
+			if (mWarmPending) { warm = true; mWarmPending = false; }
+			else if (!mPending.empty()) { line = mPending.front(); mPending.pop_front(); }
+			else { replenish = true; mReplenishPending = false; } // idle: predictions go first, they are waited for
+		}
+
+		try {
+			if (warm) {
+				auto lock = LockApi();
+				_dbg2("Warming hint sources");
+				mWarm();
+				continue;
+			}
+			if (replenish) {
+				auto lock = LockApi();
+				mReplenish();
+				continue;
+			}
+
+			bool filenames = false;
+			vector<string> completions;
+			{
+				auto lock = LockApi();
+				completions = mCompute(line, filenames);
+			}
+			if (filenames) continue; // such answer depends on readline's own filename completion, leave it to TAB handler
+			_dbg3("Prefetched completions for [" << line << "]: " << DbgVector(completions));
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (generation != mGeneration) { _dbg3("Dropped prefetch of [" << line << "], invalidated meanwhile"); continue; }
+			if (mReady.size() >= mReadyMax) mReady.clear(); // simple bound, these are only guesses
+			mReady[line] = completions;
+		}
+		catch (const std::exception &e) {
+			_warn("Prefetch of hint for [" << line << "] failed: " << e.what()); // TAB handler will compute it again and report
+		}
+	}
+	_dbg1("Hint prefetcher finished");
+}
+
+} // namespace nOTHint
+} // namespace nOT
+
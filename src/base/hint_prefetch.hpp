@@ -0,0 +1,89 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Background prefetch of hint data for the interactive shell (TAB completion)
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_hint_prefetch
+#define INCLUDE_OT_NEWCLI_hint_prefetch
+
+#include "lib_common2.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace nOT {
+namespace nUse { class cUseOT; }
+namespace nNewcli { class cCmdParser; }
+
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Computes completions for lines that the user is likely to TAB on next, on a worker thread,
+while the main thread sits in readline() waiting for keys.
+
+OTAPI is not thread safe, so every user of the parser/cUseOT (the worker, the TAB handler,
+executed commands) must hold LockApi() while touching it.
+
+Predictions come from:
+- the prompt - after each command the sources are re-warmed (Init, nyms, command names)
+- each TAB answer - if it narrows to one word, the line with that word accepted is computed next,
+  so the following TAB (the next argument slot, e.g. accounts after a nym) reads ready data
+
+When there is nothing to predict, the worker also tops up transaction numbers used by the last commands
+(cUseOT::TransNumReplenish), so that server round-trip is not made while a command waits.
+*/
+class cHintPrefetcher { MAKE_CLASS_NAME("cHintPrefetcher");
+	public:
+		typedef std::unique_lock<std::mutex> tApiLock;
+		typedef std::function< vector<string> (const string & line, bool & filenames) > tCompute; ///< completions of line, set filenames if they need readline's own
+		typedef std::function< void () > tWork;
+
+		cHintPrefetcher(shared_ptr<nNewcli::cCmdParser> parser, shared_ptr<nUse::cUseOT> use);
+		cHintPrefetcher(tCompute compute, tWork warm, tWork replenish); ///< each called with LockApi held, on the worker thread
+		~cHintPrefetcher();
+
+		tApiLock LockApi(); ///< take before using parser or OTAPI from any thread
+		tApiLock TryLockApi(); ///< as LockApi() but does not wait, check owns_lock()
+
+		void Predict(const string & line); ///< ask worker to compute completions of this line (newest request wins)
+		void PredictAfter(const string & line, const vector<string> & completions); ///< predict next line from TAB answer
+		void Invalidate(); ///< drop all ready results (e.g. a command changed the wallet), re-warm the sources, then top up numbers
+
+		bool TryGet(const string & line, vector<string> & completions); ///< if worker already has answer for line
+
+	protected:
+		void Worker();
+
+	protected:
+		tCompute mCompute;
+		tWork mWarm; ///< load the cached hint sources (can take long on first call: wallet load)
+		tWork mReplenish;
+
+		std::mutex mApiMutex; ///< serializes all OTAPI / parser use
+		std::mutex mMutex; ///< protects the fields below
+		std::condition_variable mCond;
+
+		list<string> mPending; ///< lines to compute, newest first
+		bool mWarmPending;
+		bool mReplenishPending; ///< top up transaction numbers when idle
+		bool mFinish;
+		map<string, vector<string>> mReady; ///< line -> completions
+		uint64_t mGeneration; ///< ++ by Invalidate; a result computed across it is stale and not kept
+
+		static const size_t mPendingMax = 4;
+		static const size_t mReadyMax = 64;
+
+		std::thread mThread; // last, so it starts after the fields are constructed
+};
+
+} // namespace nOTHint
+} // namespace nOT
+
+
+
+#endif
+
@@ -0,0 +1,107 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "instrument_cache.hpp"
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+string cInstrumentCache::Hash(const string & text) {
+	uint64_t hash = 14695981039346656037ULL; // FNV-1a, as cLedgerMirror
+	for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ULL; }
+	std::ostringstream oss;
+	oss << std::hex << hash << ":" << std::dec << text.size();
+	return oss.str();
+}
+
+string cInstrumentCache::Attribute(const string & tag, const string & name) {
+	const string key = " " + name + "=\"";
+	size_t pos = tag.find(key);
+	if (pos == string::npos) return "";
+	pos += key.size();
+	const size_t end = tag.find('"', pos);
+	return (end == string::npos) ? "" : tag.substr(pos, end - pos);
+}
+
+bool cInstrumentCache::ReadMintValidity(const string & mint, int64_t & series, std::time_t & expiration) {
+	const size_t start = mint.find("<mint ");
+	if (start == string::npos) return false;
+	const size_t end = mint.find('>', start);
+	if (end == string::npos) return false;
+	const string tag = mint.substr(start, end - start);
+	const string seriesStr = Attribute(tag, "series");
+	const string expirationStr = Attribute(tag, "expiration");
+	if (!nUtils::isNumber(seriesStr) || !nUtils::isNumber(expirationStr)) return false;
+	series = std::stoll(seriesStr);
+	expiration = static_cast<std::time_t>(std::stoll(expirationStr));
+	return expiration > 0;
+}
+
+const string & cInstrumentCache::Store(const string & text) {
+	const string hash = Hash(text);
+	mTexts.insert( std::make_pair(hash, text) ); // kept if same content is there
+	return mTexts.find(hash)->first;
+}
+
+bool cInstrumentCache::GetMint(const string & notaryID, const string & assetID, string & mint, std::time_t now) {
+	auto found = mMints.find( std::make_pair(notaryID, assetID) );
+	if (found == mMints.end()) return false;
+	if (now >= found->second.mExpiration) {
+		_info("Cached mint (series " << found->second.mSeries << ") of asset " << assetID << " expired, will load it again");
+		mMints.erase(found);
+		DropUnused();
+		return false;
+	}
+	mint = mTexts.at(found->second.mHash);
+	_dbg2("Using cached mint series " << found->second.mSeries << " of asset " << assetID);
+	return true;
+}
+
+void cInstrumentCache::PutMint(const string & notaryID, const string & assetID, const string & mint) {
+	int64_t series = 0;
+	std::time_t expiration = 0;
+	if (!ReadMintValidity(mint, series, expiration)) { _dbg1("Not caching mint of asset " << assetID << ": can not read its expiration"); return; }
+	mMints[ std::make_pair(notaryID, assetID) ] = cMintEntry{ Store(mint), series, expiration };
+	DropUnused(); // previous series
+}
+
+bool cInstrumentCache::GetContract(const string & assetID, string & contract) const {
+	auto found = mContracts.find(assetID);
+	if (found == mContracts.end()) return false;
+	contract = mTexts.at(found->second);
+	return true;
+}
+
+void cInstrumentCache::PutContract(const string & assetID, const string & contract) {
+	if (contract.empty()) return;
+	mContracts[assetID] = Store(contract);
+	DropUnused();
+}
+
+void cInstrumentCache::ClearContracts() {
+	mContracts.clear();
+	DropUnused();
+}
+
+void cInstrumentCache::Clear() {
+	mMints.clear();
+	mContracts.clear();
+	mTexts.clear();
+}
+
+void cInstrumentCache::DropUnused() {
+	set<string> used;
+	for (const auto & mint : mMints) used.insert(mint.second.mHash);
+	for (const auto & contract : mContracts) used.insert(contract.second);
+	for (auto it = mTexts.begin(); it != mTexts.end(); ) {
+		if (used.count(it->first)) ++it; else it = mTexts.erase(it);
+	}
+}
+
+} // namespace nUse
+} // namespace nOT
+
@@ -0,0 +1,59 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Cache of mints and asset contracts (as loaded from OTAPI), so repeated cash operations do not load and parse them again
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_instrument_cache
+#define INCLUDE_OT_NEWCLI_instrument_cache
+
+#include "lib_common2.hpp"
+
+#include <ctime>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Mints change only at series rollover: the mint of (notary, asset) is kept with its series and expiration (read from the
+mint's own XML attributes) and is served until it expires, so load_or_retrieve_mint (that checks, loads and parses it) is skipped.
+A mint whose expiration can not be read is not cached.
+Asset contracts do not change: kept until cleared (e.g. when wallet watcher sees contracts/ changed).
+Entries are addressed by content hash too, so the same text is stored once even if loaded for many notaries.
+*/
+class cInstrumentCache { MAKE_CLASS_NAME("cInstrumentCache");
+	public:
+		bool GetMint(const string & notaryID, const string & assetID, string & mint, std::time_t now = std::time(nullptr));
+		void PutMint(const string & notaryID, const string & assetID, const string & mint);
+
+		bool GetContract(const string & assetID, string & contract) const;
+		void PutContract(const string & assetID, const string & contract);
+
+		void ClearContracts();
+		void Clear();
+
+		static bool ReadMintValidity(const string & mint, int64_t & series, std::time_t & expiration); ///< from <mint ... series="" expiration="">
+
+	protected:
+		struct cMintEntry {
+			string mHash; ///< key to mTexts
+			int64_t mSeries;
+			std::time_t mExpiration;
+		};
+
+		static string Hash(const string & text);
+		static string Attribute(const string & tag, const string & name);
+		const string & Store(const string & text); ///< returns hash
+		void DropUnused();
+
+		map<std::pair<string, string>, cMintEntry> mMints; ///< (notary, asset)
+		map<string, string> mContracts; ///< asset -> hash
+		map<string, string> mTexts; ///< content hash -> text
+};
+
+} // namespace nUse
+} // namespace nOT
+
+#endif
+
@@ -0,0 +1,71 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "latency_histogram.hpp"
+
+#include "lib_common1.hpp"
+
+#include <limits>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+cLatencyHistogram::cLatencyHistogram()
+: mCounts( (64 - mSubBucketBits + 1) * mSubBuckets, 0 )
+{
+	Clear();
+}
+
+void cLatencyHistogram::Clear() {
+	std::fill(mCounts.begin(), mCounts.end(), 0);
+	mCount = 0; mSum = 0; mMax = 0;
+	mMin = std::numeric_limits<uint64_t>::max();
+}
+
+// values below mSubBuckets are exact (bucket 0); above, bucket k holds [2^(k+b-1), 2^(k+b)) split to mSubBuckets/2 .. mSubBuckets-1 parts
+size_t cLatencyHistogram::Index(uint64_t us) {
+	if (us < mSubBuckets) return us;
+	unsigned magnitude = 0;
+	for (uint64_t v = us >> mSubBucketBits; v; v >>= 1) ++magnitude; // how many times above the linear range
+	const uint64_t sub = us >> magnitude; // in [mSubBuckets/2, mSubBuckets)
+	return magnitude * mSubBuckets + sub;
+}
+
+uint64_t cLatencyHistogram::UpperEdge(size_t index) {
+	const unsigned magnitude = index / mSubBuckets;
+	const uint64_t sub = index % mSubBuckets;
+	if (magnitude == 0) return sub;
+	return ((sub + 1) << magnitude) - 1;
+}
+
+void cLatencyHistogram::Record(uint64_t us) {
+	++mCounts.at(Index(us));
+	++mCount;
+	mSum += us;
+	mMin = std::min(mMin, us);
+	mMax = std::max(mMax, us);
+}
+
+void cLatencyHistogram::Add(const cLatencyHistogram & other) {
+	for (size_t i=0; i<mCounts.size(); ++i) mCounts[i] += other.mCounts[i];
+	mCount += other.mCount;
+	mSum += other.mSum;
+	if (other.mCount) { mMin = std::min(mMin, other.mMin); mMax = std::max(mMax, other.mMax); }
+}
+
+uint64_t cLatencyHistogram::Percentile(double percent) const {
+	if (!mCount) return 0;
+	const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percent / 100.0 * mCount + 0.5)); // how many values are at or below
+	uint64_t seen = 0;
+	for (size_t i=0; i<mCounts.size(); ++i) {
+		seen += mCounts[i];
+		if (seen >= rank) return std::min(UpperEdge(i), mMax);
+	}
+	return mMax;
+}
+
+} // namespace nUtils
+} // namespace nOT
+
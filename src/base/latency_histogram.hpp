@@ -0,0 +1,49 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Histogram of latencies (e.g. server ping round trip) with fixed relative precision, for percentiles
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_latency_histogram
+#define INCLUDE_OT_NEWCLI_latency_histogram
+
+#include "lib_common1.hpp"
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+/**
+Like HDR histogram: values (microseconds) go to buckets by power of two, each split to mSubBuckets linear parts,
+so any recorded value is known with error below 2/mSubBuckets (~6%), from 1 us to hours, in 15 kB of counters.
+Recording is O(1), percentile is O(buckets). Min, max and sum are exact.
+*/
+class cLatencyHistogram {
+	public:
+		cLatencyHistogram();
+
+		void Record(uint64_t us);
+		void Add(const cLatencyHistogram & other); ///< merge (e.g. per-round histogram into total)
+		void Clear();
+
+		uint64_t GetCount() const { return mCount; }
+		uint64_t GetMin() const { return mCount ? mMin : 0; }
+		uint64_t GetMax() const { return mMax; }
+		double GetMean() const { return mCount ? double(mSum) / mCount : 0; }
+		uint64_t Percentile(double percent) const; ///< e.g. 50, 99; upper edge of the bucket (but never above max)
+
+	protected:
+		static const unsigned mSubBucketBits = 5;
+		static const unsigned mSubBuckets = 1u << mSubBucketBits;
+		static size_t Index(uint64_t us);
+		static uint64_t UpperEdge(size_t index);
+
+		vector<uint64_t> mCounts;
+		uint64_t mCount, mMin, mMax, mSum;
+};
+
+} // namespace nUtils
+} // namespace nOT
+
+#endif
+
@@ -0,0 +1,138 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "ledger_mirror.hpp"
+
+#include "lib_common2.hpp"
+
+#include <cstdio>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+const string cLedgerMirror::mHeader = "ot-ledger-mirror 1";
+
+cLedgerMirror::cLedgerMirror(const string & file, size_t fields)
+: mFile(file), mFields(fields), mRewrite(false), mHits(0), mMisses(0)
+{
+	Load();
+}
+
+string cLedgerMirror::Key(const string & contents) {
+	uint64_t hash = 14695981039346656037ULL; // FNV-1a, stable between runs (unlike std::hash)
+	for (unsigned char c : contents) { hash ^= c; hash *= 1099511628211ULL; }
+	std::ostringstream oss;
+	oss << std::hex << hash;
+	return oss.str();
+}
+
+string cLedgerMirror::Key(int64_t transactionNum, const string & contents) {
+	return ToStr(transactionNum) + ":" + Key(contents);
+}
+
+string cLedgerMirror::Escape(const string & s) {
+	string ret;
+	ret.reserve(s.size());
+	for (char c : s) {
+		switch (c) {
+			case '\\': ret += "\\\\"; break;
+			case '\t': ret += "\\t"; break;
+			case '\n': ret += "\\n"; break;
+			default: ret += c;
+		}
+	}
+	return ret;
+}
+
+string cLedgerMirror::Unescape(const string & s) {
+	string ret;
+	ret.reserve(s.size());
+	for (size_t i=0; i<s.size(); ++i) {
+		if ((s[i] == '\\') && (i+1 < s.size())) {
+			++i;
+			if (s[i] == 't') ret += '\t';
+			else if (s[i] == 'n') ret += '\n';
+			else ret += s[i];
+		}
+		else ret += s[i];
+	}
+	return ret;
+}
+
+string cLedgerMirror::FormatRow(const string & key, const tRow & row) {
+	string line = Escape(key);
+	for (const auto & field : row) line += "\t" + Escape(field);
+	return line;
+}
+
+void cLedgerMirror::Load() {
+	std::ifstream file(mFile);
+	if (!file.good()) { _dbg2("No ledger mirror yet in " << mFile); return; }
+	string line;
+	std::getline(file, line);
+	if (line != mHeader) { _warn("Ignoring ledger mirror with unknown format: " << mFile); mRewrite = true; return; }
+	while (std::getline(file, line)) {
+		if (line.empty()) continue;
+		tRow fields;
+		size_t pos = 0;
+		while (true) {
+			size_t tab = line.find('\t', pos);
+			fields.push_back( Unescape(line.substr(pos, tab == string::npos ? string::npos : tab-pos)) );
+			if (tab == string::npos) break;
+			pos = tab+1;
+		}
+		if (fields.size() != mFields + 1) { _warn("Dropping bad row of ledger mirror " << mFile << ": " << line); mRewrite = true; continue; }
+		const string key = fields.at(0);
+		fields.erase(fields.begin());
+		mRows[key] = fields; // later line wins (it could be appended again after rewrite failed)
+	}
+	_dbg2("Loaded ledger mirror " << mFile << " with " << mRows.size() << " rows");
+}
+
+bool cLedgerMirror::Get(const string & key, tRow & row) {
+	auto found = mRows.find(key);
+	if (found == mRows.end()) { ++mMisses; return false; }
+	++mHits;
+	mSeen.insert(key);
+	row = found->second;
+	return true;
+}
+
+void cLedgerMirror::Put(const string & key, const tRow & row) {
+	if (row.size() != mFields) { _erro("Row of " << row.size() << " fields for ledger mirror " << mFile << " of " << mFields); return; }
+	if (!mRows.count(key)) mNew.push_back(key);
+	mRows[key] = row;
+	mSeen.insert(key);
+}
+
+void cLedgerMirror::Save() {
+	_dbg2("Ledger mirror " << mFile << ": reused " << mHits << " rows, decoded " << mMisses);
+	if (mRewrite || (mSeen.size() < mRows.size())) { // some transactions left the box (or file was bad) - rewrite with only present ones
+		const string tmpFile = mFile + ".tmp";
+		{
+			std::ofstream file(tmpFile, std::ios::trunc);
+			file << mHeader << '\n';
+			for (const auto & key : mSeen) file << FormatRow(key, mRows.at(key)) << '\n';
+			if (!file.good()) { _warn("Can not write ledger mirror " << tmpFile); return; }
+		}
+		if (std::rename(tmpFile.c_str(), mFile.c_str()) != 0) { _warn("Can not replace ledger mirror " << mFile); return; }
+		mRewrite = false;
+		for (auto it = mRows.begin(); it != mRows.end(); ) {
+			if (mSeen.count(it->first)) ++it; else it = mRows.erase(it);
+		}
+	}
+	else if (mNew.size()) {
+		const bool fresh = !std::ifstream(mFile).good();
+		std::ofstream file(mFile, std::ios::app);
+		if (fresh) file << mHeader << '\n';
+		for (const auto & key : mNew) file << FormatRow(key, mRows.at(key)) << '\n';
+		if (!file.good()) _warn("Can not append to ledger mirror " << mFile);
+	}
+	mNew.clear();
+}
+
+} // namespace nUse
+} // namespace nOT
+
@@ -0,0 +1,66 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Local mirror of decoded ledger (inbox, outbox, payments inbox, outpayments) rows
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_ledger_mirror
+#define INCLUDE_OT_NEWCLI_ledger_mirror
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Keeps the fields that CLI displays for each transaction of one box, in a small text file, so that on next "ls"
+only new or changed transactions need to be decoded by OTAPI (that is the slow part with big boxes).
+
+Rows are keyed by transaction number plus hash of the transaction contents, so changed transaction is decoded again.
+File format: header line, then one row per line: key TAB field TAB field... (TAB, LF and \ are escaped).
+New rows are appended; file is rewritten when some rows disappeared from the box, or the file was not all good
+(unknown header, or rows without the expected count of fields - e.g. cut by a crash while appending; those are dropped).
+Names (of nyms, accounts) are NOT stored, only IDs - names are resolved when displaying, so renames are visible.
+*/
+class cLedgerMirror { MAKE_CLASS_NAME("cLedgerMirror");
+	public:
+		typedef vector<string> tRow; ///< decoded fields of one transaction
+
+		cLedgerMirror(const string & file, size_t fields); ///< e.g. client_data/ledger_mirror/inbox-<accountID>, directory must exist; fields: of each row
+
+		static string Key(int64_t transactionNum, const string & contents); ///< key of row
+		static string Key(const string & contents); ///< key of row that has no transaction number (e.g. outpayment)
+
+		bool Get(const string & key, tRow & row); ///< row from mirror if known; marks it as still present in box
+		void Put(const string & key, const tRow & row); ///< freshly decoded row; marks it as present in box
+		void Save(); ///< call after walking the whole box: append new rows, or rewrite if rows disappeared
+
+		size_t GetHits() const { return mHits; }
+		size_t GetMisses() const { return mMisses; }
+
+	protected:
+		void Load();
+		static string Escape(const string & s);
+		static string Unescape(const string & s);
+		static string FormatRow(const string & key, const tRow & row);
+
+	protected:
+		const string mFile;
+		const size_t mFields;
+		bool mRewrite; ///< file must be written whole (it was not all good)
+		map<string, tRow> mRows; ///< all known rows: key -> fields
+		set<string> mSeen; ///< keys that are present in current box
+		vector<string> mNew; ///< keys added in this run (not in file yet)
+		size_t mHits, mMisses;
+
+		static const string mHeader;
+};
+
+} // namespace nUse
+} // namespace nOT
+
+
+
+#endif
+
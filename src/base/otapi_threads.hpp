@@ -0,0 +1,31 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Which OTAPI calls may be made from many threads at once - build options, all off by default
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_otapi_threads
+#define INCLUDE_OT_NEWCLI_otapi_threads
+
+// OTAPI keeps its state in process-wide singletons, and the usual backend is not safe to call concurrently.
+// Each switch below is set from cmake (-DOTAPI_<NAME>_THREADSAFE=ON, see CMakeLists.txt) only with a backend where
+// that group of calls can run on many threads; when it is off, the code that uses it makes those calls one at a time
+// (and keeps any other work, like reading files, parallel).
+
+#ifndef CFG_OTAPI_DECODE_THREADSAFE
+	#define CFG_OTAPI_DECODE_THREADSAFE 0 ///< Transaction_Get* / Instrmnt_Get* on a given text (ledger rows, @see DecodeOTRows)
+#endif
+
+#ifndef CFG_OTAPI_SEND_THREADSAFE
+	#define CFG_OTAPI_SEND_THREADSAFE 0 ///< OT_ME server requests, e.g. send_user_msg, register_nym, pingNotary (@see cFanOut)
+#endif
+
+#ifndef CFG_OTAPI_KEYGEN_THREADSAFE
+	#define CFG_OTAPI_KEYGEN_THREADSAFE 0 ///< OT_ME::create_nym - key generation and adding to the wallet (bulk nym new)
+#endif
+
+#ifndef CFG_OTAPI_SIGN_THREADSAFE
+	#define CFG_OTAPI_SIGN_THREADSAFE 0 ///< SignContract / VerifySignature (batch contract sign)
+#endif
+
+#endif
+
@@ -8,6 +8,9 @@
 #include "lib_common2.hpp"
 
 #include "daemon_tools.hpp"
+#include "wallet_host.hpp"
+
+#include <cstdlib>
 
 namespace nOT {
 namespace nNewcli {
@@ -87,6 +90,27 @@ int cOTCli::_Run(const vector<string> args_without_programname) {
 				status = 1;
 			}
 		}
+		else if (arg=="--wallet-host") { // otcli "--wallet-host" - serve many wallets, @see nUse::cWalletHost
+			auto env_or = [] (const char * name, size_t def) -> size_t { const char * v = std::getenv(name); return v ? std::strtoul(v, NULL, 10) : def; };
+			const size_t budget_mb = env_or("OTX_HOST_MEMORY_MB", 1024);
+			const size_t max_sessions = env_or("OTX_HOST_SESSIONS", 16);
+			const size_t idle_seconds = env_or("OTX_HOST_IDLE", 600);
+			nOT::nOTHint::cInteractiveShell shell;
+			auto worker = [&shell] (const string & home, int requestFd, int doneFd) { return shell.ServeWallet(home, requestFd, doneFd); };
+			nUse::cWalletHost host(cDaemoninfoHost().GetPathIn(), worker, budget_mb * 1024 * 1024, max_sessions, idle_seconds);
+			status = host.Run();
+		}
+		else if (arg=="--host-run") { // otcli "--host-run" "/home/wallet1" "ot account ls"
+			string home, v;  bool ok=1;  try { home=args.at(nr+1); v=args.at(nr+2); } catch(...) { ok=0; } //
+			if (ok) {
+				nOT::nOTHint::cInteractiveShell shell;
+				if (!shell.RunOnceWithHost(home, v)) status = 1;
+			}
+			else {
+				_erro("Missing variables for command line argument '"<<arg<<"'");
+				status = 1;
+			}
+		}
 		else if (arg=="--run-one") { // otcli "--run-one" "ot msg sendfr"
 			auto useOT = std::make_shared<nUse::cUseOT>("Normal");
 			string v;  bool ok=1;  try { v=args.at(nr+1); } catch(...) { ok=0; } //
@@ -7,6 +7,11 @@
 
 //#include "tests.hpp" // TODO Not needed
 #include "daemon_tools.hpp"
+#include "hint_prefetch.hpp"
+#include "shell_jobs.hpp"
+#include "completion_cache.hpp"
+#include "stats.hpp"
+#include "wallet_host.hpp"
 
 #ifndef _WIN32
 #include <unistd.h>
@@ -290,6 +295,23 @@ using namespace nOT::nUtils::nOper; // vector + vector and other shortcut operat
 
 shared_ptr<nNewcli::cCmdParser> gReadlineHandleParser;
 shared_ptr<nUse::cUseOT> gReadlineHandlerUseOT;
+shared_ptr<cHintPrefetcher> gReadlineHandlerPrefetcher; // only in editline shell, NULL otherwise
+shared_ptr<cShellJobs> gReadlineHandlerJobs; // only in editline shell, NULL otherwise
+
+static cHintPrefetcher::tApiLock LockHintApi() { // no-op lock when there is no prefetcher thread
+	if (gReadlineHandlerPrefetcher) return gReadlineHandlerPrefetcher->LockApi();
+	return cHintPrefetcher::tApiLock();
+}
+
+/// For TAB: do not block the prompt while a background job holds the API, then use only prefetched data
+static cHintPrefetcher::tApiLock LockHintApiForTab(bool & locked) {
+	locked = true;
+	if (!gReadlineHandlerPrefetcher) return cHintPrefetcher::tApiLock();
+	if (!(gReadlineHandlerJobs && gReadlineHandlerJobs->IsBusy())) return gReadlineHandlerPrefetcher->LockApi();
+	auto lock = gReadlineHandlerPrefetcher->TryLockApi();
+	locked = lock.owns_lock();
+	return lock;
+}
 
 cInteractiveShell::cInteractiveShell()
 :dbg(false)
@@ -298,14 +320,25 @@ cInteractiveShell::cInteractiveShell()
 
 bool cInteractiveShell::Execute(const string cmd) {
 #ifdef USE_EDITLINE
+	if (!cmd.length()) return false;
+	add_history(cmd.c_str()); // TODO (leaks memory...) but why
+	write_history("otcli-history.txt"); // Save new history line to file
+	if (gReadlineHandlerJobs) return gReadlineHandlerJobs->RunForeground(cmd); // keep order with background jobs
+	return _Execute(cmd);
+//else
+//    return true;
+#endif
+}
+
+bool cInteractiveShell::_Execute(const string cmd) {
+	_stats_scope("shell::execute");
 	bool all_ok=false;
 	if (cmd.length()) {
-		add_history(cmd.c_str()); // TODO (leaks memory...) but why
-		write_history("otcli-history.txt"); // Save new history line to file
 		try {
 			_dbg1("Processing command");
 			int offset = 0;
 			string cmd_ = nUtils::SpecialFromEscape(cmd,offset);
+			auto api_lock = LockHintApi();
 			auto processing = gReadlineHandleParser->StartProcessing(cmd_, gReadlineHandlerUseOT); // <---
 			_info("Executing command");
 			processing.UseExecute(); // <--- ***
@@ -321,11 +354,9 @@ bool cInteractiveShell::Execute(const string cmd) {
 		catch (const std::exception &e) {
 			cerr<<"ERROR: Could not execute your command ("<<cmd<<") - it triggered internal error: " << e.what() << endl;
 		}
+		if (gReadlineHandlerPrefetcher) gReadlineHandlerPrefetcher->Invalidate(); // command could change the wallet
 	} // length
 	return all_ok;
-//else
-//    return true;
-#endif
 }
 
 void cInteractiveShell::_CompleteOnce(const string line, shared_ptr<nUse::cUseOT> use) { // used with bash autocompletion
@@ -437,10 +468,13 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 			_fact("daemon()");
 			int daemon_err = daemon(1,1); // ***
 			if (daemon_err)  { const string ERR="Daemon failed"; _erro(ERR); throw std::runtime_error(ERR); }
+			nUtils::gTrace.Forked("daemon"); // parent writes its own trace file
+			nUtils::cTrace::CatchTerminate(); // so it is written also when the daemon is killed
 			_fact("daemon() done");
 
 			// preparing OT variables etc:
 			auto useOT = std::make_shared<nUse::cUseOT>("Daemon-Completion");
+			useOT->WatchWallet(); // daemon lives long - refresh its cache on wallet changes, not on each TAB
 			auto parser = make_shared<nNewcli::cCmdParser>();
 			gReadlineHandleParser = parser;
 			gReadlineHandlerUseOT = useOT;
@@ -452,10 +486,14 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 			_note("Will create the pipe (fifo) to listen on, as " << pipe_name);
 			mkfifo(pipe_name.c_str(), 0600);
 			_dbg1("Will open the pipe to listen on, as " << pipe_name);
-			FILE * pipe_file = fopen( pipe_name.c_str() , "r");
+			// read+write: we are also a writer, so fgets blocks waiting for next client instead of returning EOF (and sleeping)
+			int pipe_fd = open( pipe_name.c_str() , O_RDWR );
+			FILE * pipe_file = (pipe_fd < 0) ? NULL : fdopen( pipe_fd , "r");
 			if (pipe_file == NULL) { const string ERR="Pipe failed"; _erro(ERR); throw std::runtime_error(ERR); }
 			_dbg1("Pipe opened, on pipe_file="<<(void*)pipe_file);
 
+			cCompletionCache completion_cache; // "ot msg send al" then "ali" - narrow the previous answer
+
 			bool finished=false;
 			while (!finished) { // read all requests in loop
 				_dbg1("Reading from pipe");
@@ -469,8 +507,10 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 				long int cycle=0;
 				do {
 					++cycle;
+					if (nUtils::cTrace::TerminateRequested()) break;
 					char * read_status = fgets( buff , buff_size , pipe_file );
 					if (read_status == NULL) {
+						clearerr(pipe_file); // (EINTR)
 						auto sleep_add = sleep_inc;
 						if (sleep_size>sleep_limit1) sleep_add = sleep_inc * sleep_eff1;
 						if (sleep_size>sleep_limit2) sleep_add = sleep_inc * sleep_eff2;
@@ -480,6 +520,7 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 						std::this_thread::sleep_for(std::chrono::milliseconds( (int)sleep_size ));
 					} else read_something=true;
 				} while (!read_something);
+				if (!read_something) { _fact("Terminated by signal"); finished=true; continue; }
 				string pipe_command( buff );
 
 				bool found_nl=false;
@@ -504,6 +545,7 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 				const string request_output_name_with_flag = request_output_name + ".ready";
 
 				_note("Daemon: got request: " << request_command<<";"<<request_output_name<<";"<<request_data<<";");
+				_stats_scope("daemon::request");
 
 				// *** work on the REQUEST here:
 
@@ -512,12 +554,21 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 					const string & line = request_data;
 
 					vector <string> completions;
-					auto processing = gReadlineHandleParser->StartProcessing(line, gReadlineHandlerUseOT);
-					completions = processing.UseComplete( line.size() ); // Function gets line before cursor, so we need to complete from the end
-					_info("Daemon: I generated completions: " << DbgVector(completions));
+					uint64_t wallet_generation = 0;
+					const bool reusable = useOT->GetWalletGeneration(wallet_generation) // read before computing, so a change during it is not missed
+						&& !gRunOptions.getFuzzyCompletion(); // fuzzy matches are not a prefix filter of the previous ones
+					if (reusable && completion_cache.Narrow(line, wallet_generation, completions)) {
+						_info("Daemon: I reused completions: " << DbgVector(completions));
+					} else {
+						auto processing = gReadlineHandleParser->StartProcessing(line, gReadlineHandlerUseOT);
+						completions = processing.UseComplete( line.size() ); // Function gets line before cursor, so we need to complete from the end
+						_info("Daemon: I generated completions: " << DbgVector(completions));
+						if (reusable) completion_cache.Remember(line, wallet_generation, completions);
+					}
 
 					// TODO XXX verify if file name begins with safe path intended for OT daemon
 					{
+						_stats_scope("daemon::reply");
 						ofstream reply_file( request_output_name.c_str() );
 						nOT::nUtils::DisplayVectorEndl( reply_file , completions); // write to file
 						reply_file.close();
@@ -536,11 +587,102 @@ void cInteractiveShell::CompleteOnceWithDaemon(const string & line) {
 
 			} // untill finish
 			_mark("DONE reading commands as daemon.");
+			nUtils::gTrace.Flush(); // +trace=<file>
 		} // TODO: resourceLeak;Resource leak: pipe_file
 	}
 #endif
 }
 
+bool cInteractiveShell::RunOnceWithHost(const string & home, const string & line) {
+	cDaemoninfoHost dinfo;
+	if (!dinfo.IsRunning()) return nUtils::reportError("Wallet host is not running (start it with: otx --wallet-host)");
+	if (!nUse::cWalletHost::CheckPrivate(dinfo.GetDir(), true) || !nUse::cWalletHost::CheckPrivate(dinfo.GetPathIn(), false))
+		return nUtils::reportError("Wallet host directory " + dinfo.GetDir() + " is not private to this user - not using it");
+
+	char * real_home = realpath(home.c_str(), NULL); // host runs in other directory
+	if (!real_home) return nUtils::reportError("home", home, "No such wallet home: " + home);
+	const string home_path(real_home);
+	free(real_home);
+
+	dinfo.CreateOut();
+	const string reply_file_name = dinfo.GetPathOut();
+	const string request_string = "run " + reply_file_name + " " + home_path + " " + line + "\n";
+	// non-blocking: a pipe left by host that is gone has no reader, open fails instead of hanging
+	int pipe_fd = open( dinfo.GetPathIn().c_str() , O_WRONLY | O_NONBLOCK | O_NOFOLLOW );
+	if (pipe_fd < 0) return nUtils::reportError("Wallet host does not read its pipe " + dinfo.GetPathIn());
+	const bool sent = write(pipe_fd, request_string.c_str(), request_string.size()) == (ssize_t)request_string.size(); // one write up to PIPE_BUF is not mixed with other clients
+	close(pipe_fd);
+	if (!sent) return nUtils::reportError("Can not send request to wallet host");
+
+	const int time_max = 120000; // in milliseconds - command can wait for notary
+	int time_waited = 0, wait = 1;
+	while (!dinfo.IsReadyPatchOut()) {
+		if (time_waited > time_max) return nUtils::reportError("Timeout while waiting for wallet host after " + ToStr(time_waited) + " ms");
+		std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+		time_waited += wait;
+		wait = std::min(wait * 2, 50);
+	}
+
+	{
+		ifstream reply_file( reply_file_name );
+		cout << reply_file.rdbuf();
+		cout.flush();
+	}
+	unlink(reply_file_name.c_str());
+	unlink(dinfo.GetPathOutFlag().c_str());
+	return true;
+}
+
+int cInteractiveShell::ServeWallet(const string & home, int requestFd, int doneFd) {
+	gCurrentLogger.setOutStreamFile("wallet-host." + ToStr(getpid()) + ".log");
+	nUtils::gTrace.Forked("wallet-host." + ToStr(getpid()));
+	_fact("=== Wallet host worker for " << home << " ===");
+
+	setenv("HOME", home.c_str(), 1); // OTAPI finds its data folder from HOME - before cUseOT is created
+	auto useOT = std::make_shared<nUse::cUseOT>("Wallet-Host");
+	useOT->WatchWallet(); // worker lives long - other processes can change the wallet
+	auto parser = make_shared<nNewcli::cCmdParser>();
+	gReadlineHandleParser = parser;
+	gReadlineHandlerUseOT = useOT;
+	parser->Init();
+
+	FILE * request_file = fdopen(requestFd, "r");
+	if (!request_file) return 1;
+	const size_t buff_size = 8192;
+	char buff[ buff_size ];
+	while (fgets(buff, buff_size, request_file)) { // until host closes our pipe
+		string request(buff);
+		if (request.size() && (*(request.end()-1) == '\n')) request.erase(request.size()-1);
+		const size_t sep1 = request.find(' ');
+		const size_t sep2 = (sep1 == string::npos) ? string::npos : request.find(' ', sep1+1);
+		if (sep2 == string::npos) { _warn("Invalid request for wallet worker: " << request); continue; }
+		const string reply_name = request.substr(sep1+1, sep2-sep1-1);
+		const string line = request.substr(sep2+1);
+		_note("Worker: running [" << line << "], reply to " << reply_name);
+
+		{ // command output (cout, cerr, and printf of libraries) goes to reply file
+			int reply_fd = nUse::cWalletHost::OpenReply(reply_name); // new file only: never through a planted symlink
+			if (reply_fd >= 0) {
+				cout.flush(); cerr.flush(); fflush(stdout); fflush(stderr);
+				const int saved_out = dup(1), saved_err = dup(2);
+				dup2(reply_fd, 1); dup2(reply_fd, 2); close(reply_fd);
+				_Execute(line);
+				cout.flush(); cerr.flush(); fflush(stdout); fflush(stderr);
+				dup2(saved_out, 1); dup2(saved_err, 2); close(saved_out); close(saved_err);
+			} else _erro("Can not write reply file " << reply_name);
+		}
+		if (!nUse::cWalletHost::MarkReady(reply_name)) _erro("Can not create reply flag of " << reply_name);
+
+		const string done = ToStr(getpid()) + "\n";
+		if (write(doneFd, done.c_str(), done.size()) < 0) _warn("Can not notify wallet host");
+	}
+	fclose(request_file);
+	useOT->CloseApi();
+	nUtils::gTrace.Flush(); // worker ends with _exit
+	_fact("Wallet host worker for " << home << " finished");
+	return 0;
+}
+
 void cInteractiveShell::CompleteOnce(const string line, shared_ptr<nUse::cUseOT> use) { // used with bash autocompletion
 #ifdef USE_EDITLINE
 	try {
@@ -646,9 +788,22 @@ static char* CompletionReadlineWrapper(const char *sofar , int number) {
 	static vector <string> completions;
 	if (number == 0) {
 		if (dbg) _dbg3_c(logname, "Start autocomplete (during first callback, number="<<number<<") of line="<<line);
-		auto processing = gReadlineHandleParser->StartProcessing(line_all, gReadlineHandlerUseOT);
-		completions = processing.UseComplete( rl_point );
-		_note_c(logname,  "TAB-Completion: " << DbgVector(completions) );
+		bool prefetched = (rl_point == rl_end) && gReadlineHandlerPrefetcher
+			&& gReadlineHandlerPrefetcher->TryGet(line, completions); // cursor at end: worker could have guessed this line
+		if (!prefetched) {
+			bool locked;
+			auto api_lock = LockHintApiForTab(locked);
+			if (locked) {
+				auto processing = gReadlineHandleParser->StartProcessing(line_all, gReadlineHandlerUseOT);
+				completions = processing.UseComplete( rl_point );
+			}
+			else {
+				completions.clear(); // background job is using the API; try TAB again when it is done
+				_note_c(logname, "TAB-Completion skipped, background job is running");
+			}
+		}
+		if (gReadlineHandlerPrefetcher && (rl_point == rl_end)) gReadlineHandlerPrefetcher->PredictAfter(line, completions);
+		_note_c(logname,  "TAB-Completion" << (prefetched ? " (prefetched): " : ": ") << DbgVector(completions) );
 		if (dbg) _dbg3_c(logname, "Done autocomplete (during first callback, number="<<number<<"); completions="<<DbgVector(completions));
 	}
 
@@ -673,7 +828,9 @@ char ** completion(const char* text, int start, int end __attribute__((__unused_
 	matches = rl_completion_matches (text, CompletionReadlineWrapper);
 	rl_attempted_completion_function = completion;
 	rl_completer_quote_characters = "\"";
-	if (gReadlineHandleParser->mEnableFilenameCompletion) {
+	bool locked;
+	auto api_lock = LockHintApiForTab(locked); // flag is touched by prefetcher thread too
+	if (locked && gReadlineHandleParser->mEnableFilenameCompletion) {
 		rl_attempted_completion_over = 0;
 		gReadlineHandleParser->mEnableFilenameCompletion = false;
 	}
@@ -707,6 +864,9 @@ void cInteractiveShell::_RunEditline(shared_ptr<nUse::cUseOT> use) {
 	gReadlineHandleParser = parser;
 	gReadlineHandlerUseOT = use;
 	parser->Init();
+	gReadlineHandlerPrefetcher = make_shared<cHintPrefetcher>(parser, use); // starts warming hint data while we show the prompt
+	const size_t jobs_queue_max = cShellJobs::ParseQueueMax(std::getenv("OTX_SHELL_JOBS"), 16);
+	gReadlineHandlerJobs = make_shared<cShellJobs>( [this](const string & cmd) { return _Execute(cmd); } , jobs_queue_max );
 
 	int said_help=0, help_needed=0;
 	const int opt_repeat_help_each_nth_time = 5; // how often to remind user to run ot help on error
@@ -717,6 +877,7 @@ void cInteractiveShell::_RunEditline(shared_ptr<nUse::cUseOT> use) {
 
 	while (true) {
 		try {
+			gReadlineHandlerJobs->DisplayFinished(cout);
 			_dbg2("Waiting for user input via readline (time "<<time(NULL)<<")");
 			buf  = readline("ot command> "); // <=== READLINE
 			_dbg3("Readline returned");
@@ -738,6 +899,28 @@ void cInteractiveShell::_RunEditline(shared_ptr<nUse::cUseOT> use) {
 			if (cmd_trim=="quit") break;
 			if (cmd_trim=="q") break;
 
+			// job control builtins
+			if (cmd_trim=="jobs") { gReadlineHandlerJobs->DisplayJobs(cout); continue; }
+			if ((cmd_trim=="wait") || (cmd_trim.substr(0,5)=="wait ")) {
+				string job = cmd_trim.substr(4);
+				nOT::nUtils::trim(job);
+				if ((job.find_first_not_of("0123456789") != string::npos) || (job.size() > 9)) { nUtils::reportError(job, "bad job number", "Not a job number: " + job); continue; }
+				const int id = job.size() ? std::stoi(job) : -1; // (9 digits fit)
+				gReadlineHandlerJobs->Wait(id); // failed jobs are reported below, as finished ones
+				continue;
+			}
+			const size_t cmd_size = cmd_trim.size();
+			if ((cmd_size > 1) && (cmd_trim[cmd_size-1] == '&') && std::isspace(static_cast<unsigned char>(cmd_trim[cmd_size-2]))) { // "ot nym register alice &" - but not "ot msg send alice bob rock&"
+				add_history(cmd.c_str());
+				write_history("otcli-history.txt");
+				string cmd_bg = cmd_trim.substr(0, cmd_trim.size()-1);
+				nOT::nUtils::trim(cmd_bg);
+				int id = gReadlineHandlerJobs->Submit(cmd_bg);
+				if (id == -1) cerr << "Too many background jobs, wait for some of them (see: jobs, wait)" << endl;
+				else cout << "[" << id << "] " << cmd_bg << endl;
+				continue;
+			}
+
 			bool all_ok = Execute(cmd); // <---
 
 		} // try an editline turn
@@ -752,6 +935,13 @@ void cInteractiveShell::_RunEditline(shared_ptr<nUse::cUseOT> use) {
 	if (buf) { free(buf); buf=NULL; }
 	clear_history(); // http://cnswww.cns.cwru.edu/php/chet/readline/history.html#IDX11
 
+	if (gReadlineHandlerJobs->IsBusy()) {
+		cout << "Waiting for background jobs to finish..." << endl;
+		gReadlineHandlerJobs->Wait();
+		gReadlineHandlerJobs->DisplayFinished(cout);
+	}
+	gReadlineHandlerJobs.reset();
+	gReadlineHandlerPrefetcher.reset(); // joins the worker, before we close the API it uses
 	gReadlineHandlerUseOT->CloseApi(); // Close OT_API at the end of shell runtime
 #endif
 }
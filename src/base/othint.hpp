@@ -25,7 +25,8 @@ class cInteractiveShell {
 		void _RunOnce(const string line, shared_ptr<nUse::cUseOT> use);
 		void _CompleteOnce(const string line, shared_ptr<nUse::cUseOT> use);
 
-		bool Execute(const string cmd);
+		bool Execute(const string cmd); ///< adds to history, then runs the command (on the jobs executor if there is one)
+		bool _Execute(const string cmd); ///< runs the command here, on calling thread
 	public:
 		cInteractiveShell();
 		void RunOnce(const string line, shared_ptr<nUse::cUseOT> use);
@@ -34,6 +35,9 @@ class cInteractiveShell {
 
 		void CompleteOnceWithDaemon(const string & line);
 
+		bool RunOnceWithHost(const string & home, const string & line); ///< runs command in wallet host session of home, prints its output
+		int ServeWallet(const string & home, int requestFd, int doneFd); ///< worker of wallet host (in forked process), @see nUse::cWalletHost
+
 	protected:
 		bool dbg;
 };
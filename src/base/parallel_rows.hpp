@@ -0,0 +1,79 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Decoding rows of a table (e.g. transactions of a ledger) on many threads, result kept in index order
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_parallel_rows
+#define INCLUDE_OT_NEWCLI_parallel_rows
+
+#include "lib_common1.hpp"
+#include "otapi_threads.hpp"
+
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <exception>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+/**
+Calls decode(i) for i in 0..count-1 and returns the results in order of i.
+Threads take next free index from shared counter, so a slow row does not hold back the others
+(same effect as work stealing, for equal-cost tasks this simple).
+threads=0 means all cores. Small inputs, or threads==1, are decoded on calling thread.
+First exception thrown by decode is rethrown here (after all threads finished).
+*/
+template <class tRow>
+vector<tRow> DecodeRowsParallel(size_t count, function<tRow(size_t)> decode, size_t threads=0) {
+	const size_t min_parallel_count = 8; // below that starting threads costs more than it saves
+	if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::min(threads, count);
+
+	vector<tRow> rows(count);
+	if ((threads <= 1) || (count < min_parallel_count)) {
+		for (size_t i=0; i<count; ++i) rows[i] = decode(i);
+		return rows;
+	}
+
+	std::atomic<size_t> next(0);
+	std::exception_ptr error;
+	std::mutex error_mutex;
+	auto work = [&]() {
+		for (size_t i = next++; i < count; i = next++) {
+			try {
+				rows[i] = decode(i); // each thread writes only its own rows
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(error_mutex);
+				if (!error) error = std::current_exception();
+				next = count; // stop others
+			}
+		}
+	};
+
+	vector<std::thread> pool;
+	for (size_t t=1; t<threads; ++t) pool.emplace_back(work);
+	work(); // calling thread works too
+	for (auto & thread : pool) thread.join();
+
+	if (error) std::rethrow_exception(error);
+	return rows;
+}
+
+/// As DecodeRowsParallel, but parallel only when the OTAPI backend is declared thread safe (CFG_OTAPI_DECODE_THREADSAFE).
+/// Only decoding calls on the given text go in decode; calls that read the wallet or a ledger (Ledger_*, FormatAmount, names)
+/// are done in a sequential pass before or after it.
+template <class tRow>
+vector<tRow> DecodeOTRows(size_t count, function<tRow(size_t)> decode) {
+	return DecodeRowsParallel<tRow>(count, decode, CFG_OTAPI_DECODE_THREADSAFE ? 0 : 1);
+}
+
+} // namespace nUtils
+} // namespace nOT
+
+
+
+#endif
+
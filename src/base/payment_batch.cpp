@@ -0,0 +1,137 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "payment_batch.hpp"
+
+#include "lib_common2.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+vector<string> cPaymentBatch::SplitCsvLine(const string & line) {
+	vector<string> fields(1);
+	bool quoted = false;
+	for (size_t i=0; i<line.size(); ++i) {
+		const char c = line[i];
+		if (quoted) {
+			if (c != '"') fields.back() += c;
+			else if ((i+1 < line.size()) && (line[i+1] == '"')) { fields.back() += '"'; ++i; }
+			else quoted = false;
+		}
+		else if (c == '"') quoted = true;
+		else if (c == ',') fields.push_back("");
+		else if (c != '\r') fields.back() += c;
+	}
+	for (auto & field : fields) nUtils::trim(field);
+	return fields;
+}
+
+string cPaymentBatch::CsvField(const string & field) {
+	if (field.find_first_of(",\"\n") == string::npos) return field;
+	string ret = "\"";
+	for (char c : field) { if (c == '"') ret += '"'; ret += c; }
+	return ret + "\"";
+}
+
+bool cPaymentBatch::Load(const string & csvFile) {
+	std::ifstream file(nUtils::cFilesystemUtils::TildeToHome(csvFile));
+	if (!file.good()) return nUtils::reportError(csvFile, "can not open", "Can not open CSV file " + csvFile);
+
+	mItems.clear();
+	bool ok = true;
+	string line;
+	for (size_t nr = 1; std::getline(file, line); ++nr) {
+		string trimmed = line;
+		nUtils::trim(trimmed);
+		if (trimmed.empty() || (trimmed.at(0) == '#')) continue;
+
+		auto fields = SplitCsvLine(line);
+		int64_t amount = 0;
+		bool amountOk = (fields.size() >= 2) && !fields.at(1).empty();
+		try {
+			size_t parsed = 0;
+			if (amountOk) amount = std::stoll(fields.at(1), &parsed);
+			amountOk = amountOk && (parsed == fields.at(1).size());
+		} catch(...) { amountOk = false; }
+
+		if (!amountOk && mItems.empty() && (nr == 1)) { _dbg2("Skipping CSV header: " << line); continue; }
+		if (!amountOk || (amount < 1) || fields.at(0).empty() || (fields.size() > 3)) {
+			ok = nUtils::reportError(line, "bad CSV line", csvFile + ":" + ToStr(nr) + ": expected: recipient,amount[,memo] with amount > 0");
+			continue; // report all wrong lines at once
+		}
+		mItems.push_back( cBatchItem{ nr, fields.at(0), amount, (fields.size() > 2) ? fields.at(2) : "" } );
+	}
+	_info("Loaded " << mItems.size() << " payments from " << csvFile);
+	return ok;
+}
+
+int64_t cPaymentBatch::GetTotal() const {
+	int64_t total = 0;
+	for (const auto & item : mItems) total += item.mAmount;
+	return total;
+}
+
+int cPaymentBatch::CreateFile(const string & file) const {
+	return ::open(file.c_str(), O_WRONLY | O_CREAT | (mOverwrite ? O_TRUNC : O_EXCL), 0600);
+}
+
+bool cPaymentBatch::OpenManifest(const string & file, const string & kind, bool overwrite) {
+	mManifestFile = nUtils::cFilesystemUtils::TildeToHome(file);
+	mOverwrite = overwrite;
+	if (!kind.empty() && !overwrite) { // checked before anything is issued, not when the instrument is already written
+		for (const auto & item : mItems) {
+			const string instrumentFile = InstrumentFile(item, kind);
+			if (std::ifstream(instrumentFile).good())
+				return nUtils::reportError(instrumentFile, "file exists", "File " + instrumentFile + " exists (from an earlier batch?), move it away or use --overwrite");
+		}
+	}
+	const int fd = CreateFile(mManifestFile);
+	if (fd < 0) {
+		if (errno == EEXIST) return nUtils::reportError(file, "file exists", "Manifest " + file + " exists (from an earlier batch?), move it away or use --overwrite");
+		return nUtils::reportError(file, "can not write", "Can not write manifest " + file + ": " + std::strerror(errno));
+	}
+	::close(fd); // created (and emptied if overwrite) - the stream writes into it
+	mManifest.open(mManifestFile, std::ios::app);
+	if (!mManifest.good()) return nUtils::reportError(file, "can not write", "Can not write manifest " + file);
+	mManifest << "line,recipient,recipient_id,amount,status,transaction,detail,file" << endl;
+	return true;
+}
+
+void cPaymentBatch::Record(const cBatchItem & item, const string & recipientID, bool ok, int64_t transaction, const string & detail, const string & file) {
+	if (ok) ++mIssued; else ++mFailed;
+	mManifest << item.mLine << ',' << CsvField(item.mRecipient) << ',' << recipientID << ',' << item.mAmount << ','
+		<< (ok ? "issued" : "failed") << ',' << (ok ? ToStr(transaction) : "") << ',' << CsvField(detail) << ',' << CsvField(file) << endl; // endl: flush each item
+}
+
+string cPaymentBatch::InstrumentFile(const cBatchItem & item, const string & kind) const {
+	string base = mManifestFile;
+	if (nUtils::CheckIfEnds(".csv", base)) base.erase(base.size() - 4);
+	return base + "." + ToStr(item.mLine) + "." + kind;
+}
+
+string cPaymentBatch::SaveInstrument(const cBatchItem & item, const string & kind, const string & text) const {
+	const string file = InstrumentFile(item, kind);
+	const int fd = CreateFile(file);
+	if (fd < 0) { _erro("Can not create " << kind << " file " << file << ": " << std::strerror(errno)); return ""; }
+	size_t written = 0;
+	while (written < text.size()) {
+		const ssize_t n = ::write(fd, text.data() + written, text.size() - written);
+		if ((n < 0) && (errno == EINTR)) continue;
+		if (n <= 0) break;
+		written += n;
+	}
+	const bool closed = (::close(fd) == 0);
+	if ((written < text.size()) || !closed) { _erro("Can not write " << kind << " to " << file); return ""; }
+	return file;
+}
+
+} // namespace nUse
+} // namespace nOT
+
@@ -0,0 +1,69 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Batch of payments (cheques, vouchers) read from CSV, and the manifest with result of each one
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_payment_batch
+#define INCLUDE_OT_NEWCLI_payment_batch
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+struct cBatchItem {
+	size_t mLine; ///< line in CSV file (from 1), identifies item in manifest
+	string mRecipient; ///< nym name or ID, as written in CSV
+	int64_t mAmount;
+	string mMemo;
+};
+
+/**
+CSV input: one payment per line: recipient,amount[,memo]
+Empty lines and lines starting with # are skipped, first line is skipped if its amount is not a number (header).
+Fields may be quoted with " (and "" inside quotes), as spreadsheets write them.
+
+Manifest output (CSV): line,recipient,recipient_id,amount,status,transaction,detail,file
+Each item is written (and flushed) as soon as it is done, so after interrupted batch the manifest tells what was issued.
+Instruments that exist only locally (cheques) are saved each to own file next to the manifest, named in column file.
+Files of an earlier run are never overwritten (their cheques would be lost, with numbers already used), unless asked to.
+*/
+class cPaymentBatch { MAKE_CLASS_NAME("cPaymentBatch");
+	public:
+		bool Load(const string & csvFile); ///< false (and errors reported) if any line is wrong - then nothing should be issued
+
+		const vector<cBatchItem> & GetItems() const { return mItems; }
+		int64_t GetTotal() const; ///< sum of all amounts
+
+		/// creates the manifest; fails if it, or a file for instrument kind ("" if none is saved) of any item, exists - unless overwrite
+		bool OpenManifest(const string & file, const string & kind, bool overwrite);
+		void Record(const cBatchItem & item, const string & recipientID, bool ok, int64_t transaction, const string & detail, const string & file = "");
+		/// writes instrument of item to InstrumentFile(), returns the file name ("" if it can not be written, or exists)
+		string SaveInstrument(const cBatchItem & item, const string & kind, const string & text) const;
+		string InstrumentFile(const cBatchItem & item, const string & kind) const; ///< <manifest without .csv>.<line>.<kind>
+
+		size_t GetIssued() const { return mIssued; }
+		size_t GetFailed() const { return mFailed; }
+
+		static vector<string> SplitCsvLine(const string & line);
+		static string CsvField(const string & field); ///< quoted if needed
+
+	protected:
+		vector<cBatchItem> mItems;
+		std::ofstream mManifest;
+		string mManifestFile;
+		bool mOverwrite = false;
+		size_t mIssued = 0, mFailed = 0;
+
+		int CreateFile(const string & file) const; ///< fd for writing (O_EXCL unless mOverwrite), -1 if it can not be created
+};
+
+} // namespace nUse
+} // namespace nOT
+
+
+
+#endif
+
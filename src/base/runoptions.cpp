@@ -4,6 +4,7 @@
 #include "runoptions.hpp"
 
 #include "lib_common1.hpp"
+#include "stats.hpp"
 
 namespace nOT {
 
@@ -17,7 +18,7 @@ INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
 
 cRunOptions::cRunOptions()
 	: mRunMode(eRunModeCurrent), mDebug(false), mDebugSendToFile(false), mDebugSendToCerr(false)
-	,mDoRunDebugshow(false)
+	,mDoRunDebugshow(false), mFuzzyCompletion(false)
 { }
 
 vector<string> cRunOptions::ExecuteRunoptionsAndRemoveThem(const vector<string> & args) {
@@ -48,6 +49,16 @@ void cRunOptions::Exec(const string & runoption) { // eg: Exec("+debug");
 	else if (runoption == "+normal") { mRunMode=eRunModeNormal; }
 	else if (runoption == "+current") { mRunMode=eRunModeCurrent; }
 	else if (runoption == "+debugshow") { mDebug=true;  mDebugSendToCerr=true;  mDoRunDebugshow=true; }
+	else if (runoption == "+fuzzy") { mFuzzyCompletion=true; }
+	else if (runoption == "+stats") { nUtils::gStats.Enable(false); }
+	else if (runoption == "+stats=json") { nUtils::gStats.Enable(true); }
+	else if (runoption.compare(0, 7, "+trace=") == 0) { nUtils::gTrace.Enable(runoption.substr(7)); } // +trace=<file>
+	else if (runoption.compare(0, 14, "+debugchannel=") == 0) { // +debugchannel=<channel>:<level>
+		const string value = runoption.substr(14);
+		const size_t colon = value.rfind(':');
+		if ((colon == string::npos) || (colon == 0)) throw std::runtime_error("Use +debugchannel=<channel>:<level>");
+		mDebugChannelLevels.push_back( std::make_pair(value.substr(0, colon), std::stoi(value.substr(colon+1))) );
+	}
 	else {
 		cerr << "Unknown runoption in Exec: '" << runoption << "'" << endl;
 		throw std::runtime_error("Unknown runoption");
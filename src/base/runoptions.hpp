@@ -32,12 +32,18 @@ class cRunOptions {
 
 		bool mDoRunDebugshow;
 
+		vector<std::pair<string, int>> mDebugChannelLevels; // Eg: +debugchannel=cmd:20 (level of one debug channel)
+
+		bool mFuzzyCompletion; // Eg: +fuzzy - completion accepts typos in names (ranked after exact matches)
+
 	public:
 		tRunMode getTRunMode() const { return mRunMode; }
 		bool getDebug() const { return mDebug; }
 		bool getDebugSendToFile() const { return mDebugSendToFile; }
 		bool getDebugSendToCerr() const { return mDebugSendToCerr; }
 		bool getDoRunDebugshow() const { return mDoRunDebugshow; }
+		const vector<std::pair<string, int>> & getDebugChannelLevels() const { return mDebugChannelLevels; }
+		bool getFuzzyCompletion() const { return mFuzzyCompletion; }
 
 		cRunOptions();
 
@@ -0,0 +1,189 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "shell_jobs.hpp"
+
+#include "lib_common2.hpp"
+#include "trace.hpp"
+
+namespace nOT {
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+thread_local std::ostream * cShellJobs::cThreadCapture::mCapture = nullptr;
+
+int cShellJobs::cThreadCapture::overflow(int c) {
+	if (c == traits_type::eof()) return traits_type::not_eof(c);
+	if (mCapture) { mCapture->put(traits_type::to_char_type(c)); return c; }
+	return mOriginal->sputc(traits_type::to_char_type(c));
+}
+
+std::streamsize cShellJobs::cThreadCapture::xsputn(const char * s, std::streamsize n) {
+	if (mCapture) { mCapture->write(s, n); return n; }
+	return mOriginal->sputn(s, n);
+}
+
+int cShellJobs::cThreadCapture::sync() {
+	return mCapture ? 0 : mOriginal->pubsync();
+}
+
+cShellJobs::cShellJobs(tRunner runner, size_t queueMax)
+: mRunner(runner), mQueueMax(queueMax), mLastId(0), mFinish(false)
+, mCaptureOut(cout.rdbuf()), mCaptureErr(cerr.rdbuf())
+{
+	cout.rdbuf(&mCaptureOut);
+	cerr.rdbuf(&mCaptureErr);
+	mThread = std::thread( [this]() { Worker(); } );
+}
+
+cShellJobs::~cShellJobs() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mFinish = true;
+		if (mQueue.size()) _warn("Dropping " << mQueue.size() << " not started job(s)");
+	}
+	mCond.notify_all();
+	if (mThread.joinable()) mThread.join(); // the running job (if any) is not interrupted
+	cout.rdbuf(mCaptureOut.GetOriginal());
+	cerr.rdbuf(mCaptureErr.GetOriginal());
+}
+
+size_t cShellJobs::ParseQueueMax(const char * value, size_t def) {
+	if (!value) return def;
+	const string text(value);
+	if (text.empty() || (text.size() > 6) || (text.find_first_not_of("0123456789") != string::npos) || (std::stoul(text) < 1)) {
+		_warn("Bad count of background jobs [" << text << "], expected a number from 1, using " << def);
+		return def;
+	}
+	return std::stoul(text);
+}
+
+string cShellJobs::StateName(eState state) {
+	switch (state) {
+		case eState::queued: return "Queued";
+		case eState::running: return "Running";
+		case eState::done: return "Done";
+		case eState::failed: return "Failed";
+	}
+	return "?";
+}
+
+int cShellJobs::_Queue(const string & cmd, bool background) {
+	const int id = ++mLastId;
+	mJobs[id] = cJob{ id, cmd, eState::queued, background, "" };
+	mQueue.push_back(id);
+	mCond.notify_all();
+	return id;
+}
+
+int cShellJobs::Submit(const string & cmd) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mQueue.size() >= mQueueMax) {
+		_warn("Job queue is full (" << mQueue.size() << "), not queuing: " << cmd);
+		return -1;
+	}
+	const int id = _Queue(cmd, true);
+	_info("Queued background job " << id << ": " << cmd);
+	return id;
+}
+
+bool cShellJobs::RunForeground(const string & cmd) {
+	std::unique_lock<std::mutex> lock(mMutex);
+	const int id = _Queue(cmd, false); // foreground does not count to the limit, user waits for it anyway
+	mCond.wait(lock, [this, id]() { auto state = mJobs.at(id).mState; return state == eState::done || state == eState::failed; } );
+	const bool ok = mJobs.at(id).mState == eState::done;
+	mJobs.erase(id);
+	return ok;
+}
+
+bool cShellJobs::Wait(int id) {
+	std::unique_lock<std::mutex> lock(mMutex);
+	if ((id != -1) && !mJobs.count(id)) return nUtils::reportError(ToStr(id), "unknown job", "No such job: " + ToStr(id)); // (or already reported)
+	auto finished = [this, id]() -> bool {
+		for (const auto & job : mJobs) {
+			if ((id != -1) && (job.first != id)) continue;
+			if ((job.second.mState == eState::queued) || (job.second.mState == eState::running)) return false;
+		}
+		return true;
+	};
+	mCond.wait(lock, finished);
+	for (const auto & job : mJobs) {
+		if ((id != -1) && (job.first != id)) continue;
+		if (job.second.mState == eState::failed) return false;
+	}
+	return true;
+}
+
+bool cShellJobs::IsBusy() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (const auto & job : mJobs) {
+		if ((job.second.mState == eState::queued) || (job.second.mState == eState::running)) return true;
+	}
+	return false;
+}
+
+void cShellJobs::DisplayJobs(ostream & out) const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mJobs.empty()) { out << "No jobs" << endl; return; }
+	for (const auto & job : mJobs) {
+		out << "[" << job.first << "]  " << std::setw(8) << std::left << StateName(job.second.mState) << std::right
+			<< "  " << job.second.mCmd << endl;
+	}
+}
+
+void cShellJobs::DisplayFinished(ostream & out) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	for (auto it = mJobs.begin(); it != mJobs.end(); ) {
+		const cJob & job = it->second;
+		if (job.mBackground && ((job.mState == eState::done) || (job.mState == eState::failed))) {
+			out << "[" << job.mId << "]  " << StateName(job.mState) << "  " << job.mCmd << endl;
+			out << job.mOutput;
+			if (job.mOutput.size() && (*job.mOutput.rbegin() != '\n')) out << endl;
+			it = mJobs.erase(it);
+		}
+		else ++it;
+	}
+}
+
+void cShellJobs::Worker() {
+	_dbg1("Job executor started");
+	nUtils::gTrace.SetThreadName("shell-jobs");
+	while (true) {
+		int id = 0;
+		string cmd;
+		bool background = false;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCond.wait(lock, [this]() { return mFinish || !mQueue.empty(); } );
+			if (mFinish) break;
+			id = mQueue.front(); mQueue.pop_front();
+			mJobs.at(id).mState = eState::running;
+			cmd = mJobs.at(id).mCmd;
+			background = mJobs.at(id).mBackground;
+		}
+
+		_info("Running job " << id << ": " << cmd);
+		bool ok = false;
+		std::ostringstream output;
+		if (background) cThreadCapture::Capture(&output); // foreground job: the prompt waits, so it prints directly
+		try {
+			ok = mRunner(cmd); // <--- ***
+		} catch (const std::exception &e) {
+			_erro("Job " << id << " (" << cmd << ") failed with exception: " << e.what());
+		}
+		cThreadCapture::Capture(nullptr);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJobs.at(id).mState = ok ? eState::done : eState::failed;
+			mJobs.at(id).mOutput = output.str();
+		}
+		mCond.notify_all();
+	}
+	_dbg1("Job executor finished");
+}
+
+} // namespace nOTHint
+} // namespace nOT
+
@@ -0,0 +1,101 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Jobs of the interactive shell: commands executed in order on one executor thread, optionally in background ("cmd &")
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_shell_jobs
+#define INCLUDE_OT_NEWCLI_shell_jobs
+
+#include "lib_common2.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <streambuf>
+
+namespace nOT {
+namespace nOTHint {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+All commands of the shell are run by the one executor thread (the only thread that executes OT commands),
+so they keep the order in which user entered them.
+Foreground command: the prompt waits for it. Background command: the prompt returns at once,
+the job is reported when done (like in bash: "[1] Done  ot nym register alice").
+Background queue is bounded, so user can not pile up unlimited server operations.
+Output (cout, cerr) of a background job is kept and shown with its report - it would mix with the line being typed.
+*/
+class cShellJobs { MAKE_CLASS_NAME("cShellJobs");
+	public:
+		typedef function<bool(const string &)> tRunner; ///< executes one command, returns was it ok
+
+		enum class eState { queued, running, done, failed };
+
+		struct cJob {
+			int mId;
+			string mCmd;
+			eState mState;
+			bool mBackground;
+			string mOutput; ///< of background job
+		};
+
+		cShellJobs(tRunner runner, size_t queueMax);
+		~cShellJobs();
+
+		int Submit(const string & cmd); ///< queue in background, returns job number or -1 if queue is full
+		bool RunForeground(const string & cmd); ///< queue and wait for it, returns was it ok
+
+		bool Wait(int id=-1); ///< wait for given job or for all when -1; returns false if any of them failed, or there is no such job
+		bool IsBusy() const; ///< are there any queued or running jobs
+
+		void DisplayJobs(ostream & out) const; ///< "jobs" builtin
+		void DisplayFinished(ostream & out); ///< report background jobs finished since last call (and forget them)
+
+		static string StateName(eState state);
+		static size_t ParseQueueMax(const char * value, size_t def); ///< e.g. of OTX_SHELL_JOBS: number >= 1, else warns and gives def
+
+	protected:
+		/// Installed in cout/cerr: writes of a thread that captures go to its buffer, of other threads to the original stream
+		class cThreadCapture : public std::streambuf {
+			public:
+				cThreadCapture(std::streambuf * original) : mOriginal(original) { }
+				std::streambuf * GetOriginal() const { return mOriginal; }
+				static void Capture(std::ostream * out) { mCapture = out; } ///< for this thread, nullptr to stop
+
+			protected:
+				int overflow(int c) override;
+				std::streamsize xsputn(const char * s, std::streamsize n) override;
+				int sync() override;
+
+				std::streambuf * const mOriginal;
+				static thread_local std::ostream * mCapture;
+		};
+
+		void Worker();
+		int _Queue(const string & cmd, bool background); ///< caller holds mMutex
+
+	protected:
+		tRunner mRunner;
+		const size_t mQueueMax;
+
+		mutable std::mutex mMutex;
+		std::condition_variable mCond; ///< signaled on new job, on finished job, on finish
+		map<int, cJob> mJobs; ///< not yet reported jobs, by number
+		std::deque<int> mQueue; ///< numbers of jobs to run
+		int mLastId;
+		bool mFinish;
+
+		cThreadCapture mCaptureOut, mCaptureErr;
+
+		std::thread mThread; // last, so it starts after the fields are constructed
+};
+
+} // namespace nOTHint
+} // namespace nOT
+
+
+
+#endif
+
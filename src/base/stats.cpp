@@ -0,0 +1,136 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "stats.hpp"
+
+#include "lib_common2.hpp"
+#include "bprinter/table_printer.h"
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cStats::cStats()
+: mEnabled(false), mJson(false), mStart(std::chrono::steady_clock::now())
+{ }
+
+void cStats::Enable(bool json) {
+	mEnabled = true;
+	mJson = json;
+	mStart = std::chrono::steady_clock::now();
+}
+
+void cStats::Disable() {
+	mEnabled = false;
+}
+
+string cStats::CallName(const char * prefix, const char * expr) {
+	string name = expr;
+	name = name.substr(0, name.find('('));
+	nUtils::trim(name);
+	return prefix + name;
+}
+
+void cStats::Register(cStatsSite * site) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mSites.push_back(site);
+}
+
+map<string, cStats::cEntry> cStats::Entries() const {
+	std::lock_guard<std::mutex> lock(mMutex);
+	map<string, cEntry> entries;
+	for (const cStatsSite * site : mSites) {
+		if (!site->mCalls) continue;
+		cEntry & entry = entries[site->mName];
+		entry.mCalls += site->mCalls;
+		entry.mNs += site->mNs;
+		entry.mMaxNs = std::max<uint64_t>(entry.mMaxNs, site->mMaxNs);
+		entry.mBytes += site->mBytes;
+	}
+	return entries;
+}
+
+cStatsSite::cStatsSite(const char * prefix, const char * expr)
+: mName(cStats::CallName(prefix, expr)), mCategory((*prefix) ? "otapi" : "cli"), mCalls(0), mNs(0), mMaxNs(0), mBytes(0)
+{
+	gStats.Register(this);
+}
+
+void cStatsSite::Add(uint64_t ns, uint64_t bytes) {
+	mCalls += 1;
+	mNs += ns;
+	mBytes += bytes;
+	uint64_t max = mMaxNs;
+	while ((ns > max) && !mMaxNs.compare_exchange_weak(max, ns)) { } // max is reloaded on failure
+}
+
+namespace {
+	vector<std::pair<string, cStats::cEntry>> SortedByTime(const map<string, cStats::cEntry> & entries) {
+		vector<std::pair<string, cStats::cEntry>> sorted(entries.begin(), entries.end());
+		std::stable_sort(sorted.begin(), sorted.end(), [](const std::pair<string, cStats::cEntry> & a, const std::pair<string, cStats::cEntry> & b) {
+			return a.second.mNs > b.second.mNs; } );
+		return sorted;
+	}
+	string Ms(uint64_t ns) {
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(3) << (ns / 1000000.0);
+		return oss.str();
+	}
+}
+
+void cStats::Report(ostream & out) const {
+	const auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+	out << "Stats: run took " << Ms(total) << " ms" << endl;
+	bprinter::TablePrinter tp(&out);
+	tp.AddColumn("Phase / call", 45);
+	tp.AddColumn("Calls", 8);
+	tp.AddColumn("Total ms", 12);
+	tp.AddColumn("Max ms", 10);
+	tp.AddColumn("Bytes", 12);
+	tp.PrintHeader();
+	for (const auto & pair : SortedByTime(Entries())) {
+		const cEntry & e = pair.second;
+		tp << pair.first << ToStr(e.mCalls) << Ms(e.mNs) << Ms(e.mMaxNs) << ToStr(e.mBytes);
+	}
+	tp.PrintFooter();
+}
+
+void cStats::ReportJson(ostream & out) const {
+	const auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+	out << "{\"total_ms\":" << Ms(total) << ",\"calls\":[";
+	bool first = true;
+	for (const auto & pair : SortedByTime(Entries())) {
+		const cEntry & e = pair.second;
+		out << (first ? "" : ",") << "{\"name\":\"" << JsonEscape(pair.first) << "\",\"calls\":" << e.mCalls
+			<< ",\"total_ms\":" << Ms(e.mNs) << ",\"max_ms\":" << Ms(e.mMaxNs) << ",\"bytes\":" << e.mBytes << "}";
+		first = false;
+	}
+	out << "]}" << endl;
+}
+
+void cStats::ReportIfEnabled() const {
+	if (!mEnabled) return;
+	if (mJson) ReportJson(cerr); else Report(cerr);
+}
+
+cStats gStats; // (extern)
+
+cStatsScope::cStatsScope(cStatsSite & site)
+: mSite(site), mBytes(0), mTraceUs(0)
+{
+	if (!Active()) return;
+	mStart = std::chrono::steady_clock::now();
+	if (gTrace.IsEnabled()) mTraceUs = gTrace.NowUs();
+}
+
+cStatsScope::~cStatsScope() {
+	if (!Active()) return;
+	const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mStart).count();
+	if (gStats.IsEnabled()) mSite.Add(ns, mBytes);
+	if (gTrace.IsEnabled()) gTrace.AddSpan(mSite.mName, mSite.mCategory, mTraceUs, ns / 1000);
+}
+
+} // namespace nUtils
+} // namespace nOT
+
@@ -0,0 +1,123 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Performance statistics of the run (+stats): time of command phases, calls and bytes of each OTAPI entry point
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_stats
+#define INCLUDE_OT_NEWCLI_stats
+
+#include "lib_common2.hpp"
+#include "trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+One instrumented place in the code (one expansion of _stats_scope, _otapi, _otme), made once as a static local
+(see _stats_site) - so the name is made and registered in gStats only on first use, and each call just adds
+to the atomic counters of its site, without lock or lookup.
+*/
+class cStatsSite {
+	public:
+		cStatsSite(const char * prefix, const char * expr); ///< registers itself in gStats
+		cStatsSite(const cStatsSite &) = delete;
+		cStatsSite & operator=(const cStatsSite &) = delete;
+
+		void Add(uint64_t ns, uint64_t bytes);
+
+		const string mName; ///< e.g. "OTAPI_Wrap::LoadInbox", see cStats::CallName
+		const char * const mCategory; ///< for trace: "otapi" or "cli"
+		std::atomic<uint64_t> mCalls, mNs, mMaxNs, mBytes;
+};
+
+/**
+Collects: for each name (phase like "cmd::_Parse", or OTAPI entry point like "OTAPI_Wrap::LoadInbox")
+number of calls, total and max wall time, and bytes returned (for calls returning string).
+Counting is done in the sites; the report sums up all sites of the same name (e.g. LoadInbox called from many places).
+When not enabled (the default) each instrumented call costs two bool checks (stats, trace).
+*/
+class cStats { MAKE_CLASS_NAME("cStats");
+	public:
+		struct cEntry {
+			uint64_t mCalls = 0;
+			uint64_t mNs = 0;
+			uint64_t mMaxNs = 0;
+			uint64_t mBytes = 0;
+		};
+
+		cStats();
+
+		void Enable(bool json); ///< call at start (before any threads), from runoptions
+		void Disable(); ///< e.g. tests restoring the state; counters are kept
+		bool IsEnabled() const { return mEnabled; }
+
+		void Register(cStatsSite * site); ///< once per site, sites live to the end of program
+		void Report(ostream & out) const; ///< table, sorted by total time
+		void ReportJson(ostream & out) const; ///< one JSON object
+		void ReportIfEnabled() const; ///< at exit, to cerr (so command output on cout stays clean for scripts)
+
+		static string CallName(const char * prefix, const char * expr); ///< "OTAPI_Wrap::" + "LoadInbox(a,b)" -> "OTAPI_Wrap::LoadInbox"
+
+	protected:
+		map<string, cEntry> Entries() const; ///< sites summed up by name
+
+		bool mEnabled, mJson;
+		std::chrono::steady_clock::time_point mStart;
+		mutable std::mutex mMutex; ///< for mSites only
+		vector<cStatsSite *> mSites;
+};
+
+extern cStats gStats;
+
+/// Measures time from creation to end of scope (when stats or trace are enabled), for gStats and as span for gTrace
+class cStatsScope {
+	public:
+		static bool Active() { return gStats.IsEnabled() || gTrace.IsEnabled(); }
+
+		cStatsScope(cStatsSite & site);
+		~cStatsScope();
+
+		template <class T> T && Result(T && result) { mBytes = BytesOf(result); return std::forward<T>(result); } ///< to count bytes of returned value
+
+	protected:
+		static size_t BytesOf(const string & s) { return s.size(); }
+		template <class T> static size_t BytesOf(const T &) { return 0; }
+
+		cStatsSite & mSite;
+		size_t mBytes;
+		std::chrono::steady_clock::time_point mStart;
+		uint64_t mTraceUs; ///< start, in time of trace
+};
+
+/// Runs call() and records it in site (see macros _otapi / _otme in useot.hpp)
+template <class F>
+auto StatsCall(cStatsSite & site, F call) -> typename std::enable_if<!std::is_void<decltype(call())>::value, decltype(call())>::type {
+	if (!cStatsScope::Active()) return call();
+	cStatsScope scope(site);
+	return scope.Result( call() );
+}
+
+template <class F>
+auto StatsCall(cStatsSite & site, F call) -> typename std::enable_if<std::is_void<decltype(call())>::value>::type {
+	if (!cStatsScope::Active()) { call(); return; }
+	cStatsScope scope(site);
+	call();
+}
+
+} // namespace nUtils
+} // namespace nOT
+
+// The cStatsSite of this place in code: a static local of a lambda, that is unique for each expansion of the macro
+#define _stats_site(PREFIX, EXPR) ([]() -> nOT::nUtils::cStatsSite & { static nOT::nUtils::cStatsSite site(PREFIX, EXPR); return site; }())
+
+// Time of the rest of the current block, as phase NAME (e.g. _stats_scope("cmd::_Parse");)
+#define _stats_scope(NAME) nOT::nUtils::cStatsScope _stats_scope_obj(_stats_site("", NAME))
+
+#endif
+
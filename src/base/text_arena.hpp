@@ -0,0 +1,127 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Non-owning string view, text arena with spans, and small vector with inline storage - for data parsed from one command line
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_text_arena
+#define INCLUDE_OT_NEWCLI_text_arena
+
+#include "lib_common1.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_1 // <=== namespaces
+
+/**
+Pointer + length into text owned by someone else (arena, literal, string); valid as long as that text is.
+Converts to string where a string is needed (OTAPI, most cUseOT methods) - that is where the copy is made.
+*/
+class cStrView {
+	public:
+		cStrView() : mData(""), mSize(0) { }
+		cStrView(const char * text) : mData(text), mSize(std::strlen(text)) { }
+		cStrView(const string & text) : mData(text.data()), mSize(text.size()) { }
+		cStrView(const char * data, size_t size) : mData(data), mSize(size) { }
+
+		const char * data() const { return mData; }
+		size_t size() const { return mSize; }
+		bool empty() const { return mSize == 0; }
+		char operator[](size_t i) const { return mData[i]; }
+		const char * begin() const { return mData; }
+		const char * end() const { return mData + mSize; }
+
+		string str() const { return string(mData, mSize); }
+		operator string() const { return str(); }
+
+		int compare(cStrView other) const {
+			const int cmp = std::memcmp(mData, other.mData, std::min(mSize, other.mSize));
+			if (cmp != 0) return cmp;
+			return (mSize < other.mSize) ? -1 : ((mSize > other.mSize) ? 1 : 0);
+		}
+
+	private:
+		const char * mData;
+		size_t mSize;
+};
+
+inline bool operator==(cStrView a, cStrView b) { return (a.size() == b.size()) && (std::memcmp(a.data(), b.data(), a.size()) == 0); }
+inline bool operator!=(cStrView a, cStrView b) { return !(a == b); }
+inline bool operator<(cStrView a, cStrView b) { return a.compare(b) < 0; }
+inline string operator+(const string & a, cStrView b) { string r(a); r.append(b.data(), b.size()); return r; }
+inline string operator+(cStrView a, const string & b) { string r(a.data(), a.size()); r += b; return r; }
+inline string operator+(const char * a, cStrView b) { string r(a); r.append(b.data(), b.size()); return r; }
+inline string operator+(cStrView a, const char * b) { string r(a.data(), a.size()); r += b; return r; }
+inline ostream & operator<<(ostream & out, cStrView text) { return out.write(text.data(), text.size()); }
+
+/// position of text in cTextArena
+struct cTextSpan {
+	uint32_t mPos;
+	uint32_t mLen;
+};
+
+/**
+One buffer for many short texts. Views from Get() are valid until the next Add() that grows the buffer,
+so Reserve() the whole size first (e.g. size of command line) and Add() only while building.
+*/
+class cTextArena {
+	public:
+		void Reserve(size_t bytes) { mBuffer.reserve(bytes); }
+		cTextSpan Add(cStrView text) {
+			const cTextSpan span = { static_cast<uint32_t>(mBuffer.size()), static_cast<uint32_t>(text.size()) };
+			mBuffer.append(text.data(), text.size());
+			return span;
+		}
+		cStrView Get(cTextSpan span) const { return cStrView(mBuffer.data() + span.mPos, span.mLen); }
+		size_t Size() const { return mBuffer.size(); }
+		void Clear() { mBuffer.clear(); }
+
+	private:
+		string mBuffer;
+};
+
+/**
+Vector of trivially copyable T, first N elements kept inline (no allocation for usual sizes), more go to heap.
+*/
+template <class T, size_t N>
+class cSmallVec {
+	static_assert(std::is_trivially_copyable<T>::value, "cSmallVec is for trivially copyable types");
+	public:
+		cSmallVec() : mSize(0) { }
+
+		size_t size() const { return mSize; }
+		bool empty() const { return mSize == 0; }
+		T * begin() { return Data(); }
+		T * end() { return Data() + mSize; }
+		const T * begin() const { return Data(); }
+		const T * end() const { return Data() + mSize; }
+		T & operator[](size_t i) { return Data()[i]; }
+		const T & operator[](size_t i) const { return Data()[i]; }
+
+		void push_back(const T & value) { insert(mSize, value); }
+		void insert(size_t index, const T & value) {
+			if ((mSize == N) && mHeap.empty()) mHeap.assign(mInline, mInline + N); // spill to heap, once
+			if (!mHeap.empty()) { mHeap.insert(mHeap.begin() + index, value); ++mSize; return; }
+			std::memmove(mInline + index + 1, mInline + index, (mSize - index) * sizeof(T));
+			mInline[index] = value;
+			++mSize;
+		}
+		void clear() { mSize = 0; mHeap.clear(); }
+
+	private:
+		T * Data() { return mHeap.empty() ? mInline : mHeap.data(); }
+		const T * Data() const { return mHeap.empty() ? mInline : mHeap.data(); }
+
+		T mInline[N];
+		vector<T> mHeap;
+		size_t mSize;
+};
+
+} // namespace nUtils
+} // namespace nOT
+
+#endif
+
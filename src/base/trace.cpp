@@ -0,0 +1,136 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "trace.hpp"
+
+#include "lib_common2.hpp"
+
+#include <atomic>
+#include <csignal>
+#ifdef __unix
+	#include <signal.h>
+	#include <unistd.h>
+#endif
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cTrace::cTrace()
+: mEnabled(false), mStart(std::chrono::steady_clock::now()), mWritten(0), mDropped(0)
+{ }
+
+void cTrace::Enable(const string & file) {
+	mEnabled = true;
+	mFile = file;
+	mStart = std::chrono::steady_clock::now();
+	mEvents.reserve(4096);
+}
+
+uint64_t cTrace::NowUs() const {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mStart).count();
+}
+
+int cTrace::ThreadId() {
+	static std::atomic<int> next(1);
+	static thread_local int id = next++;
+	return id;
+}
+
+void cTrace::AddSpan(const string & name, const char * category, uint64_t startUs, uint64_t durationUs) {
+	const int thread = ThreadId();
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (!mEnabled) return; // already flushed
+	mEvents.push_back( cEvent{ name, category, startUs, durationUs, thread } );
+	if (mEvents.size() >= mEventsMax) {
+		const uint64_t start = NowUs();
+		WriteEvents();
+		mEvents.push_back( cEvent{ "trace-write", "trace", start, NowUs() - start, thread } );
+	}
+}
+
+void cTrace::SetThreadName(const string & name) {
+	if (!mEnabled) return;
+	const int thread = ThreadId();
+	std::lock_guard<std::mutex> lock(mMutex);
+	mThreadNames[thread] = name;
+}
+
+void cTrace::Forked(const string & suffix) {
+	if (!mEnabled) return;
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (mOut.is_open()) mOut.close(); // parent's file (nothing is left in the buffer, WriteEvents flushes it)
+	mFile += "." + suffix;
+	mEvents.clear(); // those are written by parent
+	mWritten = 0;
+	mDropped = 0;
+}
+
+void cTrace::WriteEvents() {
+	if (!mOut.is_open()) {
+		mOut.open(mFile, std::ios::trunc);
+		if (!mOut.good()) { _erro("Can not write trace file " << mFile); mDropped += mEvents.size(); mEvents.clear(); return; }
+		mOut << "{\"traceEvents\":[\n";
+	}
+	if (!mOut.good()) { mDropped += mEvents.size(); mEvents.clear(); return; }
+	int pid = 1;
+	#ifdef __unix
+		pid = getpid();
+	#endif
+	for (const auto & event : mEvents) {
+		mOut << (mWritten ? ",\n" : "") << "{\"name\":\"" << JsonEscape(event.mName) << "\",\"cat\":\"" << event.mCategory
+			<< "\",\"ph\":\"X\",\"ts\":" << event.mStartUs << ",\"dur\":" << event.mDurationUs
+			<< ",\"pid\":" << pid << ",\"tid\":" << event.mThread << "}";
+		++mWritten;
+	}
+	mOut.flush(); // so a forked child does not write our buffer again
+	mEvents.clear();
+}
+
+void cTrace::Flush() {
+	if (!mEnabled) return;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mEnabled = false; // once
+	WriteEvents();
+	if (!mOut.is_open()) return;
+	int pid = 1;
+	#ifdef __unix
+		pid = getpid();
+	#endif
+	for (const auto & thread : mThreadNames) { // metadata can be anywhere in the list
+		mOut << (mWritten ? ",\n" : "") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << thread.first
+			<< ",\"args\":{\"name\":\"" << JsonEscape(thread.second) << "\"}}";
+		++mWritten;
+	}
+	mOut << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" << mDropped << "}}\n";
+	mOut.close();
+	_note("Written trace with " << mWritten << " entries to " << mFile);
+}
+
+namespace {
+volatile std::sig_atomic_t gTerminateRequested = 0;
+extern "C" void OnTerminate(int) { gTerminateRequested = 1; }
+} // namespace
+
+void cTrace::CatchTerminate() {
+	#ifdef __unix
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_handler = OnTerminate;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = 0; // no SA_RESTART: fgets, poll and sleep return early
+		sigaction(SIGTERM, &action, nullptr);
+		sigaction(SIGINT, &action, nullptr);
+	#endif
+}
+
+bool cTrace::TerminateRequested() {
+	return gTerminateRequested != 0;
+}
+
+cTrace gTrace; // (extern)
+
+} // namespace nUtils
+} // namespace nOT
+
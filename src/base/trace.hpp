@@ -0,0 +1,74 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Timeline of the run (+trace=<file>): spans of phases and OTAPI calls, as Chrome trace-event JSON (chrome://tracing, Perfetto)
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_trace
+#define INCLUDE_OT_NEWCLI_trace
+
+#include "lib_common2.hpp"
+
+#include <chrono>
+
+namespace nOT {
+namespace nUtils {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Spans are kept in memory and written by Flush() at exit, so tracing does not add file writes inside the measured code -
+except when mEventsMax spans are collected: then they are written out (one pause, shown as span "trace-write").
+Long running processes (completion daemon, wallet host and its workers) call Flush when they finish: on QUIT, or on
+SIGTERM/SIGINT caught by CatchTerminate.
+Spans come from cStatsScope (see stats.hpp) - so every _stats_scope and every _otapi/_otme call is on the timeline.
+*/
+class cTrace { MAKE_CLASS_NAME("cTrace");
+	public:
+		cTrace();
+
+		void Enable(const string & file); ///< call at start (before any threads), from runoptions
+		bool IsEnabled() const { return mEnabled; }
+
+		uint64_t NowUs() const; ///< time since start of trace
+		void AddSpan(const string & name, const char * category, uint64_t startUs, uint64_t durationUs);
+		void SetThreadName(const string & name); ///< name of calling thread, shown in the viewer
+
+		void Forked(const string & suffix); ///< in child process: own file (file.suffix), without parent's spans
+		void Flush(); ///< write the file (once)
+
+		static int ThreadId(); ///< small number, stable for the life of the thread
+
+		/// SIGTERM and SIGINT only set TerminateRequested() and interrupt blocking reads (no SA_RESTART),
+		/// so the loop of a long running process ends normally and can Flush
+		static void CatchTerminate();
+		static bool TerminateRequested();
+
+	protected:
+		void WriteEvents(); ///< appends mEvents to mOut and clears them; under mMutex
+
+		struct cEvent {
+			string mName;
+			const char * mCategory;
+			uint64_t mStartUs, mDurationUs;
+			int mThread;
+		};
+
+		bool mEnabled;
+		string mFile;
+		std::chrono::steady_clock::time_point mStart;
+		std::mutex mMutex;
+		vector<cEvent> mEvents;
+		map<int, string> mThreadNames;
+		std::ofstream mOut; ///< open after the first WriteEvents
+		size_t mWritten; ///< events in mOut
+		size_t mDropped; ///< file could not be written
+		static const size_t mEventsMax = 1000000;
+};
+
+extern cTrace gTrace;
+
+} // namespace nUtils
+} // namespace nOT
+
+#endif
+
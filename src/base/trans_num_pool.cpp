@@ -0,0 +1,57 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "trans_num_pool.hpp"
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cTransNumPool::cTransNumPool(tCounter counter, tFetcher fetcher, int32_t low, int32_t high)
+: mCounter(counter), mFetcher(fetcher), mLow(0), mHigh(1), mFetches(0)
+{
+	SetWatermarks(low, high);
+}
+
+void cTransNumPool::SetWatermarks(int32_t low, int32_t high) {
+	mLow = std::max(low, 0);
+	mHigh = std::max(high, mLow+1);
+	_dbg2("Transaction number pool watermarks: low=" << mLow << " high=" << mHigh);
+}
+
+bool cTransNumPool::Fetch(const string & serverID, const string & nymID, int32_t count) {
+	++mFetches;
+	_info("Getting transaction numbers for nym " << nymID << " on server " << serverID << ", up to " << count);
+	return mFetcher(count, serverID, nymID);
+}
+
+bool cTransNumPool::Acquire(const string & serverID, const string & nymID, int32_t needed) {
+	const int32_t have = mCounter(serverID, nymID);
+	_dbg3("Nym " << nymID << " has " << have << " transaction numbers, needs " << needed);
+	if (have >= needed) {
+		if (have - needed < mLow) mBelowLow.insert( std::make_pair(serverID, nymID) ); // will be used up soon
+		return true;
+	}
+	// must wait for server anyway - so get a whole batch now, not only what is needed
+	if (!Fetch(serverID, nymID, std::max(mHigh, needed))) {
+		// server may give smaller batch than we asked for; enough for this instrument is what matters
+		if (mCounter(serverID, nymID) < needed) return false;
+	}
+	return true;
+}
+
+void cTransNumPool::Replenish() {
+	auto pools = mBelowLow;
+	mBelowLow.clear();
+	for (const auto & pool : pools) {
+		if (mCounter(pool.first, pool.second) >= mLow) continue; // e.g. instrument failed, numbers were not used
+		if (!Fetch(pool.first, pool.second, mHigh)) _warn("Can not top up transaction numbers for nym " << pool.second); // next Acquire will try again
+	}
+}
+
+} // namespace nUse
+} // namespace nOT
+
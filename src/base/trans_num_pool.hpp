@@ -0,0 +1,61 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Pool of transaction numbers per (server, nym), topped up in bulk between low and high watermark
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_trans_num_pool
+#define INCLUDE_OT_NEWCLI_trans_num_pool
+
+#include "lib_common2.hpp"
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Instruments (cheque, voucher, transfer, cash withdraw) each use up transaction numbers that nym must first get from server.
+Asking server for 1 number before every instrument costs round-trip(s) each time. This pool instead:
+- Acquire(): on the critical path, asks server only when nym has fewer numbers than needed - and then gets up to high watermark,
+- Replenish(): tops up (to high watermark) every pool that fell below low watermark. It is not called by the instruments:
+  the shell runs it at idle time (hint prefetch worker, under the API lock). A one-shot CLI run does not (scripts wait
+  for the process to exit) - there the next Acquire that is short gets a whole batch.
+So issuing N instruments costs about N/(high-low) round-trips for numbers, and normally none before the instrument.
+
+The numbers themselves stay in the nym (wallet) - pool only decides when and how many to request.
+Count and fetch are passed as functions (OTAPI calls in cUseOT), so this class does not depend on OTAPI.
+*/
+class cTransNumPool { MAKE_CLASS_NAME("cTransNumPool");
+	public:
+		typedef function<int32_t(const string & serverID, const string & nymID)> tCounter; ///< numbers nym has now
+		typedef function<bool(int32_t count, const string & serverID, const string & nymID)> tFetcher; ///< get from server until nym has count
+
+		cTransNumPool(tCounter counter, tFetcher fetcher, int32_t low=5, int32_t high=20);
+
+		void SetWatermarks(int32_t low, int32_t high); ///< high is raised to at least low+1
+		int32_t GetLow() const { return mLow; }
+		int32_t GetHigh() const { return mHigh; }
+
+		bool Acquire(const string & serverID, const string & nymID, int32_t needed=1); ///< false if numbers can not be got
+		void Replenish(); ///< top up pools that went below low watermark since last call
+		bool HasPending() const { return !mBelowLow.empty(); } ///< Replenish has some work
+
+		size_t GetFetchCount() const { return mFetches; } ///< round-trips made for numbers
+
+	protected:
+		bool Fetch(const string & serverID, const string & nymID, int32_t count);
+
+		tCounter mCounter;
+		tFetcher mFetcher;
+		int32_t mLow, mHigh;
+		set<std::pair<string, string>> mBelowLow; ///< (server, nym) to top up in Replenish
+		size_t mFetches;
+};
+
+} // namespace nUse
+} // namespace nOT
+
+
+
+#endif
+
@@ -2,6 +2,11 @@
 /* See header file .hpp for info */
 
 #include "useot.hpp"
+#include "ledger_mirror.hpp"
+#include "parallel_rows.hpp"
+#include "otapi_threads.hpp"
+#include "file_batch.hpp"
+#include "latency_histogram.hpp"
 
 #include "lib_common3.hpp"
 
@@ -38,6 +43,11 @@ cUseOT::cUseOT(const string &mDbgName)
 , mMadeEasy(new opentxs::OT_ME())
 , mDataFolder( opentxs::OTPaths::AppDataFolder().Get() )
 , mDefaultIDsFile( mDataFolder + "defaults.opt" )
+, mTransNumPool(
+	[] (const string & serverID, const string & nymID) -> int32_t {
+		return _otapi(GetNym_TransactionNumCount(serverID, nymID)); }
+	, [this] (int32_t count, const string & serverID, const string & nymID) -> bool {
+		return _otme(make_sure_enough_trans_nums(count, serverID, nymID)); } )
 {
 	_dbg1("Creating cUseOT "<<DbgName());
 	FPTR fptr;
@@ -50,6 +60,7 @@ cUseOT::cUseOT(const string &mDbgName)
 	subjectGetNameFunc.insert(std::make_pair(nUtils::eSubjectType::Asset, fptr = &cUseOT::AssetGetName) );
 	subjectGetNameFunc.insert(std::make_pair(nUtils::eSubjectType::User, fptr = &cUseOT::NymGetName) );
 	subjectGetNameFunc.insert(std::make_pair(nUtils::eSubjectType::Server, fptr = &cUseOT::ServerGetName) );
+	LoadTransNumPoolConfig();
 }
 
 
@@ -57,29 +68,46 @@ string cUseOT::DbgName() const NOEXCEPT {
 	return "cUseOT-" + ToStr((void*)this) + "-" + mDbgName;
 }
 
+string cUseOT::LedgerMirrorFile(const string & boxName) {
+	string path = mDataFolder + "client_data/" + "ledger_mirror/" + boxName;
+	bool createFolder = true;
+	if (!opentxs::OTPaths::BuildFilePath(path, createFolder)) _warn("Can't create folder for ledger mirror " << path);
+	return path;
+}
+
 void cUseOT::CloseApi() {
 	if (OTAPI_loaded) {
 		_dbg1("Will cleanup OTAPI");
-		opentxs::OTAPI_Wrap::AppCleanup(); // Close OTAPI
+		_otapi(AppCleanup()); // Close OTAPI
 		_dbg2("Will cleanup OTAPI - DONE");
 	} else _dbg3("Will cleanup OTAPI ... was already not loaded");
 }
 
+void cUseOT::TransNumReplenish() {
+	if (!OTAPI_loaded || !mTransNumPool.HasPending()) return;
+	_stats_scope("cUseOT::TransNumReplenish");
+	mTransNumPool.Replenish();
+}
+
+bool cUseOT::TransNumReplenishPending() const {
+	return mTransNumPool.HasPending();
+}
+
 cUseOT::~cUseOT() {
 	delete mMadeEasy;
 }
 
 bool cUseOT::PrintInstrumentInfo(const string &instrument) {
-	const auto txn = opentxs::OTAPI_Wrap::Instrmnt_GetTransNum(instrument);
-	const auto assetID = opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(instrument);
-	const auto serverID = opentxs::OTAPI_Wrap::Instrmnt_GetNotaryID(instrument);
-	const auto senderAccID = opentxs::OTAPI_Wrap::Instrmnt_GetSenderAcctID(instrument);
-	const auto senderNymID = opentxs::OTAPI_Wrap::Instrmnt_GetSenderNymID(instrument);
-	const auto recNymID = opentxs::OTAPI_Wrap::Instrmnt_GetRecipientNymID(instrument);
-	const auto amount = opentxs::OTAPI_Wrap::Instrmnt_GetAmount(instrument);
-	const auto memo = opentxs::OTAPI_Wrap::Instrmnt_GetMemo(instrument);
-	const auto validTo = opentxs::OTAPI_Wrap::Instrmnt_GetValidTo(instrument);
-	const auto type = opentxs::OTAPI_Wrap::Instrmnt_GetType(instrument);
+	const auto txn = _otapi(Instrmnt_GetTransNum(instrument));
+	const auto assetID = _otapi(Instrmnt_GetInstrumentDefinitionID(instrument));
+	const auto serverID = _otapi(Instrmnt_GetNotaryID(instrument));
+	const auto senderAccID = _otapi(Instrmnt_GetSenderAcctID(instrument));
+	const auto senderNymID = _otapi(Instrmnt_GetSenderNymID(instrument));
+	const auto recNymID = _otapi(Instrmnt_GetRecipientNymID(instrument));
+	const auto amount = _otapi(Instrmnt_GetAmount(instrument));
+	const auto memo = _otapi(Instrmnt_GetMemo(instrument));
+	const auto validTo = _otapi(Instrmnt_GetValidTo(instrument));
+	const auto type = _otapi(Instrmnt_GetType(instrument));
 
 	auto col = zkr::cc::fore::cyan;
 	auto col2 = zkr::cc::fore::blue;
@@ -119,10 +147,10 @@ void cUseOT::LoadDefaults() {
 	if ( !configManager.Load(mDefaultIDsFile, mDefaultIDs) ) {
 		_warn("Cannot open " + mDefaultIDsFile + " file, setting IDs with ID 0 as default");
 
-		ID accountID = opentxs::OTAPI_Wrap::GetAccountWallet_ID(0);
-        ID assetID = opentxs::OTAPI_Wrap::GetAssetType_ID(0);
-        ID NymID = opentxs::OTAPI_Wrap::GetNym_ID(0);
-        ID serverID = opentxs::OTAPI_Wrap::GetServer_ID(0);
+		ID accountID = _otapi(GetAccountWallet_ID(0));
+        ID assetID = _otapi(GetAssetType_ID(0));
+        ID NymID = _otapi(GetNym_ID(0));
+        ID serverID = _otapi(GetServer_ID(0));
 
 		if ( accountID.empty() )
 			_warn("There is no accounts in the wallet, can't set default account");
@@ -147,6 +175,18 @@ void cUseOT::LoadDefaults() {
 	}
 }
 
+void cUseOT::LoadTransNumPoolConfig() {
+	map<string, string> config;
+	if (!configManager.Load(mDataFolder + "transnum_pool.opt", config)) return; // defaults of cTransNumPool
+	auto value = [&config](const string & key, int32_t def) -> int32_t {
+		auto found = config.find(key);
+		if (found == config.end()) return def;
+		if (!nUtils::isNumber(found->second, true)) { _warn("Bad " << key << " in transnum_pool.opt: " << found->second); return def; }
+		return std::stoi(found->second);
+	};
+	mTransNumPool.SetWatermarks( value("low", mTransNumPool.GetLow()), value("high", mTransNumPool.GetHigh()) );
+}
+
 bool cUseOT::DisplayDefaultSubject(const nUtils::eSubjectType type, bool dryrun) {
 	_fact("display default " << nUtils::SubjectType2String(type) );
 	if(dryrun) return true;
@@ -240,23 +280,24 @@ bool cUseOT::Refresh(bool dryrun) {
 bool cUseOT::Init() { // TODO init on the beginning of application execution
 	if (mDefaultIDs.empty()) LoadDefaults();
 	if (OTAPI_error) return false;
-	if (OTAPI_loaded) return true;
+	if (OTAPI_loaded) { ApplyWalletChanges(); return true; }
+	_stats_scope("cUseOT::Init"); // only the real loading, not every check
 	try {
-        if (!opentxs::OTAPI_Wrap::AppInit()) { // Init OTAPI
+        if (!_otapi(AppInit())) { // Init OTAPI
 			_erro("Error while initializing wrapper");
 			return false; // <--- RET
 		}
 
 		_info("Trying to load wallet now.");
 		// if not pWrap it means that AppInit is not initialized
-        opentxs::OTAPI_Exec *pWrap = opentxs::OTAPI_Wrap::It(); // TODO check why OTAPI_Exec is needed
+        opentxs::OTAPI_Exec *pWrap = _otapi(It()); // TODO check why OTAPI_Exec is needed
 		if (!pWrap) {
 			OTAPI_error = true;
 			_erro("Error while init OTAPI (1)");
 			return false;
 		}
 
-        if (opentxs::OTAPI_Wrap::LoadWallet()) {
+        if (_otapi(LoadWallet())) {
 			_info("wallet was loaded.");
 			OTAPI_loaded = true;
 			LoadDefaults();
@@ -274,6 +315,36 @@ bool cUseOT::Init() { // TODO init on the beginning of application execution
 	return OTAPI_loaded;
 }
 
+void cUseOT::WatchWallet() {
+	if (!mWalletWatcher) mWalletWatcher.reset( new cWalletWatcher(mDataFolder) );
+}
+
+bool cUseOT::GetWalletGeneration(uint64_t & generation) const {
+	if (!mWalletWatcher || !mWalletWatcher->IsActive()) return false;
+	generation = mWalletWatcher->GetGeneration();
+	return true;
+}
+
+void cUseOT::ApplyWalletChanges() {
+	if (!mWalletWatcher) return;
+	const unsigned changed = mWalletWatcher->TakeChanged();
+	if (!changed) return;
+	_stats_scope("cUseOT::ApplyWalletChanges");
+	_dbg1("Wallet changed (" << cWalletWatcher::SegmentsToStr(changed) << "), dropping cached data");
+
+	unsigned stale = changed;
+	if (changed & cWalletWatcher::eWallet) { // wallet.xml was written (e.g. by other process) - our OTAPI copy is stale
+		if (!_otapi(LoadWallet())) _warn("Can not reload changed wallet");
+		stale |= cWalletWatcher::eNyms | cWalletWatcher::eAccounts | cWalletWatcher::eAssets | cWalletWatcher::eServers; // names are there
+	}
+	if (stale & cWalletWatcher::eNyms) { mCache.mNyms.Clear(); mCache.mNymsLoaded = false; }
+	if (stale & cWalletWatcher::eAccounts) { mCache.mAccounts.Clear(); mCache.mAccountsLoaded = false; }
+	if (stale & cWalletWatcher::eAssets) { mCache.mAssets.Clear(); mCache.mAssetsLoaded = false; mInstrumentCache.ClearContracts(); }
+	if (stale & cWalletWatcher::eServers) { mCache.mServers.Clear(); mCache.mServersLoaded = false; }
+	if (changed & cWalletWatcher::eDefaults) { mDefaultIDs.clear(); LoadDefaults(); }
+	if (changed & cWalletWatcher::eAddressBook) { AddressBookStorage::ForceClear(); AddressBookStorage::Reload(); }
+}
+
 bool cUseOT::CheckIfExists(const nUtils::eSubjectType type, const string & subject) {
 	if (!Init()) return false;
 	if (subject.empty()) {
@@ -300,15 +371,15 @@ vector<ID> cUseOT::AccountGetAllIds() {
 
 	_dbg3("Retrieving accounts ID's");
 	vector<string> accountsIDs;
-	for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetAccountCount ();i++) {
-		accountsIDs.push_back(opentxs::OTAPI_Wrap::GetAccountWallet_ID (i));
+	for(int i = 0 ; i < _otapi(GetAccountCount());i++) {
+		accountsIDs.push_back(_otapi(GetAccountWallet_ID(i)));
 	}
 	return accountsIDs;
 }
 
 ID cUseOT::AccountGetAssetID(const string & account) {
 	auto accID = AccountGetId(account);
-	return (!accID.empty()) ? opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accID) : "";
+	return (!accID.empty()) ? _otapi(GetAccountWallet_InstrumentDefinitionID(accID)) : "";
 }
 
 string cUseOT::AccountGetAsset(const string & account) {
@@ -318,7 +389,7 @@ string cUseOT::AccountGetAsset(const string & account) {
 int64_t cUseOT::AccountGetBalance(const string & accountName) {
 	if(!Init()) return 0; //FIXME
 
-	int64_t balance = opentxs::OTAPI_Wrap::GetAccountWallet_Balance ( AccountGetId(accountName) );
+	int64_t balance = _otapi(GetAccountWallet_Balance( AccountGetId(accountName) ));
 	return balance;
 }
 
@@ -336,9 +407,9 @@ ID cUseOT::AccountGetId(const string & accountName) {
 	if (nUtils::checkPrefix(accountName))
 		return accountName.substr(1);
 	else {
-		for (int i = 0; i < opentxs::OTAPI_Wrap::GetAccountCount(); i++) {
-			if (opentxs::OTAPI_Wrap::GetAccountWallet_Name(opentxs::OTAPI_Wrap::GetAccountWallet_ID(i)) == accountName)
-				return opentxs::OTAPI_Wrap::GetAccountWallet_ID(i);
+		for (int i = 0; i < _otapi(GetAccountCount()); i++) {
+			if (_otapi(GetAccountWallet_Name(_otapi(GetAccountWallet_ID(i)))) == accountName)
+				return _otapi(GetAccountWallet_ID(i));
 		}
 	}
 	return "";
@@ -349,7 +420,7 @@ string cUseOT::AccountGetName(const ID & accountID) {
 		return "";
 	if(accountID.empty())
 		return "";
-	auto account = opentxs::OTAPI_Wrap::GetAccountWallet_Name(accountID);
+	auto account = _otapi(GetAccountWallet_Name(accountID));
 	return (account.empty())? "" : account;
 }
 
@@ -364,13 +435,13 @@ ID cUseOT::AccountGetNymID(const string & account) {
 	if(!Init())
 		return "";
 
-	return opentxs::OTAPI_Wrap::GetAccountWallet_NymID(AccountGetId(account));
+	return _otapi(GetAccountWallet_NymID(AccountGetId(account)));
 }
 
 bool cUseOT::AccountIsOwnerNym(const string & account, const string & nym) {
 	if(!Init())
 		return false;
-	const ID rightNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(AccountGetId(account));
+	const ID rightNymID = _otapi(GetAccountWallet_NymID(AccountGetId(account)));
 	if(nym.empty() || rightNymID.empty()) return false;
 	return rightNymID == NymGetId(nym);
 }
@@ -381,12 +452,12 @@ bool cUseOT::AccountRemove(const string & account, bool dryrun) { ///<
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	if (opentxs::OTAPI_Wrap::Wallet_CanRemoveAccount(AccountGetId(account))) {
+	if (_otapi(Wallet_CanRemoveAccount(AccountGetId(account)))) {
 		return nUtils::reportError("Account cannot be deleted: doesn't have a zero balance?/outstanding receipts?");
 	}
 
-	if (opentxs::OTAPI_Wrap::deleteAssetAccount(mDefaultIDs.at(nUtils::eSubjectType::Server),
-			mDefaultIDs.at(nUtils::eSubjectType::User), AccountGetId(account))) { //FIXME should be
+	if (_otapi(deleteAssetAccount(mDefaultIDs.at(nUtils::eSubjectType::Server),
+			mDefaultIDs.at(nUtils::eSubjectType::User), AccountGetId(account)))) { //FIXME should be
 		return nUtils::reportError("Failure deleting account: " + account);
 	}
 	_info("Account: " + account + " was successfully removed");
@@ -404,7 +475,7 @@ bool cUseOT::AccountRefresh(const string & accountName, bool all, bool dryrun) {
 
 	if (all) {
 		int32_t accountsRetrieved = 0;
-		int32_t accountCount = opentxs::OTAPI_Wrap::GetAccountCount();
+		int32_t accountCount = _otapi(GetAccountCount());
 
 		if (accountCount == 0){
 			_warn("No accounts to retrieve");
@@ -412,10 +483,10 @@ bool cUseOT::AccountRefresh(const string & accountName, bool all, bool dryrun) {
 		}
 
 		for (int32_t accountIndex = 0; accountIndex < accountCount; ++accountIndex) {
-			ID accountID = opentxs::OTAPI_Wrap::GetAccountWallet_ID(accountIndex);
-			ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
-			ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-			if ( mMadeEasy->retrieve_account(accountServerID, accountNymID, accountID, false) ) { // forcing download
+			ID accountID = _otapi(GetAccountWallet_ID(accountIndex));
+			ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
+			ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+			if ( _otme(retrieve_account(accountServerID, accountNymID, accountID, false)) ) { // forcing download
 				_info("Account " + AccountGetName(accountID) + "(" + accountID +  ")" + " retrieval success from server " + ServerGetName(accountServerID) + "(" + accountServerID +  ")");
 				++accountsRetrieved;
 			}else
@@ -435,9 +506,9 @@ bool cUseOT::AccountRefresh(const string & accountName, bool all, bool dryrun) {
 	}
 	else {
 		ID accountID = AccountGetId(accountName);
-		ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
-		ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-		if ( mMadeEasy->retrieve_account(accountServerID, accountNymID, accountID, true) ) { // forcing download
+		ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
+		ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+		if ( _otme(retrieve_account(accountServerID, accountNymID, accountID, true)) ) { // forcing download
 			_info("Account " + accountName + "(" + accountID +  ")" + " retrieval success from server " + ServerGetName(accountServerID) + "(" + accountServerID +  ")");
 			return true;
 		}
@@ -477,16 +548,16 @@ bool cUseOT::AccountCreate(const string & nym, const string & asset, const strin
 	ID serverID = ServerGetId(server);
 
 	string response;
-	response = mMadeEasy->create_asset_acct(serverID, nymID, assetID);
+	response = _otme(create_asset_acct(serverID, nymID, assetID));
 
 	// -1 error, 0 failure, 1 success.
-	if (1 != mMadeEasy->VerifyMessageSuccess(response)) {
+	if (1 != _otme(VerifyMessageSuccess(response))) {
 		_erro("Failed trying to create Account at Server.");
 		return false;
 	}
 
 	// Get the ID of the new account.
-	ID accountID = opentxs::OTAPI_Wrap::Message_GetNewAcctID(response);
+	ID accountID = _otapi(Message_GetNewAcctID(response));
 	if (!accountID.size()){
 		_erro("Failed trying to get the new account's ID from the server response.");
 		return false;
@@ -512,8 +583,8 @@ vector<string> cUseOT::AccountGetAllNames() {
 
 	_dbg3("Retrieving all accounts names");
 	vector<string> accounts;
-	for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetAccountCount ();i++) {
-		accounts.push_back(opentxs::OTAPI_Wrap::GetAccountWallet_Name ( opentxs::OTAPI_Wrap::GetAccountWallet_ID (i)));
+	for(int i = 0 ; i < _otapi(GetAccountCount());i++) {
+		accounts.push_back(_otapi(GetAccountWallet_Name( _otapi(GetAccountWallet_ID(i)))));
 	}
 	return accounts;
 }
@@ -524,7 +595,7 @@ bool cUseOT::AccountDisplay(const string & account, bool dryrun) {
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	string stat = mMadeEasy->stat_asset_account(accountID);
+	string stat = _otme(stat_asset_account(accountID));
 	if ( !stat.empty() ) {
 			nUtils::DisplayStringEndl(cout, stat);
 			return true;
@@ -538,7 +609,7 @@ bool cUseOT::AccountDisplayAll(bool dryrun) {
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	const int32_t count = opentxs::OTAPI_Wrap::GetAccountCount();
+	const int32_t count = _otapi(GetAccountCount());
 
 	if (count < 1) {
 		cout << zkr::cc::fore::yellow << "no accounts to display" << zkr::cc::console << endl;
@@ -554,10 +625,10 @@ bool cUseOT::AccountDisplayAll(bool dryrun) {
 
 	tp.PrintHeader();
 	for (int32_t i = 0; i < count; i++) {
-		ID accountID = opentxs::OTAPI_Wrap::GetAccountWallet_ID(i);
-		int64_t balance = opentxs::OTAPI_Wrap::GetAccountWallet_Balance(accountID);
-		ID assetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-		string accountType = opentxs::OTAPI_Wrap::GetAccountWallet_Type(accountID);
+		ID accountID = _otapi(GetAccountWallet_ID(i));
+		int64_t balance = _otapi(GetAccountWallet_Balance(accountID));
+		ID assetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+		string accountType = _otapi(GetAccountWallet_Type(accountID));
 		if(accountType=="issuer") tp.SetContentColor(zkr::cc::fore::lightred);
 		else if (accountType=="simple") tp.SetContentColor(zkr::cc::fore::lightgreen);
 
@@ -569,6 +640,89 @@ bool cUseOT::AccountDisplayAll(bool dryrun) {
 	return true;
 }
 
+bool cUseOT::AccountSummary(const string & by, bool jsonl, bool dryrun) {
+	_fact("account summary --by " << by << (jsonl ? " --jsonl" : ""));
+	if(dryrun) return true;
+	if(!Init()) return false;
+
+	// balances of different assets can not be added, so asset is always part of the group
+	bool byNym = false, byServer = false;
+	string parts = by;
+	std::replace(parts.begin(), parts.end(), ',', ' ');
+	for (const auto & part : nUtils::SplitString(parts)) {
+		if (part == "nym") byNym = true;
+		else if (part == "server") byServer = true;
+		else if (part != "asset") return nUtils::reportError("Unknown grouping for account summary: " + part + " (use asset, nym, server)");
+	}
+
+	struct cGroup { ID mAsset, mNym, mServer; size_t mAccounts; int64_t mBalance; };
+	map<string, cGroup> groups; // key made of the group IDs, so output is in stable order
+
+	const int32_t count = _otapi(GetAccountCount());
+	for (int32_t i = 0; i < count; i++) { // one pass over wallet, names are resolved only once per group below
+		const ID accountID = _otapi(GetAccountWallet_ID(i));
+		cGroup group;
+		group.mAsset = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+		group.mNym = byNym ? _otapi(GetAccountWallet_NymID(accountID)) : "";
+		group.mServer = byServer ? _otapi(GetAccountWallet_NotaryID(accountID)) : "";
+		group.mAccounts = 0;
+		group.mBalance = 0;
+		auto inserted = groups.insert( std::make_pair(group.mAsset + " " + group.mNym + " " + group.mServer, group) );
+		inserted.first->second.mAccounts++;
+		inserted.first->second.mBalance += _otapi(GetAccountWallet_Balance(accountID));
+	}
+
+	if (groups.empty()) {
+		if (!jsonl) cout << zkr::cc::fore::yellow << "no accounts to display" << zkr::cc::console << endl;
+		return true;
+	}
+
+	NymGetAll(); // names of own nyms come from cache instead of NymGetName (which lists all nyms each call)
+	map<ID, string> assetNames, serverNames;
+	auto assetName = [&](const ID & id) -> string {
+		auto found = assetNames.find(id);
+		return (found != assetNames.end()) ? found->second : (assetNames[id] = AssetGetName(id));
+	};
+	auto serverName = [&](const ID & id) -> string {
+		auto found = serverNames.find(id);
+		return (found != serverNames.end()) ? found->second : (serverNames[id] = ServerGetName(id));
+	};
+	auto nymName = [&](const ID & id) -> string {
+		const string * found = mCache.mNyms.FindName(id);
+		return found ? *found : NymGetRecipientName(id);
+	};
+
+	if (jsonl) {
+		using nUtils::JsonEscape;
+		for (const auto & entry : groups) {
+			const cGroup & group = entry.second;
+			cout << "{\"asset_id\":\"" << JsonEscape(group.mAsset) << "\",\"asset\":\"" << JsonEscape(assetName(group.mAsset)) << "\"";
+			if (byNym) cout << ",\"nym_id\":\"" << JsonEscape(group.mNym) << "\",\"nym\":\"" << JsonEscape(nymName(group.mNym)) << "\"";
+			if (byServer) cout << ",\"server_id\":\"" << JsonEscape(group.mServer) << "\",\"server\":\"" << JsonEscape(serverName(group.mServer)) << "\"";
+			cout << ",\"accounts\":" << group.mAccounts << ",\"balance\":" << group.mBalance << "}" << endl;
+		}
+		return true;
+	}
+
+	bprinter::TablePrinter tp(&std::cout);
+	tp.AddColumn("Asset", 40);
+	if (byNym) tp.AddColumn("Nym", 30);
+	if (byServer) tp.AddColumn("Server", 30);
+	tp.AddColumn("Accounts", 8);
+	tp.AddColumn("Balance", 14);
+
+	tp.PrintHeader();
+	for (const auto & entry : groups) {
+		const cGroup & group = entry.second;
+		tp << assetName(group.mAsset);
+		if (byNym) tp << nymName(group.mNym);
+		if (byServer) tp << serverName(group.mServer);
+		tp << std::to_string(group.mAccounts) << std::to_string(group.mBalance);
+	}
+	tp.PrintFooter();
+	return true;
+}
+
 bool cUseOT::AccountSetDefault(const string & account, bool dryrun) {
 	_fact("account set-default " << account);
 	if(dryrun) return true;
@@ -598,13 +752,16 @@ bool cUseOT::AccountTransfer(const string & accountFrom, const string & accountT
 			<< accountTo << endl;
 	ID accountFromID = AccountGetId(accountFrom);
 	ID accountToID = AccountGetId(accountTo);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountFromID);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountFromID);
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountFromID));
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountFromID));
 
-	string response = mMadeEasy->send_transfer(accountServerID, accountNymID, accountFromID, accountToID, amount, note);
+	if (!mTransNumPool.Acquire(accountServerID, accountNymID))
+		return nUtils::reportError("", "not enough transaction number", "Not enough transaction number!");
+
+	string response = _otme(send_transfer(accountServerID, accountNymID, accountFromID, accountToID, amount, note));
 
 	// -1 error, 0 failure, 1 success.
-	if (1 != mMadeEasy->VerifyMessageSuccess(response)) {
+	if (1 != _otme(VerifyMessageSuccess(response))) {
 		_erro("Failed to send transfer from " << accountFrom << " to " << accountTo);
 		return false;
 	}
@@ -617,17 +774,17 @@ bool cUseOT::AccountInDisplay(const string & account, bool dryrun) {
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
 
-	string inbox = opentxs::OTAPI_Wrap::LoadInbox(accountServerID, accountNymID, accountID); // Returns NULL, or an inbox.
+	string inbox = _otapi(LoadInbox(accountServerID, accountNymID, accountID)); // Returns NULL, or an inbox.
 
 	if (inbox.empty()) {
 		_info("Unable to load inbox for account " << AccountGetName(accountID)<< "(" << accountID << "). Perhaps it doesn't exist yet?");
 		return false;
 	}
 
-	int32_t transactionCount = opentxs::OTAPI_Wrap::Ledger_GetCount(accountServerID, accountNymID, accountID, inbox);
+	int32_t transactionCount = _otapi(Ledger_GetCount(accountServerID, accountNymID, accountID, inbox));
 
 	if (transactionCount > 0) {
 		cout << zkr::cc::fore::lightblue;
@@ -646,25 +803,48 @@ bool cUseOT::AccountInDisplay(const string & account, bool dryrun) {
 
 		tp.PrintHeader();
 
+		cLedgerMirror mirror( LedgerMirrorFile("inbox-" + accountID), 5 ); // only new/changed transactions are decoded
+		vector<int64_t> transactionIDs(transactionCount);
+		vector<string> keys(transactionCount);
+		vector<cLedgerMirror::tRow> rows(transactionCount); // amount, type, refNum, recipientNymID, recipientAcctID
+		vector<int32_t> missing; // indexes to decode
+		vector<string> missingTransactions;
+		for (int32_t index = 0; index < transactionCount; ++index) {
+			string transaction = _otapi(Ledger_GetTransactionByIndex(accountServerID, accountNymID, accountID, inbox, index));
+			transactionIDs[index] = _otapi(Ledger_GetTransactionIDByIndex(accountServerID, accountNymID, accountID, inbox, index));
+			keys[index] = cLedgerMirror::Key(transactionIDs[index], transaction);
+			if (!mirror.Get(keys[index], rows[index])) { missing.push_back(index); missingTransactions.push_back(transaction); }
+		}
+
+		auto decoded = nUtils::DecodeOTRows<cLedgerMirror::tRow>( missing.size(), [&] (size_t i) -> cLedgerMirror::tRow {
+			const string & transaction = missingTransactions[i];
+			int64_t refNum = _otapi(Transaction_GetDisplayReferenceToNum(accountServerID, accountNymID, accountID, transaction));
+			int64_t amount = _otapi(Transaction_GetAmount(accountServerID, accountNymID, accountID, transaction));
+			string transactionType = _otapi(Transaction_GetType(accountServerID, accountNymID, accountID, transaction));
+			string recipientNymID = _otapi(Transaction_GetRecipientNymID(accountServerID, accountNymID, accountID, transaction));
+			string recipientAcctID = _otapi(Transaction_GetRecipientAcctID(accountServerID, accountNymID, accountID, transaction));
+			return cLedgerMirror::tRow{ ToStr(amount), transactionType, ToStr(refNum), recipientNymID, recipientAcctID };
+		} );
+		for (size_t i = 0; i < missing.size(); ++i) {
+			rows[ missing[i] ] = decoded[i];
+			mirror.Put(keys[ missing[i] ], decoded[i]);
+		}
+
 		for (int32_t index = 0; index < transactionCount; ++index) {
-			string transaction = opentxs::OTAPI_Wrap::Ledger_GetTransactionByIndex(accountServerID, accountNymID, accountID, inbox, index);
-			int64_t transactionID = opentxs::OTAPI_Wrap::Ledger_GetTransactionIDByIndex(accountServerID, accountNymID, accountID, inbox, index);
-			int64_t refNum = opentxs::OTAPI_Wrap::Transaction_GetDisplayReferenceToNum(accountServerID, accountNymID, accountID, transaction);
-			int64_t amount = opentxs::OTAPI_Wrap::Transaction_GetAmount(accountServerID, accountNymID, accountID, transaction);
-			string transactionType = opentxs::OTAPI_Wrap::Transaction_GetType(accountServerID, accountNymID, accountID, transaction);
-			string senderNymID = opentxs::OTAPI_Wrap::Transaction_GetSenderNymID(accountServerID, accountNymID, accountID, transaction);
-			string senderAcctID = opentxs::OTAPI_Wrap::Transaction_GetSenderAcctID(accountServerID, accountNymID, accountID, transaction);
-			string recipientNymID = opentxs::OTAPI_Wrap::Transaction_GetRecipientNymID(accountServerID, accountNymID, accountID, transaction);
-			string recipientAcctID = opentxs::OTAPI_Wrap::Transaction_GetRecipientAcctID(accountServerID, accountNymID, accountID, transaction);
+			const int64_t transactionID = transactionIDs[index];
+			const cLedgerMirror::tRow & row = rows[index];
+			const string & recipientNymID = row.at(3);
+			const string & recipientAcctID = row.at(4);
 
 			//TODO Check if Transaction information needs to be verified!!!
 			// XXX; test this!! Should be recipient or sender?
-            tp << ToStr(index) << ToStr(amount) << transactionType << ToStr(transactionID) << ToStr(refNum)
+            tp << ToStr(index) << row.at(0) << row.at(1) << ToStr(transactionID) << row.at(2)
 //				 << NymGetName(senderNymID) + "(" + senderNymID + ")" <<  AccountGetName( senderAcctID ) + "(" + senderAcctID + ")";
 				<< NymGetName(recipientNymID) + "(" + recipientNymID + ")" <<  AccountGetName( recipientAcctID ) + "(" + recipientNymID + ")";
 
 		}
 		tp.PrintFooter();
+		mirror.Save();
 	  return true;
 	} else {
 		_info("There is no transactions in inbox for account " << AccountGetName(accountID)<< "(" << accountID << ")");
@@ -687,19 +867,19 @@ bool cUseOT::AccountInAccept(const string & account, const int index, bool all,
 	if (all) {
 		int32_t transactionsAccepted = 0;
 
-		ID serverID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+		ID serverID = _otapi(GetAccountWallet_NotaryID(accountID));
 		ID nymID = AccountGetNymID(account);
 
-		mMadeEasy->retrieve_account(serverID, nymID, accountID, true);
+		_otme(retrieve_account(serverID, nymID, accountID, true));
 
-		string inbox = opentxs::OTAPI_Wrap::LoadInbox(serverID, nymID, accountID); // Returns NULL, or an inbox.
+		string inbox = _otapi(LoadInbox(serverID, nymID, accountID)); // Returns NULL, or an inbox.
 
 		if (inbox.empty()) {
 			cout << "Unable to load inbox for " << AccountGetName(accountID) << endl;
 			_info("Unable to load inbox for account " << AccountGetName(accountID)<< "(" << accountID << "). Perhaps it doesn't exist yet?");
 			return false;
 		}
-		int32_t transactionCount = opentxs::OTAPI_Wrap::Ledger_GetCount(serverID, nymID, accountID, inbox);
+		int32_t transactionCount = _otapi(Ledger_GetCount(serverID, nymID, accountID, inbox));
 		_dbg3("Transaction count in inbox: " << transactionCount);
 
 		if (transactionCount == 0){
@@ -709,10 +889,10 @@ bool cUseOT::AccountInAccept(const string & account, const int index, bool all,
 		}
 
 		for (int32_t index = 0; index < transactionCount; ++index) {
-			auto accepted =  mMadeEasy->accept_inbox_items( accountID, nItemType, ToStr(0));
+			auto accepted =  _otme(accept_inbox_items( accountID, nItemType, ToStr(0)));
 			if(!accepted) { // problem with transtaction accepting, trying once again
 				_warn("transaction " << index << " failed, trying again");
-				accepted =  mMadeEasy->accept_inbox_items( accountID, nItemType, ToStr(0));
+				accepted =  _otme(accept_inbox_items( accountID, nItemType, ToStr(0)));
 			}
 
 			if (accepted) {
@@ -726,7 +906,7 @@ bool cUseOT::AccountInAccept(const string & account, const int index, bool all,
 		string count = ToStr(transactionsAccepted) + "/" + ToStr(transactionCount);
 		if (transactionsAccepted == transactionCount) {
 			_info("All transactions were successfully accepted " << count);
-			mMadeEasy->retrieve_account(serverID, nymID, accountID, true);
+			_otme(retrieve_account(serverID, nymID, accountID, true));
 			cout << zkr::cc::fore::lightgreen << "Payments accepted" << zkr::cc::console << endl;
 			return true;
 		} else if (transactionsAccepted == 0) {
@@ -739,7 +919,7 @@ bool cUseOT::AccountInAccept(const string & account, const int index, bool all,
 
 	}
 	else {
-		if ( mMadeEasy->accept_inbox_items( accountID, nItemType, ToStr(index) ) ) {
+		if ( _otme(accept_inbox_items( accountID, nItemType, ToStr(index) )) ) {
 			_info("Successfully accepted inbox transaction number: " << index);
 			return true;
 		}
@@ -755,10 +935,10 @@ bool cUseOT::AccountOutCancel(const string & account, const int index, bool all,
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
 	// int32_t nItemType = 0; // TODO pass it as an argument
 
-	if ( mMadeEasy->cancel_outgoing_payments( accountNymID, accountID, ToStr(index) ) ) { //TODO cancel_outgoing_payments is not for account outbox
+	if ( _otme(cancel_outgoing_payments( accountNymID, accountID, ToStr(index) )) ) { //TODO cancel_outgoing_payments is not for account outbox
 		_info("Successfully cancelled outbox transaction: " << index);
 		return true;
 	}
@@ -778,11 +958,11 @@ bool cUseOT::AccountOutDisplay(const string & account, bool dryrun) {
 	cout << zkr::cc::console << endl;
 
 	ID accountID = AccountGetId(account);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 	ID accountNymID = AccountGetNymID(account);
 
-	mMadeEasy->retrieve_account(accountServerID, accountNymID, accountID, true);
-	string outbox = opentxs::OTAPI_Wrap::LoadOutbox(accountServerID, accountNymID, accountID); // Returns NULL, or an inbox.
+	_otme(retrieve_account(accountServerID, accountNymID, accountID, true));
+	string outbox = _otapi(LoadOutbox(accountServerID, accountNymID, accountID)); // Returns NULL, or an inbox.
 
 	if (outbox.empty()) {
 		_info(
@@ -790,7 +970,7 @@ bool cUseOT::AccountOutDisplay(const string & account, bool dryrun) {
 		return false;
 	}
 
-	int32_t transactionCount = opentxs::OTAPI_Wrap::Ledger_GetCount(accountServerID, accountNymID, accountID, outbox);
+	int32_t transactionCount = _otapi(Ledger_GetCount(accountServerID, accountNymID, accountID, outbox));
 
 	if (transactionCount > 0) {
 		bprinter::TablePrinter tp(&std::cout);
@@ -803,28 +983,37 @@ bool cUseOT::AccountOutDisplay(const string & account, bool dryrun) {
 		 tp.AddColumn("To Account", 50);
 
 		tp.PrintHeader();
+		cLedgerMirror mirror( LedgerMirrorFile("outbox-" + accountID), 4 ); // only new/changed transactions are decoded
 		for (int32_t index = 0; index < transactionCount; ++index) {
-			const string transaction = opentxs::OTAPI_Wrap::Ledger_GetTransactionByIndex(accountServerID, accountNymID,
-					accountID, outbox, index);
-			int64_t transactionID = opentxs::OTAPI_Wrap::Ledger_GetTransactionIDByIndex(accountServerID, accountNymID,
-					accountID, outbox, index);
-			int64_t refNum = opentxs::OTAPI_Wrap::Transaction_GetDisplayReferenceToNum(accountServerID, accountNymID,
-					accountID, transaction);
-			int64_t amount = opentxs::OTAPI_Wrap::Transaction_GetAmount(accountServerID, accountNymID, accountID,
-					transaction);
-			string transactionType = opentxs::OTAPI_Wrap::Transaction_GetType(accountServerID, accountNymID, accountID,
-					transaction);
-			string recipientAcctID = opentxs::OTAPI_Wrap::Transaction_GetRecipientAcctID(accountServerID, accountNymID,
-					accountID, transaction);
+			const string transaction = _otapi(Ledger_GetTransactionByIndex(accountServerID, accountNymID,
+					accountID, outbox, index));
+			int64_t transactionID = _otapi(Ledger_GetTransactionIDByIndex(accountServerID, accountNymID,
+					accountID, outbox, index));
+			const string key = cLedgerMirror::Key(transactionID, transaction);
+			cLedgerMirror::tRow row; // amount, type, refNum, recipientAcctID
+			if (!mirror.Get(key, row)) {
+				int64_t refNum = _otapi(Transaction_GetDisplayReferenceToNum(accountServerID, accountNymID,
+						accountID, transaction));
+				int64_t amount = _otapi(Transaction_GetAmount(accountServerID, accountNymID, accountID,
+						transaction));
+				string transactionType = _otapi(Transaction_GetType(accountServerID, accountNymID, accountID,
+						transaction));
+				string recipientAcctID = _otapi(Transaction_GetRecipientAcctID(accountServerID, accountNymID,
+						accountID, transaction));
+				row = { ToStr(amount), transactionType, ToStr(refNum), recipientAcctID };
+				mirror.Put(key, row);
+			}
+			const string & recipientAcctID = row.at(3);
 
 			//TODO Check if Transaction information needs to be verified!!!
-			tp << ToStr(index) << ToStr(amount) << transactionType << ToStr(transactionID)
-					<< ToStr(refNum)
+			tp << ToStr(index) << row.at(0) << row.at(1) << ToStr(transactionID)
+					<< row.at(2)
 					// << "BUG - working on it" << "BUG - working on it" ;
 //					<< NymGetName(recipientNymID) + "(" + recipientNymID + ")";
 					<< AccountGetName(recipientAcctID) + "(" + recipientAcctID + ")";
 		}
 		tp.PrintFooter();
+		mirror.Save();
 		return true;
 	} else {
 		_info("There is no transactions in outbox for account " << AccountGetName(accountID)<< "(" << accountID << ")");
@@ -838,7 +1027,7 @@ bool cUseOT::AccountSetName(const string & accountID, const string & newAccountN
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	if ( !opentxs::OTAPI_Wrap::SetAccountWallet_Name (accountID, mDefaultIDs.at(nUtils::eSubjectType::User), newAccountName) ) {
+	if ( !_otapi(SetAccountWallet_Name(accountID, mDefaultIDs.at(nUtils::eSubjectType::User), newAccountName)) ) {
 		return reportError("Failed trying to name new account: " + accountID);
 	}
 	_info("Set account " << accountID << "name to " << newAccountName);
@@ -906,8 +1095,8 @@ vector<string> cUseOT::AssetGetAllNames() {
 	return vector<string> {};
 
 	vector<string> assets;
-	for(int32_t i = 0 ; i < opentxs::OTAPI_Wrap::GetAssetTypeCount ();i++) {
-		assets.push_back(opentxs::OTAPI_Wrap::GetAssetType_Name ( opentxs::OTAPI_Wrap::GetAssetType_ID (i)));
+	for(int32_t i = 0 ; i < _otapi(GetAssetTypeCount());i++) {
+		assets.push_back(_otapi(GetAssetType_Name( _otapi(GetAssetType_ID(i)))));
 	}
 	return assets;
 }
@@ -918,7 +1107,7 @@ string cUseOT::AssetGetName(const ID & assetID) {
 	if(assetID.empty())
 		return "";
 
-	auto asset = opentxs::OTAPI_Wrap::GetAssetType_Name(assetID);
+	auto asset = _otapi(GetAssetType_Name(assetID));
 	return (asset.empty())? "" : asset;
 }
 
@@ -935,7 +1124,7 @@ bool cUseOT::AssetAdd(const string & filename, bool dryrun) {
 	} catch (const string & message) {
 		return nUtils::reportError("", message, "Provided contract was empty");
 	}
-	auto result = opentxs::OTAPI_Wrap::AddAssetContract(contract);
+	auto result = _otapi(AddAssetContract(contract));
 
 	if (result != 1) {
 		cout << zkr::cc::fore::lightred << "You must input a currency contract, in order to add it to your wallet"
@@ -961,8 +1150,8 @@ bool cUseOT::AssetDisplayAll(bool dryrun) {
 	if(!Init()) return false;
 
 	_dbg3("Retrieving all asset names");
-	for(std::int32_t i = 0 ; i < opentxs::OTAPI_Wrap::GetAssetTypeCount();i++) {
-		ID assetID = opentxs::OTAPI_Wrap::GetAssetType_ID(i);
+	for(std::int32_t i = 0 ; i < _otapi(GetAssetTypeCount());i++) {
+		ID assetID = _otapi(GetAssetType_ID(i));
 		nUtils::DisplayStringEndl(nUtils::stringToColor(assetID) + assetID + " " + AssetGetName( assetID ) );
 	}
 	return true;
@@ -975,9 +1164,9 @@ string cUseOT::AssetGetId(const string & assetName) {
 	if ( nUtils::checkPrefix(assetName) )
 		return assetName.substr(1);
 	else {
-		for(std::int32_t i = 0 ; i < opentxs::OTAPI_Wrap::GetAssetTypeCount ();i++) {
-			if(opentxs::OTAPI_Wrap::GetAssetType_Name ( opentxs::OTAPI_Wrap::GetAssetType_ID (i))==assetName)
-				return opentxs::OTAPI_Wrap::GetAssetType_ID (i);
+		for(std::int32_t i = 0 ; i < _otapi(GetAssetTypeCount());i++) {
+			if(_otapi(GetAssetType_Name( _otapi(GetAssetType_ID(i))))==assetName)
+				return _otapi(GetAssetType_ID(i));
 		}
 	}
 	return "";
@@ -985,7 +1174,7 @@ string cUseOT::AssetGetId(const string & assetName) {
 
 string cUseOT::AssetGetContract(const string & asset){
 	if(!Init()) return "";
-	string strContract = opentxs::OTAPI_Wrap::GetAssetType_Contract( AssetGetId(asset) );
+	string strContract = _otapi(GetAssetType_Contract( AssetGetId(asset) ));
 	return strContract;
 }
 
@@ -1005,15 +1194,15 @@ bool cUseOT::AssetIssue(const string & server, const string & nym, const string
 	const ID serverID = ServerGetId(server);
 	const ID nymID = NymGetId(nym);
 
-	if(!opentxs::OTAPI_Wrap::IsNym_RegisteredAtServer(nymID, serverID))
+	if(!_otapi(IsNym_RegisteredAtServer(nymID, serverID)))
 		return reportError("Nym " + nym + " isn't register at server!");
 
 	string signedContract = GetInput(filename);
 
-	string strResponse = mMadeEasy->issue_asset_type(serverID, nymID, signedContract);
+	string strResponse = _otme(issue_asset_type(serverID, nymID, signedContract));
 
 	// -1 error, 0 failure, 1 success.
-	if (1 != mMadeEasy->VerifyMessageSuccess(strResponse))
+	if (1 != _otme(VerifyMessageSuccess(strResponse)))
 	{
 		_erro("Failed trying to issue asset at Server.");
 		return false;
@@ -1033,7 +1222,7 @@ bool cUseOT::AssetNew(const string & nym, const string & filename, bool dryrun)
 		return nUtils::reportError("", message, "Provided contract was empty");
 	}
 
-	nUtils::DisplayStringEndl(cout, opentxs::OTAPI_Wrap::CreateAssetContract(NymGetId(nym), xmlContents) );
+	nUtils::DisplayStringEndl(cout, _otapi(CreateAssetContract(NymGetId(nym), xmlContents)) );
 
 	try {
 		auto defaultAsset = AssetGetDefault();
@@ -1050,8 +1239,8 @@ bool cUseOT::AssetRemove(const string & asset, bool dryrun) {
 	if(!Init()) return false;
 
 	string assetID = AssetGetId(asset);
-	if ( opentxs::OTAPI_Wrap::Wallet_CanRemoveAssetType(assetID) ) {
-		if ( opentxs::OTAPI_Wrap::Wallet_RemoveAssetType(assetID) ) {
+	if ( _otapi(Wallet_CanRemoveAssetType(assetID)) ) {
+		if ( _otapi(Wallet_RemoveAssetType(assetID)) ) {
 			_info("Asset was deleted successfully");
 			mDefaultIDs.at(nUtils::eSubjectType::Asset) = "-";
 			return true;
@@ -1061,7 +1250,7 @@ bool cUseOT::AssetRemove(const string & asset, bool dryrun) {
 	return false;
 }
 bool cUseOT::AssetSetDefault() {
-	ID assetID = opentxs::OTAPI_Wrap::GetAssetType_ID(0);
+	ID assetID = _otapi(GetAssetType_ID(0));
 	if(assetID.empty()) return false;
 	_note("Setting asset" << AssetGetName(assetID) << " as default");
 	return AssetSetDefault(AssetGetName(assetID), false);
@@ -1084,7 +1273,7 @@ bool cUseOT::AssetShowContract(const string & asset, const string & filename, bo
 	if(!Init()) return false;
 
 	const ID assetID = AssetGetId(asset);
-	const auto contract = opentxs::OTAPI_Wrap::GetAssetType_Contract(assetID);
+	const auto contract = _otapi(GetAssetType_Contract(assetID));
 
 	if(!filename.empty()) {
 		try {
@@ -1114,7 +1303,7 @@ bool cUseOT::BasketNew(const string & nym, const string & server, const string &
 	int64_t amount = 100;
 	auto fromNym = "Trader Bob";
 
-	string basket = opentxs::OTAPI_Wrap::GenerateBasketCreation(NymGetId(fromNym), amount);
+	string basket = _otapi(GenerateBasketCreation(NymGetId(fromNym), amount));
 
 	_dbg2("basket: " << basket);
 
@@ -1124,16 +1313,16 @@ bool cUseOT::BasketNew(const string & nym, const string & server, const string &
 	const auto asset1ID = AssetGetId(asset1);
 	const auto asset2ID = AssetGetId(asset2);
 
-	_dbg3(opentxs::OTAPI_Wrap::GetAssetType_Contract(asset1ID));
-	_dbg3(opentxs::OTAPI_Wrap::GetAssetType_Contract(asset2ID));
+	_dbg3(_otapi(GetAssetType_Contract(asset1ID)));
+	_dbg3(_otapi(GetAssetType_Contract(asset2ID)));
 
-	auto tmpBasket = opentxs::OTAPI_Wrap::AddBasketCreationItem(NymGetId(fromNym), basket, asset2ID, amount);
+	auto tmpBasket = _otapi(AddBasketCreationItem(NymGetId(fromNym), basket, asset2ID, amount));
 
 	_dbg2("tmpBasket: " << tmpBasket);
 
 	basket = tmpBasket;
 
-	auto response = mMadeEasy->issue_basket_currency(ServerGetDefault(), NymGetId(fromNym), basket);
+	auto response = _otme(issue_basket_currency(ServerGetDefault(), NymGetId(fromNym), basket));
 */
 	return true;
 }
@@ -1165,12 +1354,12 @@ string cUseOT::CashExport(const ID & nymSenderID, const ID & nymRecipientID, con
 	_fact("cash export from " << nymSenderID << " to " << nymRecipientID << " account " << account << " indices: " << indices << "passwordProtected: " << passwordProtected);
 
 	ID accountID = AccountGetId(account);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 
-	string contract = mMadeEasy->load_or_retrieve_contract(accountServerID, nymSenderID, accountAssetID);
+	string contract = AssetContractLoad(accountServerID, nymSenderID, accountAssetID);
 
-	string exportedCash = mMadeEasy->export_cash(accountServerID, nymSenderID, accountAssetID, nymRecipientID, indices, passwordProtected, retained_copy);
+	string exportedCash = _otme(export_cash(accountServerID, nymSenderID, accountAssetID, nymRecipientID, indices, passwordProtected, retained_copy));
 	_info("Cash was exported");
 	return exportedCash;
 }
@@ -1187,17 +1376,17 @@ bool cUseOT::CashImport(const string & nym, bool dryrun) {
 	_dbg3("Open text editor for user to paste payment instrument");
 	string instrument = GetText();
 
-	string instrumentType = opentxs::OTAPI_Wrap::Instrmnt_GetType(instrument);
+	string instrumentType = _otapi(Instrmnt_GetType(instrument));
 
 	if (instrumentType.empty()) {
-		opentxs::OTAPI_Wrap::Output(0, "\n\nFailure: Unable to determine instrument type. Expected (cash) PURSE.\n");
+		_otapi(Output(0, "\n\nFailure: Unable to determine instrument type. Expected (cash) PURSE.\n"));
 		return false;
 	}
 
-	string serverID = opentxs::OTAPI_Wrap::Instrmnt_GetNotaryID(instrument);
+	string serverID = _otapi(Instrmnt_GetNotaryID(instrument));
 
 	if (serverID.empty()) {
-			opentxs::OTAPI_Wrap::Output(0, "\n\nFailure: Unable to determine server ID from purse.\n");
+			_otapi(Output(0, "\n\nFailure: Unable to determine server ID from purse.\n"));
 			return false;
 	}
 
@@ -1229,7 +1418,7 @@ bool cUseOT::CashImport(const string & nym, bool dryrun) {
 
 	// This tells us if the purse is password-protected. (Versus being owned
 	// by a Nym.)
-	bool hasPassword = opentxs::OTAPI_Wrap::Purse_HasPassword(serverID, instrument);
+	bool hasPassword = _otapi(Purse_HasPassword(serverID, instrument));
 
 	/**
 	 * Even if the Purse is owned by a Nym, that Nym's ID may not necessarily
@@ -1241,7 +1430,7 @@ bool cUseOT::CashImport(const string & nym, bool dryrun) {
 	ID purseOwner = "";
 
 	if (!hasPassword) {
-			purseOwner = opentxs::OTAPI_Wrap::Instrmnt_GetRecipientNymID(instrument); // TRY and get the Nym ID (it may have been left blank.)
+			purseOwner = _otapi(Instrmnt_GetRecipientNymID(instrument)); // TRY and get the Nym ID (it may have been left blank.)
 	}
 	/**
 	 * Whether the purse was password-protected (and thus had no Nym ID)
@@ -1263,25 +1452,25 @@ bool cUseOT::CashImport(const string & nym, bool dryrun) {
 	 * MyNym, and if THAT's not set, then we return failure.
 	 */
 	if (purseOwner.empty()) {
-		opentxs::OTAPI_Wrap::Output(0,
+		_otapi(Output(0,
 				"\n\n The NymID isn't evident from the purse itself... (listing it is optional.)\n"
 				"The purse may have no Nym at all--it may instead be password-protected.) "
 				"Either way, a signer nym is still necessary, even for password-protected purses.\n\n "
-				"Trying MyNym...\n");
+				"Trying MyNym...\n"));
 			purseOwner = nymID;
 	}
 
-	string assetID = opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(instrument);
+	string assetID = _otapi(Instrmnt_GetInstrumentDefinitionID(instrument));
 
 	if (assetID.empty()) {
-			opentxs::OTAPI_Wrap::Output(0, "\n\nFailure: Unable to determine asset type ID from purse.\n");
+			_otapi(Output(0, "\n\nFailure: Unable to determine asset type ID from purse.\n"));
 			return false;
 	}
 
-	bool imported = opentxs::OTAPI_Wrap::Wallet_ImportPurse(serverID, assetID, purseOwner, instrument);
+	bool imported = _otapi(Wallet_ImportPurse(serverID, assetID, purseOwner, instrument));
 
 	if (imported) {
-			opentxs::OTAPI_Wrap::Output(0, "\n\n Success importing purse!\nServer: " + serverID + "\nAsset Type: " + assetID + "\nNym: " + purseOwner + "\n\n");
+			_otapi(Output(0, "\n\n Success importing purse!\nServer: " + serverID + "\nAsset Type: " + assetID + "\nNym: " + purseOwner + "\n\n"));
 			return true;
 	}
 
@@ -1291,24 +1480,24 @@ bool cUseOT::CashImport(const string & nym, bool dryrun) {
 bool cUseOT::CashDeposit(const string & accountID, const string & nymFromID, const string & serverID, const string & instrument) {
 	if(!Init()) return false;
 
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
 
 	string purseValue = instrument;
 
 	if (instrument.empty()) {
 		// LOAD PURSE
 		_dbg3("Loading purse");
-		purseValue = opentxs::OTAPI_Wrap::LoadPurse(serverID, accountAssetID, nymFromID); // returns NULL, or a purse.
+		purseValue = _otapi(LoadPurse(serverID, accountAssetID, nymFromID)); // returns NULL, or a purse.
 
 		if (purseValue.empty()) {
-			opentxs::OTAPI_Wrap::Output(0, " Unable to load purse from local storage. Does it even exist?\n");
+			_otapi(Output(0, " Unable to load purse from local storage. Does it even exist?\n"));
 			return false;
 		}
 	}
 
 	_dbg3("Processing cash deposit to account");
-	int32_t nResult = mMadeEasy->deposit_cash(serverID, accountNymID, accountID, purseValue); // TODO pass reciever nym if exists in purse
+	int32_t nResult = _otme(deposit_cash(serverID, accountNymID, accountID, purseValue)); // TODO pass reciever nym if exists in purse
 	if (nResult < 1) {
 		DisplayStringEndl(cout, "Unable to deposit purse");
 		return false;
@@ -1325,9 +1514,9 @@ bool cUseOT::CashDepositWrap(const string & account, bool dryrun) {
 
 	ID accountID = AccountGetId(account);
 
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 
 	_dbg3("Open text editor for user to paste payment instrument");
 	string instrument = GetText();
@@ -1341,9 +1530,9 @@ bool cUseOT::CashSend(const string & nymSender, const string & nymRecipient, con
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 
 	ID nymSenderID = NymGetId(nymSender);
 	ID nymRecipientID = NymGetToNymId(nymRecipient, nymSenderID);
@@ -1361,15 +1550,15 @@ bool cUseOT::CashSend(const string & nymSender, const string & nymRecipient, con
 
 	string exportedCashPurse = CashExport(nymSenderID, nymRecipientID, account, indices, passwordProtected, retainedCopy);
 	if (!exportedCashPurse.empty()) {
-		string response = mMadeEasy->send_user_cash(accountServerID, nymSenderID, nymRecipientID, exportedCashPurse, retainedCopy);
+		string response = _otme(send_user_cash(accountServerID, nymSenderID, nymRecipientID, exportedCashPurse, retainedCopy));
 
-		int32_t returnVal = mMadeEasy->VerifyMessageSuccess(response);
+		int32_t returnVal = _otme(VerifyMessageSuccess(response));
 
 		if (1 != returnVal) {
 			// It failed sending the cash to the recipient Nym.
 			// Re-import strRetainedCopy back into the sender's cash purse.
 			//
-			bool bImported = opentxs::OTAPI_Wrap::Wallet_ImportPurse(accountServerID, accountAssetID, nymSenderID, retainedCopy);
+			bool bImported = _otapi(Wallet_ImportPurse(accountServerID, accountAssetID, nymSenderID, retainedCopy));
 
 			if (bImported) {
 				DisplayStringEndl(cout, "Failed sending cash, but at least: success re-importing purse.\nServer: " + accountServerID + "\nAsset Type: " + accountServerID + "\nNym: " + nymSender + "\n\n");
@@ -1392,9 +1581,9 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-	ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+	ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 
 	int alignCenter = 15;
 
@@ -1402,7 +1591,7 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 			<< zkr::cc::fore::lightyellow << std::setw(alignCenter) << "Asset: " << zkr::cc::fore::green << AssetGetName(accountAssetID) << endl
 			<< zkr::cc::fore::lightyellow << std::setw(alignCenter) << "Nym: " << zkr::cc::fore::green << NymGetName(accountNymID) << endl;
 
-	string purseValue = opentxs::OTAPI_Wrap::LoadPurse(accountServerID, accountAssetID, accountNymID); // returns NULL, or a purse
+	string purseValue = _otapi(LoadPurse(accountServerID, accountAssetID, accountNymID)); // returns NULL, or a purse
 
   if (purseValue.empty()) {
 		 _erro("Unable to load purse. Does it even exist?");
@@ -1410,10 +1599,10 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 		 return false;
 	}
 
-  int64_t amount = opentxs::OTAPI_Wrap::Purse_GetTotalValue(accountServerID, accountAssetID, purseValue);
-  cout << zkr::cc::fore::lightyellow << std::setw(alignCenter) << "Total value: " << zkr::cc::fore::green << opentxs::OTAPI_Wrap::FormatAmount(accountAssetID, amount) << zkr::cc::fore::console << endl;
+  int64_t amount = _otapi(Purse_GetTotalValue(accountServerID, accountAssetID, purseValue));
+  cout << zkr::cc::fore::lightyellow << std::setw(alignCenter) << "Total value: " << zkr::cc::fore::green << _otapi(FormatAmount(accountAssetID, amount)) << zkr::cc::fore::console << endl;
 
-	int32_t count = opentxs::OTAPI_Wrap::Purse_Count(accountServerID, accountAssetID, purseValue);
+	int32_t count = _otapi(Purse_Count(accountServerID, accountAssetID, purseValue));
 	if (count < 0) { // TODO check if integer?
 		DisplayStringEndl(cout, "Error: Unexpected bad value returned from OT_API_Purse_Count.");
 		_erro("Unexpected bad value returned from OT_API_Purse_Count.");
@@ -1438,13 +1627,13 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 			--count;
 			++index;  // on first iteration, this is now 0.
 
-			string token = opentxs::OTAPI_Wrap::Purse_Peek(accountServerID, accountAssetID, accountNymID, purseValue);
+			string token = _otapi(Purse_Peek(accountServerID, accountAssetID, accountNymID, purseValue));
 			if (token.empty()) {
 				_erro("OT_API_Purse_Peek unexpectedly returned NULL instead of token.");
 				return false;
 			}
 
-			string newPurse = opentxs::OTAPI_Wrap::Purse_Pop(accountServerID, accountAssetID, accountNymID, purseValue);
+			string newPurse = _otapi(Purse_Pop(accountServerID, accountAssetID, accountNymID, purseValue));
 
 			if (newPurse.empty()) {
 				_erro("OT_API_Purse_Pop unexpectedly returned NULL instead of updated purse.\n");
@@ -1453,11 +1642,11 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 
 			purseValue = newPurse;
 
-			int64_t denomination = opentxs::OTAPI_Wrap::Token_GetDenomination(accountServerID, accountAssetID, token);
-			int32_t series = opentxs::OTAPI_Wrap::Token_GetSeries(accountServerID, accountAssetID, token);
-			time64_t validFrom = opentxs::OTAPI_Wrap::Token_GetValidFrom(accountServerID, accountAssetID, token);
-			time64_t validTo = opentxs::OTAPI_Wrap::Token_GetValidTo(accountServerID, accountAssetID, token);
-			time64_t time = opentxs::OTAPI_Wrap::GetTime();
+			int64_t denomination = _otapi(Token_GetDenomination(accountServerID, accountAssetID, token));
+			int32_t series = _otapi(Token_GetSeries(accountServerID, accountAssetID, token));
+			time64_t validFrom = _otapi(Token_GetValidFrom(accountServerID, accountAssetID, token));
+			time64_t validTo = _otapi(Token_GetValidTo(accountServerID, accountAssetID, token));
+			time64_t time = _otapi(GetTime());
 
 			if (denomination < 0){
 				_erro( "Error while showing purse: bad denomination");
@@ -1492,28 +1681,46 @@ bool cUseOT::CashShow(const string & account, bool dryrun) { // TODO make it wor
 	return true;
 }
 
+string cUseOT::MintLoad(const ID & srvID, const ID & nymID, const ID & assetID) {
+	string mint;
+	if (mInstrumentCache.GetMint(srvID, assetID, mint)) return mint;
+	mint = _otme(load_or_retrieve_mint(srvID, nymID, assetID)); // checks expiration, can download new series
+	if (!mint.empty()) mInstrumentCache.PutMint(srvID, assetID, mint);
+	return mint;
+}
+
+string cUseOT::AssetContractLoad(const ID & srvID, const ID & nymID, const ID & assetID) {
+	string contract;
+	if (mInstrumentCache.GetContract(assetID, contract)) return contract;
+	contract = _otme(load_or_retrieve_contract(srvID, nymID, assetID));
+	mInstrumentCache.PutContract(assetID, contract);
+	return contract;
+}
+
 bool cUseOT::CashWithdraw(const string & account, int64_t amount, bool dryrun) {
 	_fact("cash withdraw " << account);
 	if (dryrun) return false;
 	if(!Init()) return false;
 
 	ID accountID = AccountGetId(account);
-	ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
+	ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
 
 	// Make sure the appropriate asset contract is available.
-	string assetContract = opentxs::OTAPI_Wrap::LoadAssetContract(accountAssetID);
+	string assetContract;
+	if (!mInstrumentCache.GetContract(accountAssetID, assetContract))
+		assetContract = _otapi(LoadAssetContract(accountAssetID));
 
 	if (assetContract.empty()) {
-		string strResponse = mMadeEasy->retrieve_contract(mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountAssetID);
+		string strResponse = _otme(retrieve_contract(mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountAssetID));
 
-		if (1 != mMadeEasy->VerifyMessageSuccess(strResponse)) {
+		if (1 != _otme(VerifyMessageSuccess(strResponse))) {
 			_erro( "Unable to retreive asset contract for nym " << accountNymID << " and server " << mDefaultIDs.at(nUtils::eSubjectType::Server) );
 			DisplayStringEndl(cout, "Unable to retreive asset contract for nym " + accountNymID + " and server " + mDefaultIDs.at(nUtils::eSubjectType::Server) );
 			return false;
 		}
 
-		assetContract = opentxs::OTAPI_Wrap::LoadAssetContract(accountAssetID);
+		assetContract = _otapi(LoadAssetContract(accountAssetID));
 
 		if (assetContract.empty()) {
 			_erro("Failure: Unable to load Asset contract even after retrieving it.");
@@ -1521,20 +1728,24 @@ bool cUseOT::CashWithdraw(const string & account, int64_t amount, bool dryrun) {
 			return false;
 		}
 	}
+	mInstrumentCache.PutContract(accountAssetID, assetContract);
 
 	// Make sure the unexpired mint file is available.
-	string mint = mMadeEasy->load_or_retrieve_mint(mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountAssetID);
+	string mint = MintLoad(mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountAssetID);
 
 	if (mint.empty()) {
 		_erro("Failure: Unable to load or retrieve necessary mint file for withdrawal.");
 		return false;
 	}
 
+	if (!mTransNumPool.Acquire(mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID))
+		return nUtils::reportError("", "not enough transaction number", "Not enough transaction number!");
+
 	// Send withdrawal request
-	string response = mMadeEasy->withdraw_cash ( mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountID, amount);//TODO pass server as an argument
+	string response = _otme(withdraw_cash( mDefaultIDs.at(nUtils::eSubjectType::Server), accountNymID, accountID, amount));//TODO pass server as an argument
 
 	// Check server response
-	if (1 != mMadeEasy->VerifyMessageSuccess(response) ) {
+	if (1 != _otme(VerifyMessageSuccess(response)) ) {
 		_erro("Failed trying to withdraw cash from account: " << AccountGetName(accountID) );
 		return false;
 	}
@@ -1559,28 +1770,101 @@ bool cUseOT::ChequeCreate(const string &fromAcc, const string & fromNym, const s
 	const time64_t validFrom = now;
 	const time64_t validTo = now + OT_TIME_SIX_MONTHS_IN_SECONDS;
 
-	if (!mMadeEasy->retrieve_nym(srvID, fromNymID, true))
-		return nUtils::reportError("Can't retrieve nym");
-
-	if (!mMadeEasy->make_sure_enough_trans_nums(1, srvID, fromNymID))
+	// no forced nym refresh: numbers the nym already has are enough, and when they are not, getting more syncs the nym
+	if (!mTransNumPool.Acquire(srvID, fromNymID))
 		return nUtils::reportError("", "not enough transaction number", "Not enough transaction number!");
 
-	const auto cheque = opentxs::OTAPI_Wrap::WriteCheque(srvID, amount, validFrom, validTo, fromAccID, fromNymID, memo,
-			toNymID);
+	const auto cheque = _otapi(WriteCheque(srvID, amount, validFrom, validTo, fromAccID, fromNymID, memo,
+			toNymID));
 
 	// OTAPI_Wrap::WriteCheque should drop a notice
 	// into the payments outbox, the same as it does when you "sendcheque" (after all, the same
 	// resolution would be expected once it is cashed.)
 
-	const auto status = mMadeEasy->VerifyMessageSuccess(cheque);
+	const auto status = _otme(VerifyMessageSuccess(cheque));
 	if (status < 0) {
 		_erro("status: " << status << " for cheque: " << cheque);
 		return nUtils::reportError(ToStr(status), "status", "Creating cheque failed!");
 	}
 
-	auto ok = mMadeEasy->retrieve_account(srvID, fromNymID, fromAccID, true);
+	// cheque is written locally, the account on server does not change until it is deposited - so no account refresh here
 	PrintInstrumentInfo(cheque);
-	return ok;
+	return true;
+}
+
+bool cUseOT::BatchPrepare(cPaymentBatch & batch, const string & csvFile, const string & manifest, const string & kind, bool overwrite, const ID & fromNymID, map<string, ID> & recipients) {
+	if (!batch.Load(csvFile)) return false;
+	if (batch.GetItems().empty()) return nUtils::reportError(csvFile, "no payments", "No payments in " + csvFile);
+
+	// each payee is resolved once, not once per line (payroll lists repeat the same nyms every run)
+	NymGetAll();
+	bool ok = true;
+	for (const auto & item : batch.GetItems()) {
+		if (recipients.count(item.mRecipient)) continue;
+		const ID nymID = NymGetToNymId(item.mRecipient, fromNymID);
+		if (nymID.empty()) ok = nUtils::reportError(item.mRecipient, "unknown recipient", csvFile + ":" + ToStr(item.mLine) + ": unknown recipient nym " + item.mRecipient);
+		recipients[item.mRecipient] = nymID;
+	}
+	if (!ok) return false; // nothing is issued when any payee is wrong
+
+	return batch.OpenManifest(manifest, kind, overwrite);
+}
+
+void cUseOT::BatchReport(const cPaymentBatch & batch, const string & manifest) {
+	auto col = batch.GetFailed() ? zkr::cc::fore::lightred : zkr::cc::fore::lightgreen;
+	cout << col << "Issued " << batch.GetIssued() << " of " << batch.GetItems().size() << ", failed " << batch.GetFailed()
+		<< zkr::cc::console << ", manifest: " << manifest << endl;
+}
+
+bool cUseOT::ChequeCreateBatch(const string &fromAcc, const string & fromNym, const string & csvFile, const string &srv, const string & manifest, bool overwrite, bool dryrun) {
+	_fact("cheque new-batch \"" << fromAcc << "\" \"" << fromNym << "\" " << csvFile << " " << srv << " --manifest " << manifest);
+	if (dryrun) return true;
+	if (!Init()) return false;
+
+	const ID fromAccID = AccountGetId(fromAcc);
+	const ID fromNymID = NymGetId(fromNym);
+	const ID srvID = ServerGetId(srv);
+
+	cPaymentBatch batch;
+	map<string, ID> recipients;
+	if (!BatchPrepare(batch, csvFile, manifest, "cheque", overwrite, fromNymID, recipients)) return false;
+
+	auto now = OTTimeGetCurrentTime();
+	const time64_t validFrom = now;
+	const time64_t validTo = now + OT_TIME_SIX_MONTHS_IN_SECONDS;
+
+	const auto & items = batch.GetItems();
+	// numbers for first part of batch at once; the pool gets next batch when these are used up
+	const int32_t upfront = static_cast<int32_t>( std::min<size_t>(items.size(), mTransNumPool.GetHigh()) );
+	if (!mTransNumPool.Acquire(srvID, fromNymID, upfront))
+		_warn("Could not get " << upfront << " transaction numbers for the batch at once, each cheque will try on its own");
+
+	for (const auto & item : items) {
+		const ID & toNymID = recipients.at(item.mRecipient);
+		if (!mTransNumPool.Acquire(srvID, fromNymID)) {
+			batch.Record(item, toNymID, false, 0, "not enough transaction numbers");
+			continue;
+		}
+		// cheque is written locally - no server round-trip per item
+		const auto cheque = _otapi(WriteCheque(srvID, item.mAmount, validFrom, validTo, fromAccID, fromNymID, item.mMemo, toNymID));
+		if (cheque.empty()) {
+			batch.Record(item, toNymID, false, 0, "writing cheque failed");
+			continue;
+		}
+		const int64_t transNum = _otapi(Instrmnt_GetTransNum(cheque));
+		const string chequeFile = batch.SaveInstrument(item, "cheque", cheque); // it exists only here - to be given to the recipient
+		if (chequeFile.empty()) {
+			batch.Record(item, toNymID, false, transNum, "cheque " + ToStr(transNum) + " written, but can not be saved");
+			continue;
+		}
+		batch.Record(item, toNymID, true, transNum, "", chequeFile);
+		_dbg2("Cheque " << item.mLine << " for " << item.mRecipient << " written");
+	}
+
+	// account is refreshed once for whole batch, not after every cheque
+	auto ok = _otme(retrieve_account(srvID, fromNymID, fromAccID, true));
+	BatchReport(batch, manifest);
+	return ok && (batch.GetFailed() == 0);
 }
 
 bool cUseOT::ChequeDiscard(const string & acc, const string & nym, const int32_t & index, bool dryrun) {
@@ -1597,18 +1881,18 @@ bool cUseOT::ChequeDiscard(const string & acc, const string & nym, const int32_t
 		cheque = GetText();
 
 	} else { // gets cheque from outpayments
-		const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(nymID);
+		const auto count = _otapi(GetNym_OutpaymentsCount(nymID));
 		if (count == 0)
 			return false;
-		cheque = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(nymID, index);
+		cheque = _otapi(GetNym_OutpaymentsContentsByIndex(nymID, index));
 	}
-	const auto srvID = opentxs::OTAPI_Wrap::Instrmnt_GetNotaryID(cheque);
+	const auto srvID = _otapi(Instrmnt_GetNotaryID(cheque));
 
-	bool discard = opentxs::OTAPI_Wrap::DiscardCheque(srvID, nymID, accID, cheque);
+	bool discard = _otapi(DiscardCheque(srvID, nymID, accID, cheque));
 	_info(discard);
 	if(!discard) return nUtils::reportError("Error while discarding cheque");
 
-	auto retrive = mMadeEasy->retrieve_account(srvID, nymID, accID, true);
+	auto retrive = _otme(retrieve_account(srvID, nymID, accID, true));
 	if(!retrive)
 		cout << "Can't refresh account!" << endl;
 
@@ -1621,7 +1905,7 @@ string cUseOT::ContractSign(const std::string & nymID, const std::string & contr
 	// FIXME can't sign contract with this (assetNew() functionality)
 	if(!Init())
 		return "";
-	return opentxs::OTAPI_Wrap::AddSignature(nymID, contract);
+	return _otapi(AddSignature(nymID, contract));
 }
 
 bool cUseOT::ContractSign(const string & nym, const string & filename, const string & outfilename, bool dryrun) {
@@ -1636,11 +1920,12 @@ bool cUseOT::ContractSign(const string & nym, const string & filename, const str
 	*/
 
 	string contract = GetInput(filename);
-	auto signedContract = opentxs::OTAPI_Wrap::SignContract(NymGetId(nym), contract);
+	auto signedContract = _otapi(SignContract(NymGetId(nym), contract));
+	if (signedContract.empty()) return reportError("Can't sign contract");
 
 	try {
 		nUtils::cEnvUtils envUtils;
-		envUtils.WriteToFile(filename, signedContract);
+		envUtils.WriteToFile(outfilename.empty() ? filename : outfilename, signedContract);
 	} catch(...) {
 		return reportError("Can't sign contract");
 	}
@@ -1648,6 +1933,66 @@ bool cUseOT::ContractSign(const string & nym, const string & filename, const str
 	return true;
 }
 
+bool cUseOT::ContractSignBatch(const string & nym, const string & dir, const string & glob, const string & outDir, bool dryrun) {
+	_fact("contract sign " << nym << " --dir " << dir << " --glob " << glob << " --out-dir " << outDir);
+	cFileBatch batch;
+	if (!batch.Find(dir, glob)) return false;
+	if (dryrun) { for (const auto & file : batch.GetFiles()) cout << file << endl; return true; }
+	if (!Init()) return false;
+
+	const ID nymID = NymGetId(nym); // once - OTAPI keeps the loaded nym (and its key) in the wallet for all the calls
+	if (nymID.empty()) return reportError("", nym, "Unknown nym " + nym);
+
+	std::mutex otapiMutex;
+	auto start = std::chrono::steady_clock::now();
+	auto results = batch.Run([&] (const string & contract, string & signedContract, string & detail) -> bool {
+		std::unique_lock<std::mutex> lock(otapiMutex, std::defer_lock);
+		if (!CFG_OTAPI_SIGN_THREADSAFE) lock.lock(); // files are still read and written in parallel
+		signedContract = _otapi(SignContract(nymID, contract));
+		if (signedContract.empty()) { detail = "OTAPI could not sign it"; return false; }
+		return true;
+	}, true, outDir);
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	cFileBatch::PrintReport(cout, results, seconds, "Signed");
+	return std::all_of(results.begin(), results.end(), [] (const cFileBatch::cResult & result) { return result.mOk; });
+}
+
+bool cUseOT::ContractVerify(const string & nym, const string & filename, const string & dir, const string & glob, bool dryrun) {
+	_fact("contract verify " << nym << " " << filename << " --dir " << dir << " --glob " << glob);
+	cFileBatch batch;
+	if (!dir.empty()) {
+		if (!batch.Find(dir, glob)) return false;
+	}
+	else if (filename.empty()) return reportError("Give file to verify, or --dir");
+	if (dryrun) return true;
+	if (!Init()) return false;
+
+	const ID nymID = NymGetId(nym);
+	if (nymID.empty()) return reportError("", nym, "Unknown nym " + nym);
+
+	if (dir.empty()) { // one file
+		const string contract = GetInput(filename);
+		if (!_otapi(VerifySignature(nymID, contract))) return reportError("", filename, "Signature of " + nym + " is NOT valid in " + filename);
+		cout << zkr::cc::fore::lightgreen << "Signature of " << nym << " is valid" << zkr::cc::console << endl;
+		return true;
+	}
+
+	std::mutex otapiMutex;
+	auto start = std::chrono::steady_clock::now();
+	auto results = batch.Run([&] (const string & contract, string &, string & detail) -> bool {
+		std::unique_lock<std::mutex> lock(otapiMutex, std::defer_lock);
+		if (!CFG_OTAPI_SIGN_THREADSAFE) lock.lock();
+		if (_otapi(VerifySignature(nymID, contract))) return true;
+		detail = "signature of " + nym + " is not valid";
+		return false;
+	}, false, "");
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	cFileBatch::PrintReport(cout, results, seconds, "Verified");
+	return std::all_of(results.begin(), results.end(), [] (const cFileBatch::cResult & result) { return result.mOk; });
+}
+
 bool cUseOT::MarketList(const string & srvName, const string & nymName, bool dryrun) {
 	_fact("market ls " << srvName << ", " << nymName);
 	if (dryrun) return true;
@@ -1664,7 +2009,7 @@ bool cUseOT::MarketList(const string & srvName, const string & nymName, bool dry
 		return false;
 	}
 
-	string marketList = mMadeEasy->get_market_list(serverID, nymID);
+	string marketList = _otme(get_market_list(serverID, nymID));
 	_dbg2("market list:" << marketList);
 	nUtils::DisplayStringEndl(cout, marketList);
 	return true;
@@ -1683,7 +2028,7 @@ bool cUseOT::MintShow(const string & srvName, const string & nymName, const stri
 	ID nymID = NymGetId(nymName);
 	ID assetID = AssetGetId(assetName);
 
-	const string mint = mMadeEasy->load_or_retrieve_mint(srvID, nymID, assetID);
+	const string mint = MintLoad(srvID, nymID, assetID);
 
 	auto &nocol = zkr::cc::fore::console;
 	auto &blue = zkr::cc::fore::blue;
@@ -1696,8 +2041,8 @@ vector<string> cUseOT::MsgGetAll() { ///< Get all messages from all Nyms. FIXME
 	if(!Init())
 	return vector<string> {};
 
-	for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetNymCount ();i++) {
-		MsgDisplayForNym( NymGetName( opentxs::OTAPI_Wrap::GetNym_ID(i) ), false );
+	for(int i = 0 ; i < _otapi(GetNymCount());i++) {
+		MsgDisplayForNym( NymGetName( _otapi(GetNym_ID(i)) ), false );
 	}
 	return vector<string> {};
 }
@@ -1720,9 +2065,9 @@ bool cUseOT::MsgDisplayForNym(const string & nymName, bool dryrun) { ///< Get al
 	nUtils::DisplayStringEndl(cout, "INBOX");
 	tpIn.PrintHeader();
 
-	for (int i = 0; i < opentxs::OTAPI_Wrap::GetNym_MailCount(nymID); i++) {
-		tpIn << i << NymGetName(opentxs::OTAPI_Wrap::GetNym_MailSenderIDByIndex(nymID, i))
-				<< opentxs::OTAPI_Wrap::GetNym_MailContentsByIndex(nymID, i);
+	for (int i = 0; i < _otapi(GetNym_MailCount(nymID)); i++) {
+		tpIn << i << NymGetName(_otapi(GetNym_MailSenderIDByIndex(nymID, i)))
+				<< _otapi(GetNym_MailContentsByIndex(nymID, i));
 	}
 	tpIn.PrintFooter();
 
@@ -1734,9 +2079,9 @@ bool cUseOT::MsgDisplayForNym(const string & nymName, bool dryrun) { ///< Get al
 	nUtils::DisplayStringEndl(cout, "OUTBOX");
 	tpOut.PrintHeader();
 
-	for (int i = 0; i < opentxs::OTAPI_Wrap::GetNym_OutmailCount(nymID); i++) {
-		tpOut << i << NymGetRecipientName(opentxs::OTAPI_Wrap::GetNym_OutmailRecipientIDByIndex(nymID, i))
-				<< opentxs::OTAPI_Wrap::GetNym_OutmailContentsByIndex(nymID, i);
+	for (int i = 0; i < _otapi(GetNym_OutmailCount(nymID)); i++) {
+		tpOut << i << NymGetRecipientName(_otapi(GetNym_OutmailRecipientIDByIndex(nymID, i)))
+				<< _otapi(GetNym_OutmailContentsByIndex(nymID, i));
 	}
 	tpOut.PrintFooter();
 	return true;
@@ -1775,15 +2120,15 @@ bool cUseOT::MsgDisplayForNymBox(eBoxType boxType, const string & nymName, int m
 	if (boxType == eBoxType::Inbox) {
 		nUtils::DisplayStringEndl(cout, "INBOX");
 
-		data_msg = opentxs::OTAPI_Wrap::GetNym_MailContentsByIndex(nymID, msg_index);
+		data_msg = _otapi(GetNym_MailContentsByIndex(nymID, msg_index));
 
 		if (data_msg.empty()) {
 			errMessage(msg_index,"inbox");
 			return false;
 		}
 
-		const string& data_from = NymGetRecipientName(opentxs::OTAPI_Wrap::GetNym_MailSenderIDByIndex(nymID, msg_index));
-		const string& data_server = ServerGetName(opentxs::OTAPI_Wrap::GetNym_MailNotaryIDByIndex(nymID, msg_index));
+		const string& data_from = NymGetRecipientName(_otapi(GetNym_MailSenderIDByIndex(nymID, msg_index)));
+		const string& data_server = ServerGetName(_otapi(GetNym_MailNotaryIDByIndex(nymID, msg_index)));
 
 		cout << col1 << "          To: " << col2 << nymName << endl;
 		cout << col1 << "        From: " << col2 << data_from << endl;
@@ -1791,15 +2136,15 @@ bool cUseOT::MsgDisplayForNymBox(eBoxType boxType, const string & nymName, int m
 
 	} else if (boxType == eBoxType::Outbox) {
 		nUtils::DisplayStringEndl(cout, "OUTBOX");
-		data_msg = opentxs::OTAPI_Wrap::GetNym_OutmailContentsByIndex(nymID, msg_index);
+		data_msg = _otapi(GetNym_OutmailContentsByIndex(nymID, msg_index));
 
 		if (data_msg.empty() ) {
 			errMessage(msg_index,"outbox");
 			return false;
 		}
 
-		const string& data_to = NymGetName(opentxs::OTAPI_Wrap::GetNym_OutmailRecipientIDByIndex(nymID, msg_index));
-		const string& data_server = ServerGetName(opentxs::OTAPI_Wrap::GetNym_OutmailNotaryIDByIndex(nymID, msg_index));
+		const string& data_to = NymGetName(_otapi(GetNym_OutmailRecipientIDByIndex(nymID, msg_index)));
+		const string& data_server = ServerGetName(_otapi(GetNym_OutmailNotaryIDByIndex(nymID, msg_index)));
 
 		// printing
 		cout << col1 << "          To: " << col2 << nymName << endl;
@@ -1842,30 +2187,47 @@ bool cUseOT::MsgSend(const string & nymSender, vector<string> nymRecipient, cons
 	}
 
 	ID senderID = NymGetId(nymSender);
+	const ID serverID = mDefaultIDs.at(nUtils::eSubjectType::Server);
 	vector<ID> recipientID;
-	for (auto varName : nymRecipient)
-		recipientID.push_back( NymGetToNymId(varName, senderID) );
-
-	for (auto varID : recipientID) {
-		_dbg1("Sending message from " + senderID + " to " + varID + "using server " + nUtils::SubjectType2String(nUtils::eSubjectType::Server) );
+	for (auto varName : nymRecipient) {
+		const ID varID = NymGetToNymId(varName, senderID);
+		if (varID.empty()) return nUtils::reportError(varName, "unknown recipient", "Unknown recipient nym " + varName); // before anything is sent
+		recipientID.push_back(varID);
+	}
 
-		string strResponse = mMadeEasy->send_user_msg ( mDefaultIDs.at(nUtils::eSubjectType::Server), senderID, varID, outMsg);
+	// all messages go to one notary, so the in-flight bound is per notary
+	nUtils::cFanOut::cReachable notary( [&] () { return _otapi(pingNotary(serverID, senderID)) > 0; } );
+	if (!notary.IsOk()) return nUtils::reportError(serverID, "notary not reachable", "Can not reach the server, no message was sent");
+	nUtils::cFanOut fanOut( CFG_OTAPI_SEND_THREADSAFE ? mMsgInFlightPerNotary : 1 );
+	auto statuses = fanOut.Run(recipientID, [&] (const ID & varID) -> nUtils::cFanOut::eResult {
+		if (!notary.BeforeSend()) return nUtils::cFanOut::eResult::transient; // surely not sent, so it can be retried
+		_dbg1("Sending message from " + senderID + " to " + varID + " using server " + serverID);
+		string strResponse = _otme(send_user_msg(serverID, senderID, varID, outMsg));
 
 		// -1 error, 0 failure, 1 success.
-		if (1 != mMadeEasy->VerifyMessageSuccess(strResponse)) {
-			_erro("Failed trying to send the message");
-			return false;
+		const int32_t result = strResponse.empty() ? -1 : _otme(VerifyMessageSuccess(strResponse));
+		if (result == 1) {
+			_dbg3("Message from " + senderID + " to " + varID + " was sent successfully.");
+			return nUtils::cFanOut::eResult::ok;
 		}
-		_dbg3("Message from " + senderID + " to " + varID + " was sent successfully.");
-	}
-	_info("All messages were sent successfully.");
-	return true;
+		if (result < 0) {
+			_warn("No reply for the message to " << varID << ", it may have been delivered - not sending it again");
+			notary.ReplyLost();
+		}
+		else _warn("Failed trying to send the message to " << varID << " (" << result << ")");
+		return nUtils::cFanOut::eResult::failed;
+	} );
+
+	const bool allOk = (nUtils::cFanOut::CountOk(statuses) == statuses.size());
+	if (statuses.size() > 1 || !allOk) nUtils::cFanOut::PrintSummary(cout, statuses, [this] (const ID & id) { return NymGetRecipientName(id); } );
+	if (allOk) _info("All messages were sent successfully.");
+	return allOk;
 }
 
 bool cUseOT::MsgInCheckIndex(const string & nymName, const int32_t & index) {
 	if(!Init())
 			return false;
-	if ( index >= 0 && index < opentxs::OTAPI_Wrap::GetNym_MailCount(NymGetId(nymName)) ) {
+	if ( index >= 0 && index < _otapi(GetNym_MailCount(NymGetId(nymName))) ) {
 		return true;
 	}
 	return false;
@@ -1874,7 +2236,7 @@ bool cUseOT::MsgInCheckIndex(const string & nymName, const int32_t & index) {
 bool cUseOT::MsgOutCheckIndex(const string & nymName, const int32_t & index) {
 	if(!Init())
 			return false;
-	if ( index >= 0 && index < opentxs::OTAPI_Wrap::GetNym_OutmailCount(NymGetId(nymName)) ) {
+	if ( index >= 0 && index < _otapi(GetNym_OutmailCount(NymGetId(nymName))) ) {
 		return true;
 	}
 	return false;
@@ -1884,7 +2246,7 @@ bool cUseOT::MsgInRemoveByIndex(const string & nymName, const int32_t & index, b
 	_fact("msg rm " << nymName << " index=" << index);
 	if (dryrun) return false;
 	if(!Init()) return false;
-	if(opentxs::OTAPI_Wrap::Nym_RemoveMailByIndex (NymGetId(nymName), index)){
+	if(_otapi(Nym_RemoveMailByIndex(NymGetId(nymName), index))){
 		_info("Message " << index << " removed successfully from " << nymName << " inbox");
 	return true;
 	}
@@ -1895,7 +2257,7 @@ bool cUseOT::MsgOutRemoveByIndex(const string & nymName, const int32_t & index,
 	_fact("msg rm-out " << nymName << " index=" << index);
 	if (dryrun) return false;
 	if(!Init()) return false;
-	if( opentxs::OTAPI_Wrap::Nym_RemoveOutmailByIndex(NymGetId(nymName), index) ) {
+	if( _otapi(Nym_RemoveOutmailByIndex(NymGetId(nymName), index)) ) {
 		_info("Message " << index << " removed successfully from " << nymName << " outbox");
 		return true;
 	}
@@ -1913,9 +2275,9 @@ bool cUseOT::NymCheck(const string & nymName, bool dryrun) { // wip
 
 	ID nymID = NymGetId(nymName);
 
-	string strResponse = mMadeEasy->check_nym( mDefaultIDs.at(nUtils::eSubjectType::Server), mDefaultIDs.at(nUtils::eSubjectType::User), nymID );
+	string strResponse = _otme(check_nym( mDefaultIDs.at(nUtils::eSubjectType::Server), mDefaultIDs.at(nUtils::eSubjectType::User), nymID ));
 	// -1 error, 0 failure, 1 success.
-	if (1 != mMadeEasy->VerifyMessageSuccess(strResponse)) {
+	if (1 != _otme(VerifyMessageSuccess(strResponse))) {
 		_erro("Failed trying to download public key for nym: " << nymName << "(" << nymID << ")" );
 		return false;
 	}
@@ -1936,7 +2298,7 @@ bool cUseOT::NymCreate(const string & nymName, bool registerOnServer, bool dryru
 	int32_t nKeybits = 1024;
 	string NYM_ID_SOURCE = ""; // TODO: check
 	string ALT_LOCATION = "";
-	string nymID = mMadeEasy->create_nym(nKeybits, NYM_ID_SOURCE, ALT_LOCATION);
+	string nymID = _otme(create_nym(nKeybits, NYM_ID_SOURCE, ALT_LOCATION));
 
 
 	if (nymID.empty()) {
@@ -1950,7 +2312,7 @@ bool cUseOT::NymCreate(const string & nymName, bool registerOnServer, bool dryru
 	 * and that must be passed in whenever he changes the name on any of the other nyms in his wallet.
  	 * (In order to properly sign and save the change.)
      */
-	if ( !opentxs::OTAPI_Wrap::SetNym_Name(nymID, nymID, nymName) ) {
+	if ( !_otapi(SetNym_Name(nymID, nymID, nymName)) ) {
 		_erro("Failed trying to name new Nym: " << nymID);
 		return false;
 	}
@@ -1958,7 +2320,7 @@ bool cUseOT::NymCreate(const string & nymName, bool registerOnServer, bool dryru
 	cout << zkr::cc::fore::lightgreen << "Nym " << nymName << "(" << nymID << ")" << " created successfully."
 			<< zkr::cc::console << endl;
 
-	mCache.mNyms.insert( std::make_pair(nymID, nymName) ); // insert nym to nyms cache
+	mCache.mNyms.Set(nymID, nymName); // insert nym to nyms cache
 
 	try {
 		auto defaultNym = NymGetDefault();
@@ -1980,6 +2342,84 @@ bool cUseOT::NymCreate(const string & nymName, bool registerOnServer, bool dryru
 	return ok;
 }
 
+bool cUseOT::NymCreateBulk(const string & namePattern, int count, bool registerOnServer, bool dryrun) {
+	_fact("nym new --count " << count << " --name-pattern " << namePattern << " register=" << registerOnServer);
+	if (count <= 0) return nUtils::reportError("", "count=" + ToStr(count), "Give positive --count of nyms to create");
+	const string placeholder = "{n}";
+	const string pattern = (namePattern.find(placeholder) == string::npos) ? namePattern + "-" + placeholder : namePattern;
+
+	vector<string> names;
+	for (int n = 1; n <= count; ++n) {
+		string name = pattern;
+		for (size_t pos = name.find(placeholder); pos != string::npos; pos = name.find(placeholder, pos))
+			name.replace(pos, placeholder.size(), ToStr(n));
+		names.push_back(name);
+	}
+	if (dryrun) { for (const auto & name : names) cout << name << endl; return true; }
+	if(!Init()) return false;
+
+	NymGetAll();
+	bool namesOk = true;
+	for (const auto & name : names) {
+		if (!mCache.mNyms.IdOf(name).empty()) namesOk = nUtils::reportError("", name, "Nym with name " + name + " exists");
+	}
+	if (!namesOk) return false;
+
+	ID serverID;
+	if (registerOnServer) {
+		try { serverID = ServerGetDefault(); } catch(...) { return nUtils::reportError("No default server, can't register nyms"); }
+	}
+
+	// keys: the slow part. Each create_nym also adds the nym to the wallet and saves it - OTAPI has no call to save once
+	auto start = std::chrono::steady_clock::now();
+	const vector<ID> nymIDs = nUtils::DecodeRowsParallel<ID>(count, [this] (size_t) -> ID {
+		return _otme(create_nym(1024, "", "")); // keybits, source, alt location - as in NymCreate
+	}, CFG_OTAPI_KEYGEN_THREADSAFE ? 0 : 1);
+	const double keygenSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t created = 0;
+	vector<ID> toRegister;
+	for (size_t i = 0; i < nymIDs.size(); ++i) {
+		const ID & nymID = nymIDs[i];
+		if (nymID.empty()) { nUtils::reportError("", names[i], "Failed trying to create new Nym: " + names[i]); continue; }
+		if (!_otapi(SetNym_Name(nymID, nymID, names[i]))) { nUtils::reportError("", nymID, "Failed trying to name new Nym: " + nymID); continue; }
+		mCache.mNyms.Set(nymID, names[i]);
+		toRegister.push_back(nymID);
+		++created;
+	}
+	cout << zkr::cc::fore::lightgreen << "Created " << created << " of " << count << " nyms (" << names.front() << " ... " << names.back() << ")"
+		<< " in " << keygenSec << " s" << zkr::cc::console << endl;
+
+	if (created) {
+		try {
+			NymGetDefault();
+		} catch (...) {
+			cout << "Setting " << mCache.mNyms.NameOf(toRegister.front()) << " as default nym." << endl;
+			NymSetDefault(mCache.mNyms.NameOf(toRegister.front()), false);
+		}
+	}
+
+	bool registeredOk = true;
+	if (registerOnServer && !toRegister.empty()) { // server requests are pipelined like in MsgSend
+		nUtils::cFanOut::cReachable notary( [&] () { return _otapi(pingNotary(serverID, toRegister.front())) > 0; } );
+		nUtils::cFanOut fanOut( CFG_OTAPI_SEND_THREADSAFE ? mMsgInFlightPerNotary : 1 );
+		auto statuses = fanOut.Run(toRegister, [&] (const ID & nymID) -> nUtils::cFanOut::eResult {
+			if (!notary.BeforeSend()) return nUtils::cFanOut::eResult::transient; // surely not sent, so it can be retried
+			const string response = _otme(register_nym(serverID, nymID));
+			const int32_t result = response.empty() ? -1 : _otme(VerifyMessageSuccess(response));
+			if (result == 1) return nUtils::cFanOut::eResult::ok;
+			if (result < 0) {
+				_warn("No reply registering nym " << nymID << ", it may have been registered - not sending it again");
+				notary.ReplyLost();
+			}
+			return nUtils::cFanOut::eResult::failed;
+		} );
+		nUtils::cFanOut::PrintSummary(cout, statuses, [this] (const ID & id) { return NymGetName(id); } );
+		registeredOk = (nUtils::cFanOut::CountOk(statuses) == statuses.size());
+	}
+	return (created == size_t(count)) && registeredOk;
+}
+
 bool cUseOT::NymExport(const string & nymName, const string & filename, bool dryrun) {
 	if(dryrun) return true;
 	if(!Init()) return false;
@@ -1987,7 +2427,7 @@ bool cUseOT::NymExport(const string & nymName, const string & filename, bool dry
 	std::string nymID = NymGetId(nymName);
 	_fact("nym export: " << nymName << ", id: " << nymID);
 
-	std::string exported = opentxs::OTAPI_Wrap::Wallet_ExportNym(nymID);
+	std::string exported = _otapi(Wallet_ExportNym(nymID));
 	// FIXME Bug in OTAPI? Can't export nym twice
 
 	if(exported.empty()) {
@@ -2028,7 +2468,7 @@ bool cUseOT::NymImport(const string & filename, bool dryrun) {
 	return false; // XXX
 
 	// FIXME: segfault!
-	auto nym = opentxs::OTAPI_Wrap::Wallet_ImportNym(toImport);
+	auto nym = _otapi(Wallet_ImportNym(toImport));
 	//cout << nym << endl;
 
 	return true;
@@ -2038,18 +2478,24 @@ void cUseOT::NymGetAll(bool force) {
 	if(!Init())
 		return;
 
-	int32_t cacheSize = mCache.mNyms.size();
-	auto nymCount = opentxs::OTAPI_Wrap::GetNymCount();
+	if (mWalletWatcher && mWalletWatcher->IsActive()) { // watcher drops the cache when nyms change
+		if (mCache.mNymsLoaded && !force) return;
+		force = true;
+	}
+
+	int32_t cacheSize = mCache.mNyms.Size();
+	auto nymCount = force ? 0 : _otapi(GetNymCount());
 
 	if (force || cacheSize != nymCount) { //TODO optimize?
-		mCache.mNyms.clear();
+		mCache.mNyms.Clear();
 		_dbg3("Reloading nyms cache");
-		for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetNymCount();i++) {
-			string nym_ID = opentxs::OTAPI_Wrap::GetNym_ID (i);
-			string nym_Name = opentxs::OTAPI_Wrap::GetNym_Name (nym_ID);
+		for(int i = 0 ; i < _otapi(GetNymCount());i++) {
+			string nym_ID = _otapi(GetNym_ID(i));
+			string nym_Name = _otapi(GetNym_Name(nym_ID));
 
-			mCache.mNyms.insert( std::make_pair(nym_ID, nym_Name) );
+			mCache.mNyms.Set(nym_ID, nym_Name);
 		}
+		mCache.mNymsLoaded = true;
 	}
 }
 
@@ -2057,22 +2503,14 @@ vector<string> cUseOT::NymGetAllIDs() {
 	if(!Init())
 		return vector<string> {};
 	NymGetAll();
-	vector<string> IDs;
-	for (auto val : mCache.mNyms) {
-		IDs.push_back(val.first);
-	}
-	return IDs;
+	return mCache.mNyms.GetIds();
 }
 
 vector<string> cUseOT::NymGetAllNames() {
 	if(!Init())
 		return vector<string> {};
 	NymGetAll();
-	vector<string> names;
-	for (auto val : mCache.mNyms) {
-		names.push_back(val.second);
-	}
-	return names;
+	return mCache.mNyms.GetNames();
 }
 
 bool cUseOT::NymDisplayAll(bool dryrun) {
@@ -2081,7 +2519,7 @@ bool cUseOT::NymDisplayAll(bool dryrun) {
 	if(!Init()) return false;
 
 	NymGetAll();
-	nUtils::DisplayMap(cout, mCache.mNyms);// display Nyms cache
+	nUtils::DisplayMap(cout, mCache.mNyms.ToMap());// display Nyms cache
 
 	return true;
 }
@@ -2102,16 +2540,16 @@ string cUseOT::NymGetId(const string & nymName) { // Gets nym aliases and IDs be
 	if ( nUtils::checkPrefix(nymName) ) // nym ID
 		return nymName.substr(1);
 	else { // look in cache
-		string key = nUtils::FindMapValue(mCache.mNyms, nymName);
+		string key = mCache.mNyms.IdOf(nymName);
 		if(!key.empty()){
 			_dbg3("Found nymID in cache");
 			return key;
 		}
 	}
 
-	for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetNymCount ();i++) {
-		string nymID = opentxs::OTAPI_Wrap::GetNym_ID (i);
-		string nymName_ = opentxs::OTAPI_Wrap::GetNym_Name (nymID);
+	for(int i = 0 ; i < _otapi(GetNymCount());i++) {
+		string nymID = _otapi(GetNym_ID(i));
+		string nymName_ = _otapi(GetNym_Name(nymID));
 		if (nymName_ == nymName)
 			return nymID;
 	}
@@ -2128,7 +2566,7 @@ bool cUseOT::NymDisplayInfo(const string & nymName, bool dryrun) {
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	cout << opentxs::OTAPI_Wrap::GetNym_Stats( NymGetId(nymName) );
+	cout << _otapi(GetNym_Stats( NymGetId(nymName) ));
 	return true;
 }
 
@@ -2142,7 +2580,7 @@ string cUseOT::NymGetName(const ID & nymID) {
 		return AddressBookStorage::GetNymName(nymID, vector);
 	}
 
-	return opentxs::OTAPI_Wrap::GetNym_Name(nymID);
+	return _otapi(GetNym_Name(nymID));
 }
 
 string cUseOT::NymGetRecipientName(const ID & nymID) {
@@ -2163,10 +2601,10 @@ bool cUseOT::NymRefresh(const string & nymName, bool all, bool dryrun) { //TODO
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	int32_t serverCount = opentxs::OTAPI_Wrap::GetServerCount();
+	int32_t serverCount = _otapi(GetServerCount());
 	if (all) {
 		int32_t nymsRetrieved = 0;
-		int32_t nymCount = opentxs::OTAPI_Wrap::GetNymCount();
+		int32_t nymCount = _otapi(GetNymCount());
 		if (nymCount == 0){
 			_warn("No Nyms to retrieve");
 			return true;
@@ -2174,10 +2612,10 @@ bool cUseOT::NymRefresh(const string & nymName, bool all, bool dryrun) { //TODO
 
 		for (int32_t serverIndex = 0; serverIndex < serverCount; ++serverIndex) { // FIXME Working for all available servers!
 			for (int32_t nymIndex = 0; nymIndex < nymCount; ++nymIndex) {
-				ID nymID = opentxs::OTAPI_Wrap::GetNym_ID(nymIndex);
-				ID serverID = opentxs::OTAPI_Wrap::GetServer_ID(serverIndex);
-				if (opentxs::OTAPI_Wrap::IsNym_RegisteredAtServer(nymID, serverID)) {
-					if ( mMadeEasy->retrieve_nym(serverID, nymID, true) ){ // forcing download
+				ID nymID = _otapi(GetNym_ID(nymIndex));
+				ID serverID = _otapi(GetServer_ID(serverIndex));
+				if (_otapi(IsNym_RegisteredAtServer(nymID, serverID))) {
+					if ( _otme(retrieve_nym(serverID, nymID, true)) ){ // forcing download
 						_info("Nym " + NymGetName(nymID) + "(" + nymID +  ")" + " retrieval success from server " + ServerGetName(serverID) + "(" + serverID +  ")");
 						++nymsRetrieved;
 					} else
@@ -2200,9 +2638,9 @@ bool cUseOT::NymRefresh(const string & nymName, bool all, bool dryrun) { //TODO
 	else {
 		ID nymID = NymGetId(nymName);
 		for (int32_t serverIndex = 0; serverIndex < serverCount; ++serverIndex) { // Working for all available servers!
-			ID serverID = opentxs::OTAPI_Wrap::GetServer_ID(serverIndex);
-			if (opentxs::OTAPI_Wrap::IsNym_RegisteredAtServer(nymID, serverID)) {
-				if ( mMadeEasy->retrieve_nym(serverID,nymID, true) ) { // forcing download
+			ID serverID = _otapi(GetServer_ID(serverIndex));
+			if (_otapi(IsNym_RegisteredAtServer(nymID, serverID))) {
+				if ( _otme(retrieve_nym(serverID,nymID, true)) ) { // forcing download
 					_info("Nym " + nymName + "(" + nymID +  ")" + " retrieval success from server " + ServerGetName(serverID) + "(" + serverID +  ")");
 					return true;
 				}
@@ -2222,10 +2660,10 @@ bool cUseOT::NymRegister(const string & nymName, const string & serverName, bool
 	ID nymID = NymGetId(nymName);
 	ID serverID = ServerGetId(serverName);
 
-	if (!opentxs::OTAPI_Wrap::IsNym_RegisteredAtServer(nymID, serverID) || force) {
-		string response = mMadeEasy->register_nym(serverID, nymID);
+	if (!_otapi(IsNym_RegisteredAtServer(nymID, serverID)) || force) {
+		string response = _otme(register_nym(serverID, nymID));
 
-		if(mMadeEasy->VerifyMessageSuccess(response) != 1) {
+		if(_otme(VerifyMessageSuccess(response)) != 1) {
 			return reportError(response, "error register nym: " + nymName, "Can't register nym " + nymName);
 		}
 
@@ -2246,12 +2684,12 @@ bool cUseOT::NymRemove(const string & nymName, bool force, bool dryrun) {
 	if(!Init()) return false;
 
 	string nymID = NymGetId(nymName);
-	if ( opentxs::OTAPI_Wrap::Wallet_CanRemoveNym(nymID) || force) {
-		if ( opentxs::OTAPI_Wrap::Wallet_RemoveNym(nymID) ) {
+	if ( _otapi(Wallet_CanRemoveNym(nymID)) || force) {
+		if ( _otapi(Wallet_RemoveNym(nymID)) ) {
 			cout << zkr::cc::fore::green << "Nym " << nymName << " was deleted successfully" << zkr::cc::console
 					<< endl;
 			_info(nymName << " deleted");
-			mCache.mNyms.erase(nymID);
+			mCache.mNyms.Erase(nymID);
 			return true;
 		}
 	}
@@ -2262,7 +2700,7 @@ bool cUseOT::NymRemove(const string & nymName, bool force, bool dryrun) {
 bool cUseOT::NymSetName(const ID & nymID, const string & newNymName) { //TODO: passing to function: const string & nymName, const string & signerNymName,
 	if(!Init()) return false;
 
-	if ( !opentxs::OTAPI_Wrap::SetNym_Name(nymID, nymID, newNymName) ) {
+	if ( !_otapi(SetNym_Name(nymID, nymID, newNymName)) ) {
 		_erro("Failed trying to set name " << newNymName << " to nym " << nymID);
 		return false;
 	}
@@ -2279,7 +2717,7 @@ bool cUseOT::NymRename(const string & nym, const string & newNymName, bool dryru
 
 	if( NymSetName(nymID, newNymName) ) {
 		_info("Nym " << NymGetName(nymID) << "(" << nymID << ")" << " renamed to " << newNymName);
-		mCache.mNyms.insert( std::make_pair(nymID, newNymName) ); // insert nym to nyms cache
+		mCache.mNyms.Set(nymID, newNymName); // rename in nyms cache
 		return true;
 	}
 	_erro("Failed to rename Nym " << NymGetName(nymID) << "(" << nymID << ")" << " to " << newNymName);
@@ -2305,14 +2743,14 @@ bool cUseOT::NymUnregister(const string &nym, const string & server, bool force,
 	const ID nymID = NymGetId(nym);
 	const ID srvID = ServerGetId(server);
 
-	if(!opentxs::OTAPI_Wrap::IsNym_RegisteredAtServer(nymID, srvID)) {
+	if(!_otapi(IsNym_RegisteredAtServer(nymID, srvID))) {
 		cout << zkr::cc::fore::red << "Nym " << nym << " wasn't register at server " << server << zkr::cc::console
 				<< endl;
 		if(force) cout << "Trying unregister nym" << endl;
 		else return false;
 	}
 
-	auto unregister = opentxs::OTAPI_Wrap::unregisterNym(srvID, nymID);
+	auto unregister = _otapi(unregisterNym(srvID, nymID));
 	_note("unregister: " << unregister);
 	return unregister == 1;
 
@@ -2322,9 +2760,9 @@ bool cUseOT::OutpaymentDiscard(const string & acc, const string & nym, const int
 	if(dryrun) return true;
 
 	const ID nymID = NymGetId(nym);
-	const auto outpayment = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(nymID, index);
+	const auto outpayment = _otapi(GetNym_OutpaymentsContentsByIndex(nymID, index));
 
-	auto type = opentxs::OTAPI_Wrap::Instrmnt_GetType(outpayment);
+	auto type = _otapi(Instrmnt_GetType(outpayment));
 	_dbg2(type);
 
 	cout << zkr::cc::fore::cyan << "Discarding " << type << " for nym: " << nym << zkr::cc::console << " (" << nymID
@@ -2349,14 +2787,14 @@ bool cUseOT::OutpaymentDiscard(const string & acc, const string & nym, const int
 bool cUseOT::OutpaymentCheckIndex(const string & nymName, const int32_t & index) {
 	if(!Init()) return false;
 	if(index < 0) return false;
-	if(index < opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(NymGetId(nymName)) )
+	if(index < _otapi(GetNym_OutpaymentsCount(NymGetId(nymName))) )
 		return true;
 
 	return false;
 }
 
 int32_t cUseOT::OutpaymantGetCount(const string & nym) {
-	const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(NymGetId(nym));
+	const auto count = _otapi(GetNym_OutpaymentsCount(NymGetId(nym)));
 	return (count <= 0) ? -1 : count;
 }
 
@@ -2367,7 +2805,7 @@ bool cUseOT::OutpaymentDisplay(const string & nym, bool dryrun) {
 
 	ID nymID = NymGetId(nym);
 
-	auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(nymID);
+	auto count = _otapi(GetNym_OutpaymentsCount(nymID));
 
 	if(count <= 0) {
 		cout << zkr::cc::fore::lightblue << "No outpayments for nym: " << nym << zkr::cc::console << endl;
@@ -2389,23 +2827,35 @@ bool cUseOT::OutpaymentDisplay(const string & nym, bool dryrun) {
 	table.AddColumn("Amount", 10);
 	table.PrintHeader();
 
+	cLedgerMirror mirror( LedgerMirrorFile("outpayments-" + nymID), 3 ); // only new/changed instruments are decoded
+	map<string, int64_t> occurrences; // of the same contents - identical outpayments are separate rows
 	for (int32_t i = 0; i<count; i++) {
-		auto instr = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(nymID,i);
-		auto to = NymGetRecipientName(opentxs::OTAPI_Wrap::GetNym_OutpaymentsRecipientIDByIndex(nymID,i));
-		auto type = opentxs::OTAPI_Wrap::Instrmnt_GetType(instr);
-		auto asset = AssetGetName(opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(instr));
-		auto amount = opentxs::OTAPI_Wrap::Instrmnt_GetAmount(instr);
-		auto srvID = opentxs::OTAPI_Wrap::Instrmnt_GetNotaryID(instr);
+		auto instr = _otapi(GetNym_OutpaymentsContentsByIndex(nymID,i));
+		auto recipientID = _otapi(GetNym_OutpaymentsRecipientIDByIndex(nymID,i));
+		const string contents = recipientID + instr;
+		const string key = cLedgerMirror::Key(occurrences[cLedgerMirror::Key(contents)]++, contents); // not the index: removing one does not move the others
+		cLedgerMirror::tRow row; // type, assetID, amount
+		if (!mirror.Get(key, row)) {
+			auto type = _otapi(Instrmnt_GetType(instr));
+			auto assetID = _otapi(Instrmnt_GetInstrumentDefinitionID(instr));
+			auto amount = _otapi(Instrmnt_GetAmount(instr));
+			row = { type, assetID, ToStr(amount) };
+			mirror.Put(key, row);
+		}
+		const bool verified = _otapi(Nym_VerifyOutpaymentsByIndex(nymID, i)); // not mirrored: it is about the box, not the contents
+		auto to = NymGetRecipientName(recipientID);
+		auto asset = AssetGetName(row.at(1));
 
 		if(to == nym) table.SetContentColor(color);
 		else table.SetContentColor(nocolor);
-		if(!opentxs::OTAPI_Wrap::Nym_VerifyOutpaymentsByIndex(nymID, i))
+		if(!verified)
 			table.SetContentColor(err);
 
 
-		table << i << to << type << asset << amount;
+		table << i << to << row.at(0) << asset << row.at(2);
 	}
 	table.PrintFooter();
+	mirror.Save();
 	cout << zkr::cc::console << endl;
 
 	return true;
@@ -2417,7 +2867,7 @@ bool cUseOT::OutpaymentRemove(const string & nym, const int32_t & index, bool al
 	if(!Init()) return false;
 
 	const auto nymID = NymGetId(nym);
-	const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(nymID);
+	const auto count = _otapi(GetNym_OutpaymentsCount(nymID));
 
 	if(count == 0) {
 		cout << zkr::cc::fore::yellow << "Can't remove. Outpayment box is empty!" << zkr::cc::console << endl;
@@ -2428,10 +2878,10 @@ bool cUseOT::OutpaymentRemove(const string & nym, const int32_t & index, bool al
 
 	if(all) {
 		for(int32_t i = count - 1; i >= 0; --i)
-			ok = ok && opentxs::OTAPI_Wrap::Nym_RemoveOutpaymentsByIndex(nymID, i);
+			ok = ok && _otapi(Nym_RemoveOutpaymentsByIndex(nymID, i));
 	}
 	else
-		ok = opentxs::OTAPI_Wrap::Nym_RemoveOutpaymentsByIndex(nymID, index);
+		ok = _otapi(Nym_RemoveOutpaymentsByIndex(nymID, index));
 
 	if(ok) cout << zkr::cc::fore::lightgreen << "Operation successful" << zkr::cc::console << endl;
 
@@ -2443,7 +2893,7 @@ bool cUseOT::OutpaymentSend(const string & senderNym, const string & recipientNy
 	if (dryrun)	return true;
 	if (!Init()) return false;
 
-	const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(NymGetId(senderNym));
+	const auto count = _otapi(GetNym_OutpaymentsCount(NymGetId(senderNym)));
 	if(count <= 0 ) {
 		cout << "Empty payment box, aborting" << endl;
 		return false;
@@ -2468,7 +2918,7 @@ bool cUseOT::OutpaymentSend(const string & senderNym, const string & recipientNy
 	const ID senderNymID = NymGetId(senderNym);
 	const ID recNymID = NymGetToNymId(recipientNym, senderNymID);
 
-	const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(senderNymID);
+	const auto count = _otapi(GetNym_OutpaymentsCount(senderNymID));
 
 	if (index < 0 || index >= count) {
 		_erro("index: " << index << ", count: " << count);
@@ -2477,22 +2927,22 @@ bool cUseOT::OutpaymentSend(const string & senderNym, const string & recipientNy
 		return false;
 	}
 
-	const auto payment = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(senderNymID, index);
+	const auto payment = _otapi(GetNym_OutpaymentsContentsByIndex(senderNymID, index));
 
 	cout << endl << endl;
 	PrintInstrumentInfo(payment);
 
-	const ID srvID = opentxs::OTAPI_Wrap::Instrmnt_GetNotaryID(payment);
+	const ID srvID = _otapi(Instrmnt_GetNotaryID(payment));
 
 	cout << zkr::cc::fore::yellow << "\n\n Sending to nym: " << recipientNym << zkr::cc::fore::console << endl;
 
-	auto send = mMadeEasy->send_user_payment(srvID, senderNymID, recNymID, payment);
+	auto send = _otme(send_user_payment(srvID, senderNymID, recNymID, payment));
 
-	auto refreshSender = mMadeEasy->retrieve_nym(srvID, senderNymID, true);
-	auto status = mMadeEasy->VerifyMessageSuccess(send);
+	auto refreshSender = _otme(retrieve_nym(srvID, senderNymID, true));
+	auto status = _otme(VerifyMessageSuccess(send));
 
 	if(status < 0) {
-        auto harvest = opentxs::OTAPI_Wrap::Msg_HarvestTransactionNumbers(send, senderNymID, false, false, false, false, false); // XXX
+        auto harvest = _otapi(Msg_HarvestTransactionNumbers(send, senderNymID, false, false, false, false, false)); // XXX
         _dbg1("harvest = " << harvest);
 		return nUtils::reportError(ToStr(status), "status", "Can't send this payment");
 	}
@@ -2508,22 +2958,22 @@ bool cUseOT::OutpaymentShow(const string & nym, int32_t index, bool dryrun) {
 		return false;
 
 	const ID nymID = NymGetId(nym);
-	const auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(nymID);
+	const auto count = _otapi(GetNym_OutpaymentsCount(nymID));
 
 	if (count <= 0) {
 		cout << zkr::cc::fore::lightred << "Empty outpayment box!" << zkr::cc::console << endl;
 		return false;
 	}
 
-	auto outpayment = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(nymID, index);
-	auto srv = opentxs::OTAPI_Wrap::GetNym_OutpaymentsNotaryIDByIndex(nymID, index);
-	auto rec = opentxs::OTAPI_Wrap::GetNym_OutpaymentsRecipientIDByIndex(nymID, index);
+	auto outpayment = _otapi(GetNym_OutpaymentsContentsByIndex(nymID, index));
+	auto srv = _otapi(GetNym_OutpaymentsNotaryIDByIndex(nymID, index));
+	auto rec = _otapi(GetNym_OutpaymentsRecipientIDByIndex(nymID, index));
 
 	cout << zkr::cc::fore::lightblue << outpayment << zkr::cc::console << endl;
 
 	PrintInstrumentInfo(outpayment);
 
-	(opentxs::OTAPI_Wrap::Nym_VerifyOutpaymentsByIndex(nymID, index)) ?
+	(_otapi(Nym_VerifyOutpaymentsByIndex(nymID, index))) ?
 			cout << zkr::cc::fore::green << "\nverification successfull" :
 			cout << zkr::cc::fore::lightred << "\nverification failed";
 
@@ -2538,17 +2988,17 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool all, bool
 	if (!Init()) return false;
 
 	auto accID = AccountGetId(account);
-	auto srvID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accID);
-	auto nymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accID);
+	auto srvID = _otapi(GetAccountWallet_NotaryID(accID));
+	auto nymID = _otapi(GetAccountWallet_NymID(accID));
 
 	if (all) {
-		string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(srvID, nymID); // Returns NULL, or an inbox.
+		string paymentInbox = _otapi(LoadPaymentInbox(srvID, nymID)); // Returns NULL, or an inbox.
 		if (paymentInbox.empty())
 			return nUtils::reportError("accept_from_paymentbox: OT_API_LoadPaymentInbox Failed.");
 
 		_dbg3("Get size of inbox ledger");
 
-		int32_t nCount = opentxs::OTAPI_Wrap::Ledger_GetCount(srvID, nymID, nymID, paymentInbox);
+		int32_t nCount = _otapi(Ledger_GetCount(srvID, nymID, nymID, paymentInbox));
 		bool ok = true;
 
 		for(int32_t i=nCount-1; i>=0; --i) {
@@ -2576,9 +3026,9 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 		return false;
 
 	const ID accountID = AccountGetId(account);
-	const ID accountNymID = opentxs::OTAPI_Wrap::GetAccountWallet_NymID(accountID);
-	const ID accountAssetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accountID);
-	const ID accountServerID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accountID);
+	const ID accountNymID = _otapi(GetAccountWallet_NymID(accountID));
+	const ID accountAssetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accountID));
+	const ID accountServerID = _otapi(GetAccountWallet_NotaryID(accountID));
 
 
 	_dbg1("nym: " << NymGetName(accountNymID) << ", acc: " << account);
@@ -2594,14 +3044,14 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 
 	_dbg3("Loading payment inbox");
 
-	string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(accountServerID, accountNymID); // Returns NULL, or an inbox.
+	string paymentInbox = _otapi(LoadPaymentInbox(accountServerID, accountNymID)); // Returns NULL, or an inbox.
 
 	if (paymentInbox.empty())
 		return nUtils::reportError("accept_from_paymentbox: OT_API_LoadPaymentInbox Failed.");
 
 	_dbg3("Get size of inbox ledger");
 
-	int32_t nCount = opentxs::OTAPI_Wrap::Ledger_GetCount(accountServerID, accountNymID, accountNymID, paymentInbox);
+	int32_t nCount = _otapi(Ledger_GetCount(accountServerID, accountNymID, accountNymID, paymentInbox));
 	if (nCount < 0)
 		return nUtils::reportError("Unable to retrieve size of payments inbox ledger. (Failure.)\n");
 
@@ -2614,7 +3064,7 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 
 	ASRT(index >= 0);
 /*
-	int32_t nIndicesCount = VerifyStringVal(strIndices) ? opentxs::OTAPI_Wrap::NumList_Count(strIndices) : 0;
+	int32_t nIndicesCount = VerifyStringVal(strIndices) ? _otapi(NumList_Count(strIndices)) : 0;
 
 	 Either we loop through all the instruments and accept them all, or
 	 we loop through all the instruments and accept the specified indices.
@@ -2629,7 +3079,7 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 		 //
 		 // - If NO indices are specified, accept all the ones matching MyAcct's asset type.
 		 //
-		 if ((nIndicesCount > 0) && !opentxs::OTAPI_Wrap::NumList_VerifyQuery(strIndices, ToStr(nIndex))) {
+		 if ((nIndicesCount > 0) && !_otapi(NumList_VerifyQuery(strIndices, ToStr(nIndex)))) {
 				 //          continue  // apparently not supported by the language.
 				 bContinue = true;
 		 }
@@ -2642,12 +3092,12 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 
 	// strInbox is optional and avoids having to load it multiple times. This function will just load it itself, if it has to.
 
-	string instrument = mMadeEasy->get_payment_instrument(accountServerID, accountNymID, index, paymentInbox);
+	string instrument = _otme(get_payment_instrument(accountServerID, accountNymID, index, paymentInbox));
 	if (instrument.empty())
 		return nOT::nUtils::reportError("Unable to get payment instrument based on index: " + ToStr(index));
 
 	_dbg3("Get type of instrument");
-	string strType = opentxs::OTAPI_Wrap::Instrmnt_GetType(instrument);
+	string strType = _otapi(Instrmnt_GetType(instrument));
 
 	if (strType.empty())
 		return nOT::nUtils::reportError("Unable to determine instrument's type. Expected CHEQUE, VOUCHER, INVOICE, or (cash) PURSE");
@@ -2666,7 +3116,7 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 	// Not all instruments have a specified recipient. But if they do, let's make
 	// sure the Nym matches.
 
-	string recipientNymID = opentxs::OTAPI_Wrap::Instrmnt_GetRecipientNymID(instrument);
+	string recipientNymID = _otapi(Instrmnt_GetRecipientNymID(instrument));
 
 	_dbg1("recNym: " << NymGetRecipientName(recipientNymID));
 	/*
@@ -2675,11 +3125,11 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 	 + NymGetName(recipientNymID) + ") and that doesn't match the account's owner Nym ("
 	 + AccountGetName(accountNymID) + "). (Skipping.)");
 
-	 opentxs::OTAPI_Wrap::Output(0, "The instrument " + ToStr(index) + " is endorsed to a specific recipient (" + recipientNymID + ") and that doesn't match the account's owner Nym (" + accountNymID + "). (Skipping.) \n");
+	 _otapi(Output(0, "The instrument " + ToStr(index) + " is endorsed to a specific recipient (" + recipientNymID + ") and that doesn't match the account's owner Nym (" + accountNymID + "). (Skipping.) \n"));
 	 return false;
 	 }*/
 	_dbg3("Get instrument assetID");
-	string instrumentAssetType = opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(instrument);
+	string instrumentAssetType = _otapi(Instrmnt_GetInstrumentDefinitionID(instrument));
 
 	if (accountAssetID != instrumentAssetType) {
 		return nOT::nUtils::reportError(
@@ -2688,22 +3138,22 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 
 	_dbg3("Check if instrument is valid");
 
-	time64_t tFrom = opentxs::OTAPI_Wrap::Instrmnt_GetValidFrom(instrument);
-	time64_t tTo = opentxs::OTAPI_Wrap::Instrmnt_GetValidTo(instrument);
-	time64_t tTime = opentxs::OTAPI_Wrap::GetTime();
+	time64_t tFrom = _otapi(Instrmnt_GetValidFrom(instrument));
+	time64_t tTo = _otapi(Instrmnt_GetValidTo(instrument));
+	time64_t tTime = _otapi(GetTime());
 
 	if (tTime < tFrom)
 		return nUtils::reportError("The instrument at index " + ToStr(index) + " is not yet within its valid date range");
 
 	if (tTo > OT_TIME_ZERO && tTime > tTo) {
-		opentxs::OTAPI_Wrap::Output(0,
-				"The instrument at index " + ToStr(index) + " is expired. (Moving it to the record box.)\n");
+		_otapi(Output(0,
+				"The instrument at index " + ToStr(index) + " is expired. (Moving it to the record box.)\n"));
 		nOT::nUtils::reportError("The instrument at index " + ToStr(index) + " is expired. (Moving it to the record box.)");
 		// Since this instrument is expired, remove it from the payments inbox, and move to record box.
 		_dbg3("Expired instrument - moving into record inbox");
 		// Note: this harvests
-		if ((index >= 0) && opentxs::OTAPI_Wrap::RecordPayment(accountServerID, accountNymID, true, // bIsInbox = true;
-				index, true)) { // bSaveCopy = true. (Since it's expired, it'll go into the expired box.)
+		if ((index >= 0) && _otapi(RecordPayment(accountServerID, accountNymID, true, // bIsInbox = true;
+				index, true))) { // bSaveCopy = true. (Since it's expired, it'll go into the expired box.)
 			return false;
 		}
 		return false;
@@ -2722,12 +3172,12 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 
 	PrintInstrumentInfo(instrument);
 	if ("CHEQUE" == strType || "VOUCHER" == strType) {
-		const auto deposit = mMadeEasy->deposit_cheque(accountServerID, accountNymID, accountID, instrument);
-		const auto status = mMadeEasy->VerifyMessageSuccess(deposit);
+		const auto deposit = _otme(deposit_cheque(accountServerID, accountNymID, accountID, instrument));
+		const auto status = _otme(VerifyMessageSuccess(deposit));
 
 		_dbg3(deposit);
 
-		auto refreshRecipient = mMadeEasy->retrieve_account(accountServerID, accountNymID, accountID, true);
+		auto refreshRecipient = _otme(retrieve_account(accountServerID, accountNymID, accountID, true));
 		if (!refreshRecipient)
 			_warn("Can't refresh recipient account: " << AccountGetName(accountID) << ", owner nym: " << NymGetName(accountNymID));
 
@@ -2748,14 +3198,14 @@ bool cUseOT::PaymentAccept(const string & account, int64_t index, bool dryrun) {
 		// remove it from payments inbox and move it to the recordbox.
 		//
 		if ((index != -1) && (1 == nDepositPurse)) {
-			auto recorded = opentxs::OTAPI_Wrap::RecordPayment(accountServerID, accountNymID, true, //bIsInbox=true
-					index, true); // bSaveCopy=true.
+			auto recorded = _otapi(RecordPayment(accountServerID, accountNymID, true, //bIsInbox=true
+					index, true)); // bSaveCopy=true.
 			_dbg3("recorded: " << recorded);
 			if(!recorded) _warn("can't record this payment!");
 		}
 		return true;
 	}
-	opentxs::OTAPI_Wrap::Output(0, "\nSkipping this instrument: Expected CHEQUE, VOUCHER, INVOICE, or (cash) PURSE.\n");
+	_otapi(Output(0, "\nSkipping this instrument: Expected CHEQUE, VOUCHER, INVOICE, or (cash) PURSE.\n"));
 
 	return false;
 }
@@ -2768,16 +3218,16 @@ bool cUseOT::PaymentShow(const string & nym, const string & server, bool dryrun)
 	ID nymID = NymGetId(nym);
 	ID serverID = ServerGetId(server);
 
-	string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(serverID, nymID); // Returns NULL, or an inbox.
+	string paymentInbox = _otapi(LoadPaymentInbox(serverID, nymID)); // Returns NULL, or an inbox.
 
 	if (paymentInbox.empty()) {
 		DisplayStringEndl(cout, "Unable to load the payments inbox (probably doesn't exist yet.)\n(Nym/Server: " + nym + " / " + server + " )");
 		return false;
 	}
 
-  int32_t count = opentxs::OTAPI_Wrap::Ledger_GetCount(serverID, nymID, nymID, paymentInbox);
+  int32_t count = _otapi(Ledger_GetCount(serverID, nymID, nymID, paymentInbox));
 	if (count > 0) {
-		opentxs::OTAPI_Wrap::Output(0, "Show payments inbox (Nym/Server)\n( " + nym + " / " + server + " )\n");
+		_otapi(Output(0, "Show payments inbox (Nym/Server)\n( " + nym + " / " + server + " )\n"));
 		bprinter::TablePrinter tp(&std::cout);
 		tp.AddColumn("ID", 4);
 		tp.AddColumn("Amount", 10);
@@ -2786,44 +3236,63 @@ bool cUseOT::PaymentShow(const string & nym, const string & server, bool dryrun)
 		tp.AddColumn("Asset Type", 60);
 		tp.PrintHeader();
 
+		cLedgerMirror mirror( LedgerMirrorFile("paymentinbox-" + serverID + "-" + nymID), 3 ); // only new/changed transactions are decoded
+		vector<int64_t> transNumbers(count);
+		vector<string> keys(count);
+		vector<cLedgerMirror::tRow> rows(count); // formattedAmount, instrumentType, instrAssetID
+		vector<int32_t> missing; // indexes to decode
+		vector<string> missingInstruments;
 		for (int32_t index = 0; index < count; ++index)
 		{
-			string instrument = opentxs::OTAPI_Wrap::Ledger_GetInstrument(serverID, nymID, nymID, paymentInbox, index);
-
-			if (instrument.empty()) {
-				 opentxs::OTAPI_Wrap::Output(0, "Failed trying to get payment instrument from payments box.\n");
-				 return false;
-			}
-			string transaction = opentxs::OTAPI_Wrap::Ledger_GetTransactionByIndex(serverID, nymID, nymID, paymentInbox, index);
+			string transaction = _otapi(Ledger_GetTransactionByIndex(serverID, nymID, nymID, paymentInbox, index));
 
-			int64_t transNumber = opentxs::OTAPI_Wrap::Ledger_GetTransactionIDByIndex(serverID, nymID, nymID, paymentInbox, index);
-
-			string transactionNumber = ToStr(transNumber);
+			transNumbers[index] = _otapi(Ledger_GetTransactionIDByIndex(serverID, nymID, nymID, paymentInbox, index));
 
 			// int64_t refNum = opentxs::OTAPI_Wrap::Transaction_GetDisplayReferenceToNum(serverID, nymID, nymID, transaction); // FIXME why we need this?
 
-			int64_t amount = opentxs::OTAPI_Wrap::Instrmnt_GetAmount(instrument);
-			string instrumentType = opentxs::OTAPI_Wrap::Instrmnt_GetType(instrument);
-			string instrAssetID = opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(instrument);
-			string senderNymID = opentxs::OTAPI_Wrap::Instrmnt_GetSenderNymID(instrument);
-			string senderAccountID = opentxs::OTAPI_Wrap::Instrmnt_GetSenderAcctID(instrument);
-			string recipientNymID = opentxs::OTAPI_Wrap::Instrmnt_GetRecipientNymID(instrument);
-			string recipientAccountID = opentxs::OTAPI_Wrap::Instrmnt_GetRecipientAcctID(instrument);
-
-			string finalNymID = senderNymID.empty() ? senderNymID : recipientNymID;
-			string finalAccountID = senderAccountID.empty() ? senderAccountID : recipientAccountID;
+			keys[index] = cLedgerMirror::Key(transNumbers[index], transaction);
+			if (!mirror.Get(keys[index], rows[index])) {
+				string instrument = _otapi(Ledger_GetInstrument(serverID, nymID, nymID, paymentInbox, index)); // uses the wallet: not in decode threads
+				if (instrument.empty()) {
+					 _otapi(Output(0, "Failed trying to get payment instrument from payments box.\n"));
+					 return false;
+				}
+				missing.push_back(index);
+				missingInstruments.push_back(instrument);
+			}
+		}
 
-			bool hasAmount = amount >= 0;
-			bool hasAsset = !instrAssetID.empty();
+		struct cPaymentRow {
+			int64_t amount;
+			string instrumentType, instrAssetID;
+		};
+		// only the Instrmnt_Get* decoding of the given text is done in parallel
+		auto decoded = nUtils::DecodeOTRows<cPaymentRow>( missing.size(), [&] (size_t i) -> cPaymentRow {
+			const string & instrument = missingInstruments[i];
+			return cPaymentRow{ _otapi(Instrmnt_GetAmount(instrument)), _otapi(Instrmnt_GetType(instrument)), _otapi(Instrmnt_GetInstrumentDefinitionID(instrument)) };
+		} );
+		for (size_t i = 0; i < missing.size(); ++i) {
+			const cPaymentRow & payment = decoded[i];
+			bool hasAmount = payment.amount >= 0;
+			bool hasAsset = !payment.instrAssetID.empty();
+
+			string formattedAmount = (hasAmount && hasAsset) ? _otapi(FormatAmount(payment.instrAssetID, payment.amount)) : "UNKNOWN_AMOUNT"; // loads the asset contract
+			rows[ missing[i] ] = cLedgerMirror::tRow{ formattedAmount, payment.instrumentType, payment.instrAssetID };
+			mirror.Put(keys[ missing[i] ], rows[ missing[i] ]);
+		}
 
-			string formattedAmount = (hasAmount && hasAsset) ? opentxs::OTAPI_Wrap::FormatAmount(instrAssetID, amount) : "UNKNOWN_AMOUNT";
+		for (int32_t index = 0; index < count; ++index)
+		{
+			const cLedgerMirror::tRow & row = rows[index];
+			string transactionNumber = ToStr(transNumbers[index]);
+			const string & instrAssetID = row.at(2);
 
  			string assetDescr = AssetGetName(instrAssetID) + "(" + instrAssetID + ")";
-			string recipientDescr = recipientNymID; // FIXME Is recipient needed in purse?
 
-			tp << ToStr(index) <<  formattedAmount << instrumentType << transactionNumber << assetDescr;
+			tp << ToStr(index) <<  row.at(0) << row.at(1) << transactionNumber << assetDescr;
 		} // for
 		tp.PrintFooter();
+		mirror.Save();
 	}
 
 
@@ -2838,21 +3307,21 @@ bool cUseOT::PaymentDiscard(const string & nym, const string & index, bool all,
 
 	if(nym.empty()) {
 		auto nymID = NymGetDefault();
-		string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(ServerGetDefault(), nymID); // Returns NULL, or an inbox.
-		int32_t count = opentxs::OTAPI_Wrap::Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox);
+		string paymentInbox = _otapi(LoadPaymentInbox(ServerGetDefault(), nymID)); // Returns NULL, or an inbox.
+		int32_t count = _otapi(Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox));
 		_dbg1("Count: " << count);
 		count --;
-        mMadeEasy->discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(count));
+        _otme(discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(count)));
 		return true;
 	}
 
 	if(index.empty()) {
 		auto nymID = NymGetId(nym);
-		string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(ServerGetDefault(), nymID); // Returns NULL, or an inbox.
-		int32_t count = opentxs::OTAPI_Wrap::Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox);
+		string paymentInbox = _otapi(LoadPaymentInbox(ServerGetDefault(), nymID)); // Returns NULL, or an inbox.
+		int32_t count = _otapi(Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox));
 		_dbg1("Count: " << count);
 		count --;
-        mMadeEasy->discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(count));
+        _otme(discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(count)));
 		return true;
 	}
 
@@ -2862,21 +3331,21 @@ bool cUseOT::PaymentDiscard(const string & nym, const string & index, bool all,
 	ID nymID = NymGetId(nym);
 	if(!all) {
 		_dbg1("Not all");
-		mMadeEasy->discard_incoming_payments(ServerGetDefault(), nymID, index);
+		_otme(discard_incoming_payments(ServerGetDefault(), nymID, index));
 		return true;
 	}
 
 	_dbg2("string paymentInbox = ");
-	string paymentInbox = opentxs::OTAPI_Wrap::LoadPaymentInbox(ServerGetDefault(), nymID); // Returns NULL, or an inbox.
+	string paymentInbox = _otapi(LoadPaymentInbox(ServerGetDefault(), nymID)); // Returns NULL, or an inbox.
 	_dbg2("int32_t count =");
 	if (paymentInbox.empty()) {
-		 opentxs::OTAPI_Wrap::Output(0, "\n\n accept_from_paymentbox:  OT_API_LoadPaymentInbox Failed.\n\n");
+		 _otapi(Output(0, "\n\n accept_from_paymentbox:  OT_API_LoadPaymentInbox Failed.\n\n"));
 		 return false;
 	}
-	int32_t count = opentxs::OTAPI_Wrap::Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox);
+	int32_t count = _otapi(Ledger_GetCount(ServerGetDefault(), nymID, nymID, paymentInbox));
 	_dbg2(" PaymentDiscard() count =  " << count);
 	for (int32_t i = 0; i < count; i++) {
-        mMadeEasy->discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(0));
+        _otme(discard_incoming_payments(ServerGetDefault(), nymID, std::to_string(0)));
 	}
 
 	return true;
@@ -2907,7 +3376,7 @@ bool cUseOT::PurseCreate(const string & serverName, const string & asset, const
 	string ownerID = NymGetId(ownerName);
 	string signerID = NymGetId(signerName);
 
-	string purse = opentxs::OTAPI_Wrap::CreatePurse(serverID,assetTypeID,ownerID,signerID);
+	string purse = _otapi(CreatePurse(serverID,assetTypeID,ownerID,signerID));
 	nUtils::DisplayStringEndl(cout, purse);
 
 	//	bool opentxs::OTAPI_Wrap::SavePurse	(	const std::string & 	SERVER_ID,
@@ -2915,7 +3384,7 @@ bool cUseOT::PurseCreate(const string & serverName, const string & asset, const
 	//	const std::string & 	USER_ID,
 	//	const std::string & 	THE_PURSE
 	//	)
-	bool result = opentxs::OTAPI_Wrap::SavePurse(serverID,assetTypeID,ownerID,purse);
+	bool result = _otapi(SavePurse(serverID,assetTypeID,ownerID,purse));
 	_info("saving: " << result) ;
 
 	return true;
@@ -2931,7 +3400,7 @@ bool cUseOT::PurseDisplay(const string & serverName, const string & asset, const
 	string assetTypeID = AssetGetId(asset);
 	string nymID = NymGetId(nymName);
 
-	string result = opentxs::OTAPI_Wrap::LoadPurse(serverID,assetTypeID,nymID);
+	string result = _otapi(LoadPurse(serverID,assetTypeID,nymID));
 	nUtils::DisplayStringEndl(cout, result);
 	_info(result);
 	//  TODO:
@@ -2952,10 +3421,10 @@ bool cUseOT::RecordClear(const string &acc, bool all, bool dryrun) {
 	const auto nym = AccountGetNym(acc);
 	const auto nymID = NymGetId(nym);
 	const auto accID = AccountGetId(acc);
-	const auto srvID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accID);
+	const auto srvID = _otapi(GetAccountWallet_NotaryID(accID));
 	const auto srv = ServerGetName(srvID);
 
-	const auto recordBox = opentxs::OTAPI_Wrap::LoadRecordBox(srvID, nymID, accID);
+	const auto recordBox = _otapi(LoadRecordBox(srvID, nymID, accID));
 
 	cout << endl;
 	cout << "    Nym: " << nym << endl;
@@ -2970,8 +3439,8 @@ bool cUseOT::RecordClear(const string &acc, bool all, bool dryrun) {
 
 	bool cleared;
 
-	(all) ? cleared = opentxs::OTAPI_Wrap::ClearRecord(srvID, nymID, accID, 0, true) :
-			cleared = opentxs::OTAPI_Wrap::ClearExpired(srvID, nymID, 0, true);
+	(all) ? cleared = _otapi(ClearRecord(srvID, nymID, accID, 0, true)) :
+			cleared = _otapi(ClearExpired(srvID, nymID, 0, true));
 
 	return cleared;
 }
@@ -2984,13 +3453,13 @@ bool cUseOT::RecordDisplay(const string &acc, bool noVerify, bool dryrun) {
 	const auto nym = AccountGetNym(acc);
 	const auto nymID = NymGetId(nym);
 	const auto accID = AccountGetId(acc);
-	const auto srvID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accID);
+	const auto srvID = _otapi(GetAccountWallet_NotaryID(accID));
 	const auto srv = ServerGetName(srvID);
 
 	const auto recordBox =
 			(noVerify) ?
-					opentxs::OTAPI_Wrap::LoadRecordBoxNoVerify(srvID, nymID, accID) :
-					opentxs::OTAPI_Wrap::LoadRecordBox(srvID, nymID, accID);
+					_otapi(LoadRecordBoxNoVerify(srvID, nymID, accID)) :
+					_otapi(LoadRecordBox(srvID, nymID, accID));
 
 	_dbg3(recordBox);
 	cout << endl;
@@ -3004,7 +3473,7 @@ bool cUseOT::RecordDisplay(const string &acc, bool noVerify, bool dryrun) {
 		return false;
 	}
 
-	const auto count = opentxs::OTAPI_Wrap::Ledger_GetCount(srvID, nymID, accID, recordBox);
+	const auto count = _otapi(Ledger_GetCount(srvID, nymID, accID, recordBox));
 
 	_dbg2(count);
 
@@ -3021,21 +3490,49 @@ bool cUseOT::RecordDisplay(const string &acc, bool noVerify, bool dryrun) {
 
 	bool ok = true;
 
+	struct cRecordRow {
+		bool valid;
+		int64_t id;
+		string type, senderNymID, recipientNymID;
+		int64_t amount;
+		bool canceled;
+	};
+	vector<string> transactions(count);
+	vector<int64_t> ids(count); // Ledger_* calls read the ledger (not only given text): done here, not in decode threads
+	for (int32_t i = 0; i < count; ++i) {
+		transactions[i] = _otapi(Ledger_GetTransactionByIndex(srvID, nymID, accID, recordBox, i));
+		if (!transactions[i].empty()) ids[i] = _otapi(Ledger_GetTransactionIDByIndex(srvID, nymID, accID, recordBox, i));
+	}
+
+	auto rows = nUtils::DecodeOTRows<cRecordRow>( transactions.size(), [&] (size_t i) -> cRecordRow {
+		const auto & transaction = transactions[i];
+		cRecordRow row{ false, 0, "", "", "", 0, false };
+		if (transaction.empty()) return row;
+		row.valid = true;
+		row.id = ids[i];
+		row.type = _otapi(Transaction_GetType(srvID, nymID, accID, transaction));
+		row.senderNymID = _otapi(Transaction_GetSenderNymID(srvID, nymID, accID, transaction));
+		row.recipientNymID = _otapi(Transaction_GetRecipientNymID(srvID, nymID, accID,
+				transaction));
+		row.amount = _otapi(Transaction_GetAmount(srvID, nymID, accID, transaction));
+		row.canceled = _otapi(Transaction_IsCanceled(srvID, nymID, accID, transaction));
+		return row;
+	} );
+
 	for (int32_t i = 0; i < count; ++i) {
-		const auto transaction = opentxs::OTAPI_Wrap::Ledger_GetTransactionByIndex(srvID, nymID, accID, recordBox, i);
-		if (transaction.empty()) { // handle error
+		const cRecordRow & row = rows[i];
+		if (!row.valid) { // handle error
 			ok = false;
 			table.SetContentColor(zkr::cc::fore::lightred);
 			table << "ERROR" << "ERROR" << "ERROR" << "ERROR" << "ERROR";
 		} else {
-			const auto id = opentxs::OTAPI_Wrap::Ledger_GetTransactionIDByIndex(srvID, nymID, accID, recordBox, i);
-			const auto type = opentxs::OTAPI_Wrap::Transaction_GetType(srvID, nymID, accID, transaction);
-			const auto senderNymID = opentxs::OTAPI_Wrap::Transaction_GetSenderNymID(srvID, nymID, accID, transaction);
-			const auto recipientNymID = opentxs::OTAPI_Wrap::Transaction_GetRecipientNymID(srvID, nymID, accID,
-					transaction);
-			const auto amount = opentxs::OTAPI_Wrap::Transaction_GetAmount(srvID, nymID, accID, transaction);
-
-			(opentxs::OTAPI_Wrap::Transaction_IsCanceled(srvID, nymID, accID, transaction)) ?
+			const auto & id = row.id;
+			const auto & type = row.type;
+			const auto & senderNymID = row.senderNymID;
+			const auto & recipientNymID = row.recipientNymID;
+			const auto & amount = row.amount;
+
+			(row.canceled) ?
 					table.SetContentColor(zkr::cc::fore::yellow) : table.SetContentColor(zkr::cc::console);
 
 			// if sender or recipient nym is empty, print space
@@ -3064,7 +3561,7 @@ bool cUseOT::ServerAdd(const string &filename, bool dryrun) {
 				"Provided contract was empty");
 	}
 
-	if( !opentxs::OTAPI_Wrap::AddServerContract(contract) ) {
+	if( !_otapi(AddServerContract(contract)) ) {
 		return nUtils::reportError("Failure to add server");
 	}
 
@@ -3095,7 +3592,7 @@ bool cUseOT::ServerCreate(const string & nym, const string & filename, bool dryr
 	}
 
 	ID nymID = NymGetId(nym);
-	ID serverID = opentxs::OTAPI_Wrap::CreateServerContract(nymID, xmlContents);
+	ID serverID = _otapi(CreateServerContract(nymID, xmlContents));
 	string server = ServerGetName(serverID);
 	if(serverID.empty())
 		return reportError( "Failure to create contract for nym: " + NymGetName(nymID) + "(" + nymID + ")" );
@@ -3121,8 +3618,8 @@ bool cUseOT::ServerCreate(const string & nym, const string & filename, bool dryr
 
 void cUseOT::ServerCheck() {
 	if(!Init()) return;
-	if (opentxs::OTAPI_Wrap::pingNotary(mDefaultIDs.at(nUtils::eSubjectType::Server),
-			mDefaultIDs.at(nUtils::eSubjectType::User)) == -1) {
+	if (_otapi(pingNotary(mDefaultIDs.at(nUtils::eSubjectType::Server),
+			mDefaultIDs.at(nUtils::eSubjectType::User))) == -1) {
 		_erro("No response from server: " + mDefaultIDs.at(nUtils::eSubjectType::Server));
 	}
 
@@ -3147,9 +3644,9 @@ string cUseOT::ServerGetId(const string & serverName) { ///< Gets nym aliases an
 	if ( nUtils::checkPrefix(serverName) )
 		return serverName.substr(1);
 	else {
-		for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetServerCount(); i++) {
-			string serverID = opentxs::OTAPI_Wrap::GetServer_ID(i);
-			string serverName_ = opentxs::OTAPI_Wrap::GetServer_Name(serverID);
+		for(int i = 0 ; i < _otapi(GetServerCount()); i++) {
+			string serverID = _otapi(GetServer_ID(i));
+			string serverName_ = _otapi(GetServer_Name(serverID));
 			if (serverName_ == serverName)
 				return serverID;
 		}
@@ -3163,7 +3660,7 @@ string cUseOT::ServerGetName(const string & serverID){
 	if(serverID.empty())
 		return "";
 
-	auto srvName = opentxs::OTAPI_Wrap::GetServer_Name(serverID);
+	auto srvName = _otapi(GetServer_Name(serverID));
 	return (srvName.empty())? "" : srvName;
 }
 
@@ -3172,8 +3669,8 @@ bool cUseOT::ServerRemove(const string & serverName, bool dryrun) {
 	if(dryrun) return true;
 	if(!Init()) return false;
 	string serverID = ServerGetId(serverName);
-	if ( opentxs::OTAPI_Wrap::Wallet_CanRemoveServer(serverID) ) {
-		if ( opentxs::OTAPI_Wrap::Wallet_RemoveServer(serverID) ) {
+	if ( _otapi(Wallet_CanRemoveServer(serverID)) ) {
+		if ( _otapi(Wallet_RemoveServer(serverID)) ) {
 			_info("Server " << serverName << " was deleted successfully");
 			return true;
 		}
@@ -3185,7 +3682,7 @@ bool cUseOT::ServerRemove(const string & serverName, bool dryrun) {
 }
 
 bool cUseOT::ServerSetDefault() {
-	ID serverID = opentxs::OTAPI_Wrap::GetServer_ID(0);
+	ID serverID = _otapi(GetServer_ID(0));
 	if(serverID.empty()) return false;
 	_note("Setting server " << ServerGetName(serverID) << " as default");
 	return ServerSetDefault(ServerGetName(serverID), false);
@@ -3202,6 +3699,81 @@ bool cUseOT::ServerSetDefault(const string & serverName, bool dryrun) {
 	return true;
 }
 
+bool cUseOT::ServerPingMany(const string & server, const string & nym, bool all, int count, int timeoutMs, int intervalSec, bool dryrun) {
+	_fact("server ping " << (all ? "--all" : server) << " " << nym << " --count " << count << " --timeout " << timeoutMs << " --interval " << intervalSec);
+	if ((count <= 0) || (timeoutMs <= 0) || (intervalSec < 0)) return reportError("Use positive --count and --timeout, and --interval >= 0");
+	if(dryrun) return true;
+	if(!Init()) return false;
+
+	vector<ID> serverIDs;
+	ID nymID;
+	try {
+		if (all) for (int i = 0; i < _otapi(GetServerCount()); ++i) serverIDs.push_back(_otapi(GetServer_ID(i)));
+		else serverIDs.push_back(server.empty() ? ServerGetDefault() : ServerGetId(server));
+		nymID = nym.empty() ? NymGetDefault() : NymGetId(nym);
+	} catch (const string & message) {
+		return reportError(message);
+	}
+	if (serverIDs.empty()) return reportError("No servers to ping");
+
+	struct cProbes {
+		nUtils::cLatencyHistogram mRtt; ///< only answered in time
+		size_t mSent, mFailed, mLate; ///< late: answered after the deadline (OTAPI call can not be interrupted)
+	};
+	// one notary probed one by one; notaries in parallel if OT_ME allows
+	auto probeServer = [&] (size_t i) -> cProbes {
+		cProbes probes{ {}, 0, 0, 0 };
+		for (int n = 0; n < count; ++n) {
+			auto start = std::chrono::steady_clock::now();
+			const int32_t ping = _otapi(pingNotary(serverIDs[i], nymID));
+			const auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+			++probes.mSent;
+			if (ping <= 0) ++probes.mFailed; // -1: error, 0: not sent
+			else if (us > int64_t(timeoutMs) * 1000) ++probes.mLate;
+			else probes.mRtt.Record(us);
+		}
+		return probes;
+	};
+	auto fixed1 = [] (double value) { std::ostringstream oss; oss << std::fixed << std::setprecision(1) << value; return oss.str(); };
+	auto percent = [&fixed1] (size_t part, size_t all) -> string { return all ? fixed1(100.0 * part / all) : "-"; };
+	auto ms = [&fixed1] (const nUtils::cLatencyHistogram & rtt, uint64_t us) -> string { return rtt.GetCount() ? fixed1(us / 1000.0) : "-"; }; // "-": no answer in time
+
+	bool allOk = true;
+	while (true) {
+		const auto results = nUtils::DecodeRowsParallel<cProbes>(serverIDs.size(), probeServer, CFG_OTAPI_SEND_THREADSAFE ? serverIDs.size() : 1);
+		allOk = std::all_of(results.begin(), results.end(), [] (const cProbes & probes) { return probes.mFailed + probes.mLate == 0; });
+
+		if (intervalSec > 0) { // compact, one line per notary - for monitoring scripts
+			const auto now = std::time(nullptr);
+			for (size_t i = 0; i < serverIDs.size(); ++i) {
+				const auto & probes = results[i];
+				cout << now << " " << ServerGetName(serverIDs[i]) << " sent=" << probes.mSent << " fail=" << probes.mFailed << " late=" << probes.mLate
+					<< " p50=" << ms(probes.mRtt, probes.mRtt.Percentile(50)) << " p99=" << ms(probes.mRtt, probes.mRtt.Percentile(99)) << " max=" << ms(probes.mRtt, probes.mRtt.GetMax()) << endl;
+			}
+			std::this_thread::sleep_for(std::chrono::seconds(intervalSec));
+			continue;
+		}
+
+		bprinter::TablePrinter tp(&std::cout);
+		tp.AddColumn("Server", 30);
+		tp.AddColumn("Sent", 6);
+		tp.AddColumn("Failed %", 9);
+		tp.AddColumn("Late", 6);
+		tp.AddColumn("p50 ms", 9);
+		tp.AddColumn("p99 ms", 9);
+		tp.AddColumn("max ms", 9);
+		tp.PrintHeader();
+		for (size_t i = 0; i < serverIDs.size(); ++i) {
+			const auto & probes = results[i];
+			tp << ServerGetName(serverIDs[i]) << std::to_string(probes.mSent) << percent(probes.mFailed, probes.mSent) << std::to_string(probes.mLate)
+				<< ms(probes.mRtt, probes.mRtt.Percentile(50)) << ms(probes.mRtt, probes.mRtt.Percentile(99)) << ms(probes.mRtt, probes.mRtt.GetMax());
+		}
+		tp.PrintFooter();
+		break;
+	}
+	return allOk;
+}
+
 bool cUseOT::ServerPing(const string & server, const string & nym, bool dryrun) {
 	_fact("server ping " << server << " " << nym);
 	if(dryrun) return true;
@@ -3209,7 +3781,7 @@ bool cUseOT::ServerPing(const string & server, const string & nym, bool dryrun)
 
 	cout << "Checking connection (" << server << ") for nym: " << nym << endl;
 
-	auto ping = opentxs::OTAPI_Wrap::pingNotary(ServerGetId(server), NymGetId(nym));
+	auto ping = _otapi(pingNotary(ServerGetId(server), NymGetId(nym)));
 
 	if(ping == -1) {
 		_erro("ping= " << ping << ", no message sent");
@@ -3240,7 +3812,7 @@ bool cUseOT::ServerShowContract(const string & serverName, const string &filenam
 	nUtils::DisplayStringEndl(cout, zkr::cc::fore::lightblue + serverName + zkr::cc::fore::console);
 	nUtils::DisplayStringEndl(cout, "ID: " + serverID);
 
-	const auto contract = opentxs::OTAPI_Wrap::GetServer_Contract(serverID);
+	const auto contract = _otapi(GetServer_Contract(serverID));
 	if(!filename.empty()) {
 		try {
 			nUtils::cEnvUtils envUtils;
@@ -3262,9 +3834,9 @@ vector<string> cUseOT::ServerGetAllNames() { ///< Gets all servers name
 	return vector<string> {};
 
 	vector<string> servers;
-	for(int i = 0 ; i < opentxs::OTAPI_Wrap::GetServerCount ();i++) {
-		string servID = opentxs::OTAPI_Wrap::GetServer_ID(i);
-		string servName = opentxs::OTAPI_Wrap::GetServer_Name(servID);
+	for(int i = 0 ; i < _otapi(GetServerCount());i++) {
+		string servID = _otapi(GetServer_ID(i));
+		string servName = _otapi(GetServer_Name(servID));
 		servers.push_back(servName);
 	}
 	return servers;
@@ -3275,8 +3847,8 @@ bool cUseOT::ServerDisplayAll(bool dryrun) {
 	if(dryrun) return true;
 	if(!Init()) return false;
 
-	for(std::int32_t i = 0 ; i < opentxs::OTAPI_Wrap::GetServerCount();i++) {
-		ID serverID = opentxs::OTAPI_Wrap::GetServer_ID(i);
+	for(std::int32_t i = 0 ; i < _otapi(GetServerCount());i++) {
+		ID serverID = _otapi(GetServer_ID(i));
 
 		nUtils::DisplayStringEndl(nUtils::stringToColor(serverID) + ServerGetName(serverID) + "\t" + serverID);
 	}
@@ -3301,13 +3873,13 @@ bool cUseOT::TextEncode(const string & plainText, const string & fromFile, const
 
 	bool bLineBreaks = true; // FIXME? opentxs::OTAPI_Wrap - bLineBreaks should usually be set to true
 	string encodedText;
-	encodedText = opentxs::OTAPI_Wrap::Encode(plainTextIn, bLineBreaks);
+	encodedText = _otapi(Encode(plainTextIn, bLineBreaks));
 
 	if(encodedText.empty()) return nUtils::reportError("empty encoded text");
+	plainTextIn.clear(); plainTextIn.shrink_to_fit(); // not needed any more - big files should not be in memory twice
 	if (!toFile.empty()) {
 		try {
-			nUtils::DisplayStringEndl(cout, encodedText);
-			envUtils.WriteToFile(toFile, encodedText);
+			envUtils.WriteToFile(toFile, encodedText); // not printed: could be hundreds of MB
 			cout << "saved" << endl;
 			return true;
 		} catch (...) {
@@ -3326,7 +3898,7 @@ bool cUseOT::TextEncrypt(const string & recipientNymName, const string & plainTe
 	if(!Init()) return false;
 
 	string encryptedText;
-	encryptedText = opentxs::OTAPI_Wrap::Encrypt(NymGetToNymId(recipientNymName, NymGetDefault()), plainText);
+	encryptedText = _otapi(Encrypt(NymGetToNymId(recipientNymName, NymGetDefault()), plainText));
 	nUtils::DisplayStringEndl(cout, encryptedText);
 	return true;
 }
@@ -3349,14 +3921,14 @@ bool cUseOT::TextDecode(const string & encodedText, const string & fromFile, con
 
 	bool bLineBreaks = true; // FIXME? opentxs::OTAPI_Wrap - bLineBreaks should usually be set to true
 	string plainText;
-	plainText = opentxs::OTAPI_Wrap::Decode(encodedTextIn, bLineBreaks);
+	plainText = _otapi(Decode(encodedTextIn, bLineBreaks));
 
 	if(plainText.empty()) return nUtils::reportError("empty decoded text");
+	encodedTextIn.clear(); encodedTextIn.shrink_to_fit(); // not needed any more - big files should not be in memory twice
 
 	if (!toFile.empty()) {
 		try {
-			envUtils.WriteToFile(toFile, plainText);
-			nUtils::DisplayStringEndl(cout, plainText);
+			envUtils.WriteToFile(toFile, plainText); // not printed: could be hundreds of MB
 			cout << "saved" << endl;
 			return true;
 		} catch (...) {
@@ -3374,7 +3946,7 @@ bool cUseOT::TextDecrypt(const string & recipientNymName, const string & encrypt
 	if(!Init()) return false;
 
 	string plainText;
-	plainText = opentxs::OTAPI_Wrap::Decrypt(NymGetId(recipientNymName), encryptedText);
+	plainText = _otapi(Decrypt(NymGetId(recipientNymName), encryptedText));
 	nUtils::DisplayStringEndl(cout, plainText);
 	return true;
 }
@@ -3393,45 +3965,136 @@ bool cUseOT::VoucherCancel(const string & acc, const string & nym, const int32_t
 		voucher = GetText();
 	} else {
 		_dbg2("getting voucher from outpayments");
-		auto count = opentxs::OTAPI_Wrap::GetNym_OutpaymentsCount(nymID);
+		auto count = _otapi(GetNym_OutpaymentsCount(nymID));
 		_dbg3("outpayment count: " << count);
 		if(count == 0) {
 			cout << zkr::cc::fore::lightred << "Empty outpayments for nym: " << NymGetName(nymID) << zkr::cc::console << endl;
 			return false;
 		}
-		voucher = opentxs::OTAPI_Wrap::GetNym_OutpaymentsContentsByIndex(nymID, index);
+		voucher = _otapi(GetNym_OutpaymentsContentsByIndex(nymID, index));
 		if(voucher.empty()) return nUtils::reportError("Empty voucher!");
 	}
 	ID accID = AccountGetId(acc);
-	ID srvID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(accID);
-	ID assetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(accID);
+	ID srvID = _otapi(GetAccountWallet_NotaryID(accID));
+	ID assetID = _otapi(GetAccountWallet_InstrumentDefinitionID(accID));
 
-	if(opentxs::OTAPI_Wrap::Instrmnt_GetType(voucher) != "VOUCHER") {
+	if(_otapi(Instrmnt_GetType(voucher)) != "VOUCHER") {
 		cout << zkr::cc::fore::lightred << "Not a voucher!" << zkr::cc::console << endl;
 		return false;
 	}
 
-	ID vAssetID = opentxs::OTAPI_Wrap::Instrmnt_GetInstrumentDefinitionID(voucher);
+	ID vAssetID = _otapi(Instrmnt_GetInstrumentDefinitionID(voucher));
 
-	auto valid = opentxs::OTAPI_Wrap::Instrmnt_GetValidTo(voucher);
+	auto valid = _otapi(Instrmnt_GetValidTo(voucher));
 	_mark(valid);
 	if(assetID != vAssetID) {
 		cout << zkr::cc::fore::yellow << "Assets are different" << zkr::cc::console << endl;
 		return false;
 	}
 
-	auto dep = mMadeEasy->deposit_cheque(srvID, nymID, accID, voucher);
-	auto status = mMadeEasy->VerifyMessageSuccess(dep);
+	auto dep = _otme(deposit_cheque(srvID, nymID, accID, voucher));
+	auto status = _otme(VerifyMessageSuccess(dep));
 
 	if(status < 0)
 		return nUtils::reportError(ToStr(status), "status", "Can't cancel voucher ");
 	OutpaymentRemove(nym, index, false, false);
 
-	auto ok = mMadeEasy->retrieve_account(srvID, nymID, accID, true);
+	auto ok = _otme(retrieve_account(srvID, nymID, accID, true));
 	return ok;
 }
 
 
+string cUseOT::VoucherIssue(const ID & srvID, const ID & fromNymID, const ID & fromAccID, const ID & toNymID, string memo, int64_t amount) {
+	if (memo.empty())
+		memo = "(no memo)";
+	_info("memo: " << memo);
+
+	string attempt = "withdraw_voucher";
+
+	auto response = _otme(withdraw_voucher(srvID, fromNymID, fromAccID, toNymID, memo, amount));
+	// connection with server
+	auto reply = _otme(InterpretTransactionMsgReply(srvID, fromNymID, fromAccID, attempt, response));
+	if (reply != 1) {
+		nUtils::reportError(ToStr(reply), "withdraw voucher (made easy) failed!", "Error from server!");
+		return "";
+	}
+
+	auto ledger = _otapi(Message_GetLedger(response));
+	if (ledger.empty()) {
+		nUtils::reportError(ledger, "Some error with ledger", "Server error");
+		return "";
+	}
+
+	auto transactionReply = _otapi(Ledger_GetTransactionByIndex(srvID, fromNymID, fromAccID, ledger, 0));
+	if (transactionReply == "") {
+		nUtils::reportError(transactionReply, "some error with transaction reply", "Server error");
+		return "";
+	}
+
+	_mark(_otapi(Transaction_GetSuccess(srvID, fromNymID, fromAccID, transactionReply)));
+
+	auto voucher = _otapi(Transaction_GetVoucher(srvID, fromNymID, fromAccID, transactionReply));
+	if (voucher.empty()) {
+		nUtils::reportError(voucher, "Error with getting voucher", "Server error");
+		return "";
+	}
+
+	_mark(_otapi(Transaction_GetSuccess(srvID, fromNymID, fromAccID, voucher)));
+
+	auto send = _otme(send_user_payment(srvID, fromNymID, fromNymID, voucher));
+	_dbg1(send);
+	// sending voucher to yourself - saving voucher in my outpayments
+	// after sending this voucher, this copy will be removed automatically
+	return voucher;
+}
+
+bool cUseOT::VoucherWithdrawBatch(const string & fromAcc, const string &fromNym, const string & csvFile, const string & manifest, bool overwrite, bool dryrun) {
+	_fact("voucher new-batch " << fromAcc << " " << fromNym << " " << csvFile << " --manifest " << manifest);
+	if (dryrun) return true;
+	if (!Init()) return false;
+
+	const ID fromAccID = AccountGetId(fromAcc);
+	const ID fromNymID = NymGetId(fromNym);
+	const ID srvID = _otapi(GetAccountWallet_NotaryID(fromAccID));
+
+	cPaymentBatch batch;
+	map<string, ID> recipients;
+	if (!BatchPrepare(batch, csvFile, manifest, "", overwrite, fromNymID, recipients)) return false;
+
+	// whole batch is checked before first voucher, so it does not stop half way for lack of money
+	int64_t balance = _otapi(GetAccountWallet_Balance(fromAccID));
+	string accType = _otapi(GetAccountWallet_Type(fromAccID));
+	if (batch.GetTotal() > balance && accType == "simple") { // TODO: issuer
+		string mess = "Balance [" + fromAcc + "] is " + ToStr(balance) + ", batch needs " + ToStr(batch.GetTotal());
+		return nUtils::reportError(ToStr(balance), "Not enough money", mess);
+	}
+
+	const auto & items = batch.GetItems();
+	const int32_t upfront = static_cast<int32_t>( std::min<size_t>(items.size(), mTransNumPool.GetHigh()) );
+	if (!mTransNumPool.Acquire(srvID, fromNymID, upfront))
+		_warn("Could not get " << upfront << " transaction numbers for the batch at once, each voucher will try on its own");
+
+	for (const auto & item : items) {
+		const ID & toNymID = recipients.at(item.mRecipient);
+		if (!mTransNumPool.Acquire(srvID, fromNymID)) {
+			batch.Record(item, toNymID, false, 0, "not enough transaction numbers");
+			continue;
+		}
+		const string voucher = VoucherIssue(srvID, fromNymID, fromAccID, toNymID, item.mMemo, item.mAmount);
+		if (voucher.empty()) {
+			batch.Record(item, toNymID, false, 0, "withdraw voucher failed");
+			continue;
+		}
+		batch.Record(item, toNymID, true, _otapi(Instrmnt_GetTransNum(voucher)), "");
+	}
+
+	// account is refreshed once for whole batch, not after every voucher
+	bool srvAcc = _otme(retrieve_account(srvID, fromNymID, fromAccID, true));
+	if (!srvAcc) nUtils::reportError(ToStr(srvAcc), "Retrieving account failed! Used force download", "Retriving account failed!");
+	BatchReport(batch, manifest);
+	return srvAcc && (batch.GetFailed() == 0);
+}
+
 bool cUseOT::VoucherWithdraw(const string & fromAcc, const string &fromNym, const string &toNym, int64_t amount,
 		string memo, bool dryrun) {
 	_fact("voucher new " << fromAcc << " " << toNym << " " << amount << " " << memo);
@@ -3444,62 +4107,33 @@ bool cUseOT::VoucherWithdraw(const string & fromAcc, const string &fromNym, cons
 	const ID fromNymID = NymGetId(fromNym);
 	const ID toNymID = NymGetToNymId(toNym, fromNymID);
 
-	const ID assetID = opentxs::OTAPI_Wrap::GetAccountWallet_InstrumentDefinitionID(fromAccID);
-	const ID srvID = opentxs::OTAPI_Wrap::GetAccountWallet_NotaryID(fromAccID);
+	const ID assetID = _otapi(GetAccountWallet_InstrumentDefinitionID(fromAccID));
+	const ID srvID = _otapi(GetAccountWallet_NotaryID(fromAccID));
 
 	_mark(toNym << " id: " << toNymID );
 
-	if(!mMadeEasy->make_sure_enough_trans_nums(1, srvID, fromNymID)) {
+	if(!mTransNumPool.Acquire(srvID, fromNymID)) {
 		return nUtils::reportError("", "not enough transaction number", "Not enough transaction number!");
 	}
 	// amount validating
 	if (amount < 1)
 		return nUtils::reportError(ToStr(amount), "Amount < 1", "Amount must be greater then zero!");
 
-	int64_t balance = opentxs::OTAPI_Wrap::GetAccountWallet_Balance(fromAccID);
-	string accType = opentxs::OTAPI_Wrap::GetAccountWallet_Type(fromAccID);
+	int64_t balance = _otapi(GetAccountWallet_Balance(fromAccID));
+	string accType = _otapi(GetAccountWallet_Type(fromAccID));
 
 	if (amount > balance && accType == "simple") { // TODO: issuer
 		string mess = "Balance [" + fromAcc + "] is " + ToStr(balance);
 		return nUtils::reportError(ToStr(balance), "Not enough money", mess);
 	}
 
-	if (memo.empty())
-		memo = "(no memo)";
-	_info("memo: " << memo);
-
-	string attempt = "withdraw_voucher";
-
-	auto response = mMadeEasy->withdraw_voucher(srvID, fromNymID, fromAccID, toNymID, memo, amount);
-	// connection with server
-	auto reply = mMadeEasy->InterpretTransactionMsgReply(srvID, fromNymID, fromAccID, attempt, response);
-	if (reply != 1)
-		return nUtils::reportError(ToStr(reply), "withdraw voucher (made easy) failed!", "Error from server!");
-
-	auto ledger = opentxs::OTAPI_Wrap::Message_GetLedger(response);
-	if (ledger.empty())
-		return nUtils::reportError(ledger, "Some error with ledger", "Server error");
-
-	auto transactionReply = opentxs::OTAPI_Wrap::Ledger_GetTransactionByIndex(srvID, fromNymID, fromAccID, ledger, 0);
-	if (transactionReply == "")
-		return nUtils::reportError(transactionReply, "some error with transaction reply", "Server error");
-
-	_mark(opentxs::OTAPI_Wrap::Transaction_GetSuccess(srvID, fromNymID, fromAccID, transactionReply));
-
-	auto voucher = opentxs::OTAPI_Wrap::Transaction_GetVoucher(srvID, fromNymID, fromAccID, transactionReply);
+	const string voucher = VoucherIssue(srvID, fromNymID, fromAccID, toNymID, memo, amount);
 	if (voucher.empty())
-		return nUtils::reportError(voucher, "Error with getting voucher", "Server error");
+		return false; // already reported
 
 	cout << voucher << endl;
 
-	_mark(opentxs::OTAPI_Wrap::Transaction_GetSuccess(srvID, fromNymID, fromAccID, voucher));
-
-	auto send = mMadeEasy->send_user_payment(srvID, fromNymID, fromNymID, voucher);
-	_dbg1(send);
-	// sending voucher to yourself - saving voucher in my outpayments
-	// after sending this voucher, this copy will be removed automatically
-
-	bool srvAcc = mMadeEasy->retrieve_account(srvID, fromNymID, fromAccID, true);
+	bool srvAcc = _otme(retrieve_account(srvID, fromNymID, fromAccID, true));
 	_dbg3("srvAcc retrv: " << srvAcc);
 
 	if (!srvAcc)
@@ -9,11 +9,22 @@ Template for new files, replace word "template" and later delete this line here.
 #include "lib_common2.hpp"
 //#include "OTStorage.hpp"
 #include "addressbook.hpp"
+#include "trans_num_pool.hpp"
+#include "payment_batch.hpp"
+#include "fan_out.hpp"
+#include "stats.hpp"
+#include "wallet_watcher.hpp"
+#include "instrument_cache.hpp"
+#include "compact_id.hpp"
 
 namespace opentxs{
 class OT_ME;
 };
 
+// OTAPI calls go through these, so +stats can count them: _otapi(LoadInbox(srv, nym, acc)) , _otme(retrieve_nym(srv, nym, true))
+#define _otapi(CALL) nOT::nUtils::StatsCall(_stats_site("OTAPI_Wrap::", #CALL), [&]() { return opentxs::OTAPI_Wrap::CALL; })
+#define _otme(CALL) nOT::nUtils::StatsCall(_stats_site("OT_ME::", #CALL), [&]() { return mMadeEasy->CALL; })
+
 // Use this to mark methods
 #define	EXEC
 #define	HINT
@@ -28,15 +39,15 @@ namespace nUse {
 	using ID = string;
 	using name = string;
 
-	class cUseCache { // TODO optimize/share memory? or convert on usage
+	class cUseCache { // IDs and names are interned, @see nUtils::cIdNameMap
 		friend class cUseOT;
 	public:
 		cUseCache();
 	protected:
-		map<ID, name> mNyms;
-		map<ID, name> mAccounts;
-		map<ID, name> mAssets;
-		map<ID, name> mServers;
+		nUtils::cIdNameMap mNyms;
+		nUtils::cIdNameMap mAccounts;
+		nUtils::cIdNameMap mAssets;
+		nUtils::cIdNameMap mServers;
 		bool mNymsLoaded;
 		bool mAccountsLoaded;
 		bool mAssetsLoaded;
@@ -52,7 +63,7 @@ namespace nUse {
 
 	private:
 
-        cUseOT(const cUseOT &) {
+        cUseOT(const cUseOT & other) : mTransNumPool(other.mTransNumPool) {
             throw std::exception();
         }
 
@@ -66,6 +77,14 @@ namespace nUse {
 		const string mDataFolder;
 		const string mDefaultIDsFile;
 
+		static const size_t mMsgInFlightPerNotary = 8; ///< messages sent at once to one notary (if OTAPI allows, @see cFanOut)
+
+		cTransNumPool mTransNumPool; ///< watermarks from file transnum_pool.opt ("low N", "high N")
+
+		unique_ptr<cWalletWatcher> mWalletWatcher; ///< only in long running process (completion daemon), @see WatchWallet()
+
+		cInstrumentCache mInstrumentCache; ///< mints and asset contracts already loaded in this process
+
 		typedef ID ( cUseOT::*FPTR ) (const string &);
 
 		map<nUtils::eSubjectType, FPTR> subjectGetIDFunc; ///< Map to store pointers to GetID functions
@@ -74,6 +93,14 @@ namespace nUse {
 	private:
 
 		void LoadDefaults(); ///< Defaults are loaded when initializing OTAPI
+		void LoadTransNumPoolConfig();
+		void ApplyWalletChanges(); ///< drops cache segments that wallet watcher found changed
+		string VoucherIssue(const ID & srvID, const ID & fromNymID, const ID & fromAccID, const ID & toNymID, string memo, int64_t amount); ///< voucher or "" (error reported)
+		bool BatchPrepare(cPaymentBatch & batch, const string & csvFile, const string & manifest, const string & kind, bool overwrite, const ID & fromNymID, map<string, ID> & recipients);
+		void BatchReport(const cPaymentBatch & batch, const string & manifest);
+		string LedgerMirrorFile(const string & boxName); ///< path of local mirror of decoded box, @see cLedgerMirror
+		string MintLoad(const ID & srvID, const ID & nymID, const ID & assetID); ///< unexpired mint (from mInstrumentCache, or loaded/retrieved) or ""
+		string AssetContractLoad(const ID & srvID, const ID & nymID, const ID & assetID); ///< asset contract (from mInstrumentCache, or loaded/retrieved) or ""
 
 	protected:
 
@@ -88,7 +115,11 @@ namespace nUse {
 		string DbgName() const NOEXCEPT;
 
 		bool Init();
-		void CloseApi();
+		void CloseApi(); ///< also does the pending top-up of transaction numbers first
+		void TransNumReplenish(); ///< top up transaction numbers used by earlier commands - call at idle time
+		bool TransNumReplenishPending() const;
+		void WatchWallet(); ///< from now cache is refreshed only when wallet files change, instead of checking OTAPI on each use
+		bool GetWalletGeneration(uint64_t & generation) const; ///< false if wallet is not watched (then nothing derived from it can be kept)
 
 		VALID bool CheckIfExists(const nUtils::eSubjectType type, const string & subject);
 		VALID bool CheckIfExists(const nUtils::eSubjectType type, const string & subject, const string & without);
@@ -119,6 +150,7 @@ namespace nUse {
 		EXEC bool AccountCreate(const string & nym, const string & asset, const string & newAccountName, const string & server, bool dryrun);
 		EXEC bool AccountDisplay(const string & account, bool dryrun);
 		EXEC bool AccountDisplayAll(bool dryrun);
+		EXEC bool AccountSummary(const string & by, bool jsonl, bool dryrun); ///< sum of balances grouped by asset (and nym/server)
 		EXEC bool AccountRefresh(const string & accountName, bool all, bool dryrun);
 		EXEC bool AccountRemove(const string & account, bool dryrun) ;
 		EXEC bool AccountRename(const string & account, const string & newAccountName, bool dryrun);
@@ -183,12 +215,15 @@ namespace nUse {
 		//================= cheque =================
 
 		EXEC bool ChequeCreate(const string &fromAcc, const string & fromNym, const string &toNym, int64_t amount, const string &srv, const string &memo, bool dryrun);
+		EXEC bool ChequeCreateBatch(const string &fromAcc, const string & fromNym, const string & csvFile, const string &srv, const string & manifest, bool overwrite, bool dryrun); ///< cheque for each CSV line, @see cPaymentBatch
 		EXEC bool ChequeDiscard(const string &acc, const string &nym, const int32_t & index, bool dryrun);
 
 		//================= ?contract =================
 
 		string ContractSign(const std::string & nymID, const std::string & contract);
 		EXEC bool ContractSign(const string & nym, const string & filename, const string & outfilename, bool dryrun);
+		EXEC bool ContractSignBatch(const string & nym, const string & dir, const string & glob, const string & outDir, bool dryrun); ///< @see cFileBatch
+		EXEC bool ContractVerify(const string & nym, const string & filename, const string & dir, const string & glob, bool dryrun); ///< one file, or all in dir
 
 		//================= market =================
 		EXEC bool MarketList(const string & srvName, const string & nymName, bool dryrun); ///< displaying available markets
@@ -230,6 +265,7 @@ namespace nUse {
 
 		EXEC bool NymCheck(const string & nymName, bool dryrun);
 		EXEC bool NymCreate(const string & nymName, bool registerOnServer, bool dryrun);
+		EXEC bool NymCreateBulk(const string & namePattern, int count, bool registerOnServer, bool dryrun); ///< names from pattern with {n} (1..count)
 		EXEC bool NymDisplayAll(bool dryrun);
 		EXEC bool NymDisplayInfo(const string & nymName, bool dryrun);
 		EXEC bool NymExport(const string & nymName, const string & filename, bool dryrun);
@@ -290,6 +326,7 @@ namespace nUse {
 		EXEC bool ServerShowContract(const string & serverName, const string &filename, bool dryrun); ///< shows server contract or saves it to file
 		EXEC bool ServerDisplayAll(bool dryrun);
 		EXEC bool ServerPing(const string & server, const string & nym, bool dryrun); ///< checking server connection FIXME: timeout
+		EXEC bool ServerPingMany(const string & server, const string & nym, bool all, int count, int timeoutMs, int intervalSec, bool dryrun); ///< RTT percentiles; interval>0 repeats forever
 
 		//================= text =================
 
@@ -304,6 +341,7 @@ namespace nUse {
 		EXEC bool VoucherCancel(const string & acc, const string & nym, const int32_t & index, bool dryrun); ///< Cancels a voucher (from outpayments or run editor), usable only when voucher wasn't sent
 		EXEC bool VoucherWithdraw(const string & fromAcc, const string &fromNym, const string &toNym, int64_t amount,
 				string memo, bool dryrun); ///< creating new voucher
+		EXEC bool VoucherWithdrawBatch(const string & fromAcc, const string &fromNym, const string & csvFile, const string & manifest, bool overwrite, bool dryrun); ///< voucher for each CSV line, @see cPaymentBatch
 
 	};
 
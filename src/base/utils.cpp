@@ -74,6 +74,24 @@ std::string & trim(std::string &s) {
 	return ltrim(rtrim(s));
 }
 
+std::string JsonEscape(const std::string & s) {
+	std::string ret;
+	ret.reserve(s.size());
+	for (unsigned char c : s) {
+		switch (c) {
+			case '"': ret += "\\\""; break;
+			case '\\': ret += "\\\\"; break;
+			case '\n': ret += "\\n"; break;
+			case '\r': ret += "\\r"; break;
+			case '\t': ret += "\\t"; break;
+			default:
+				if (c < 0x20) { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); ret += buf; }
+				else ret += c;
+		}
+	}
+	return ret;
+}
+
 cNullstream g_nullstream; // extern a stream that does nothing (eats/discards data)
 
 // ====================================================================
@@ -179,7 +197,7 @@ string cFilesystemUtils::TildeToHome(const string &path) {
 
 // ====================================================================
 
-cLogger::cLogger() : mStream(NULL), mLevel(20) { mStream = & std::cout; }
+cLogger::cLogger() : mStream(NULL), mLevel(20), mLevelFloor(20), mMainOff(false), mHasChannelLevels(false) { mStream = & std::cout; }
 
 cLogger::~cLogger() {
 	for (auto pair : mChannels) {
@@ -194,7 +212,7 @@ std::ostream & cLogger::write_stream(int level) {
 }
 
 std::ostream & cLogger::write_stream(int level, const std::string & channel ) {
-	if ((level >= mLevel) && (mStream)) {
+	if (enabled(level,channel) && (mStream)) {
 		ostream & output = SelectOutput(level,channel);
 		output << icon(level) << ' ';
 		return output;
@@ -202,6 +220,41 @@ std::ostream & cLogger::write_stream(int level, const std::string & channel ) {
 	return g_nullstream;
 }
 
+int cLogger::ChannelLevel(const std::string & channel) {
+	std::lock_guard<std::mutex> lock(mChannelMutex);
+	auto cached = mChannelLevelCache.find(channel);
+	if (cached != mChannelLevelCache.end()) return cached->second;
+	int level = mLevel;
+	size_t matched = 0; // longest matching channel prefix wins
+	for (const auto & pair : mChannelLevels) {
+		const string & name = pair.first;
+		bool match = (channel == name) || ((channel.compare(0, name.size(), name) == 0) && (channel.size() > name.size()) && (channel[name.size()] == '/'));
+		if (match && (name.size() >= matched)) { level = pair.second; matched = name.size(); }
+	}
+	mChannelLevelCache[channel] = level;
+	return level;
+}
+
+void cLogger::UpdateLevelFloor() {
+	int floor = mLevel;
+	{
+		std::lock_guard<std::mutex> lock(mChannelMutex);
+		for (const auto & pair : mChannelLevels) floor = std::min(floor, pair.second);
+		mChannelLevelCache.clear();
+	}
+	mMainOff = (!mStream) || (mStream == &g_nullstream); // channel files are written even then, so floor stays
+	mLevelFloor = floor;
+}
+
+void cLogger::setChannelLevel(const std::string & channel, int level) {
+	{
+		std::lock_guard<std::mutex> lock(mChannelMutex);
+		mChannelLevels[channel] = level;
+		mHasChannelLevels = true;
+	}
+	UpdateLevelFloor();
+}
+
 std::string cLogger::GetLogBaseDir() const {
 	return "log";
 }
@@ -244,6 +297,7 @@ void cLogger::setOutStreamFile(const string &fname) { // switch to using this fi
 #endif
 
 	mStream = & (*mOutfile);
+	UpdateLevelFloor();
 	_mark("Started new debug, to file: " << fname);
 }
 
@@ -263,12 +317,15 @@ void cLogger::setOutStreamFromGlobalOptions() {
 	else {
 		mStream = & g_nullstream;
 	}
+	for (const auto & pair : gRunOptions.getDebugChannelLevels()) setChannelLevel(pair.first, pair.second);
+	UpdateLevelFloor();
 }
 
 void cLogger::setDebugLevel(int level) {
 	bool note_before = (mLevel > level); // report the level change before or after the change? (on higher level)
 	if (note_before) _note("Setting debug level to "<<level);
 	mLevel = level;
+	UpdateLevelFloor();
 	if (!note_before) _note("Setting debug level to "<<level);
 }
 
@@ -771,10 +828,21 @@ const string cEnvUtils::Compose() {
 
 
 
-const string cEnvUtils::ReadFromFile(const string path) {
-	std::ifstream ifs(cFilesystemUtils::TildeToHome(path).c_str());
-	_dbg3(cFilesystemUtils::TildeToHome(path));
-	string msg((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+const string cEnvUtils::ReadFromFile(const string & path) {
+	const string fullPath = cFilesystemUtils::TildeToHome(path);
+	_dbg3(fullPath);
+	string msg;
+	// big attachments: read in one go into exactly sized string (no growing buffer, no char by char copy)
+	std::ifstream ifs(fullPath.c_str(), std::ios::binary);
+	const std::streamoff size = ifs.seekg(0, std::ios::end).tellg();
+	if (size > 0) {
+		msg.resize(size);
+		ifs.seekg(0).read(&msg[0], size);
+		msg.resize(ifs.gcount());
+	} else { // not seekable, e.g. a pipe
+		ifs.clear();
+		msg.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	}
 
 	// debug
 	size_t maxSize = 40;
@@ -784,7 +852,7 @@ const string cEnvUtils::ReadFromFile(const string path) {
 	return msg;
 }
 
-void cEnvUtils::WriteToFile(const string path, const string content) {
+void cEnvUtils::WriteToFile(const string & path, const string & content) {
 	if(path.empty() || content.empty()) {
 		(content.empty())? throw string("empty content") : cout << content << endl;
 		return;
@@ -793,8 +861,8 @@ void cEnvUtils::WriteToFile(const string path, const string content) {
 	std::fstream file;
 	file.exceptions(std::fstream::failbit | std::fstream::badbit);
 	try {
-		file.open(cFilesystemUtils::TildeToHome(path).c_str(), std::ios::out | std::ios::trunc);
-		file << content;
+		file.open(cFilesystemUtils::TildeToHome(path).c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+		file.write(content.data(), content.size());
 		file.close();
 		_info("saving to file: " << path << " ok");
 		cout << "Saved to " << path << endl;
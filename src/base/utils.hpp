@@ -8,6 +8,8 @@ we find helpful in coding this project.
 #define INCLUDE_OT_NEWCLI_UTILS
 
 #include "lib_common1.hpp"
+#include <atomic>
+#include <mutex>
 #ifdef __unix
 	#include <unistd.h>
 #endif
@@ -48,6 +50,8 @@ std::string ToStr(const T & obj) {
 	return oss.str();
 }
 
+std::string JsonEscape(const std::string & s); ///< escape for use inside "..." of JSON string (without the quotes)
+
 struct cNullstream : std::ostream {
     cNullstream() : std::ios(0), std::ostream(0) {}
 };
@@ -57,8 +61,17 @@ extern cNullstream g_nullstream; // a stream that does nothing (eats/discards da
 
 // _dbg_ignore is moved to global namespace (on purpose)
 
+// Messages below this level are removed at compile time (e.g. -DCFG_LOG_COMPILE_MIN_LEVEL=50 drops all _dbg*),
+// set from cmake: -DLOG_COMPILE_MIN_LEVEL=50
+#ifndef CFG_LOG_COMPILE_MIN_LEVEL
+	#define CFG_LOG_COMPILE_MIN_LEVEL 0
+#endif
+
 // TODO make _dbg_ignore thread-safe everywhere
-#define _debug_level_c(CHANNEL,LEVEL,VAR) do { if (_dbg_ignore< LEVEL) { \
+// Arguments (VAR, and the code stamp) are evaluated only when the message will really be written - so e.g. DbgVector() in
+// _dbg3 costs nothing when debug is off. Order of checks: compile-time constants first, then logger's cheap level check.
+#define _debug_level_c(CHANNEL,LEVEL,VAR) do { if ((LEVEL >= CFG_LOG_COMPILE_MIN_LEVEL) && (_dbg_ignore< LEVEL) \
+	&& gCurrentLogger.enabled(LEVEL,CHANNEL)) { \
 		gCurrentLogger.write_stream(LEVEL,CHANNEL) << OT_CODE_STAMP << ' ' << VAR << gCurrentLogger.endline() << std::flush; \
 	} } while(0)
 
@@ -98,9 +111,18 @@ class cLogger {
 		std::ostream & write_stream(int level);
 		std::ostream & write_stream(int level, const std::string & channel);
 
+		/// would message be written? Called by debug macros before formatting the message. Usually one integer compare.
+		bool enabled(int level, const std::string & channel) {
+			if (level < mLevelFloor) return false; // lowest level that any channel writes - nothing to format
+			if (channel.empty() && mMainOff) return false; // debug is off - channel files are still written
+			return (!mHasChannelLevels) || (level >= ChannelLevel(channel));
+		}
+		bool enabled(int level) { return enabled(level, ""); }
+
 		void setOutStreamFromGlobalOptions(); // set debug level, file etc - according to global Options
 		void setOutStreamFile(const std::string &fname); // switch to using this file
 		void setDebugLevel(int level); // change the debug level e.g. to mute debug from now
+		void setChannelLevel(const std::string & channel, int level); // channel (and its sub-channels "channel/...") uses this level instead
 
 		std::string icon(int level) const;
 		std::string endline() const;
@@ -113,6 +135,15 @@ class cLogger {
 
 		int mLevel; // current debug level
 
+		std::atomic<int> mLevelFloor; // min of mLevel and channel levels
+		std::atomic<bool> mMainOff; // main output goes nowhere (debug is off)
+		std::atomic<bool> mHasChannelLevels; // mChannelLevels is not empty - read without the lock
+		std::map< std::string, int > mChannelLevels; // set by setChannelLevel (usually empty)
+		std::map< std::string, int > mChannelLevelCache; // effective level of each channel seen, cleared when levels change
+		std::mutex mChannelMutex; // for the two maps above (debug is written from worker threads too)
+
+		int ChannelLevel(const std::string & channel);
+		void UpdateLevelFloor();
 		std::ostream & SelectOutput(int level, const std::string & channel);
 		void OpenNewChannel(const std::string & channel);
 		std::string GetLogBaseDir() const;
@@ -307,8 +338,8 @@ class cEnvUtils {
 	const string ReadFromTmpFile();
 public:
 	const string Compose();
-	const string ReadFromFile(const string path);
-	void WriteToFile(const string path, const string content);
+	const string ReadFromFile(const string & path);
+	void WriteToFile(const string & path, const string & content);
 	bool FileExist(string filename);
 };
 void hintingToTxt(std::fstream & file, string command, vector<string> &commands);
@@ -0,0 +1,319 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "wallet_host.hpp"
+
+#include "lib_common2.hpp"
+#include "trace.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+// ====================================================================
+
+cSessionLru::cSessionLru(size_t budgetBytes, size_t maxSessions, std::time_t idleSeconds)
+: mBudgetBytes(budgetBytes), mMaxSessions(maxSessions), mIdleSeconds(idleSeconds)
+{ }
+
+bool cSessionLru::Has(const string & key) const {
+	return mIndex.count(key) > 0;
+}
+
+void cSessionLru::Touch(const string & key, std::time_t now) {
+	auto found = mIndex.find(key);
+	if (found == mIndex.end()) {
+		mSessions.push_front( cSession{ key, now, 0, 0 } );
+	} else {
+		mSessions.splice(mSessions.begin(), mSessions, found->second); // iterators stay valid
+		mSessions.front().mLastUse = now;
+	}
+	mIndex[key] = mSessions.begin();
+}
+
+void cSessionLru::Begin(const string & key) {
+	auto found = mIndex.find(key);
+	if (found != mIndex.end()) ++found->second->mInFlight;
+}
+
+void cSessionLru::End(const string & key) {
+	auto found = mIndex.find(key);
+	if ((found != mIndex.end()) && (found->second->mInFlight > 0)) --found->second->mInFlight;
+}
+
+void cSessionLru::SetBytes(const string & key, size_t bytes) {
+	auto found = mIndex.find(key);
+	if (found != mIndex.end()) found->second->mBytes = bytes;
+}
+
+void cSessionLru::Erase(const string & key) {
+	auto found = mIndex.find(key);
+	if (found == mIndex.end()) return;
+	mSessions.erase(found->second);
+	mIndex.erase(found);
+}
+
+vector<string> cSessionLru::PickEvictions(std::time_t now, const string & keep) const {
+	vector<string> victims;
+	size_t bytes = GetTotalBytes();
+	size_t count = mSessions.size();
+	for (auto it = mSessions.rbegin(); it != mSessions.rend(); ++it) { // least recently used first
+		const bool idle = (it->mInFlight == 0) && (it->mKey != keep);
+		if (!idle) continue;
+		const bool expired = (now - it->mLastUse) >= mIdleSeconds;
+		const bool over = (bytes > mBudgetBytes) || (count > mMaxSessions);
+		if (!expired && !over) continue;
+		victims.push_back(it->mKey);
+		bytes -= it->mBytes;
+		--count;
+	}
+	return victims;
+}
+
+size_t cSessionLru::GetTotalBytes() const {
+	size_t bytes = 0;
+	for (const auto & session : mSessions) bytes += session.mBytes;
+	return bytes;
+}
+
+size_t cSessionLru::GetCount() const {
+	return mSessions.size();
+}
+
+// ====================================================================
+
+cWalletHost::cWalletHost(const string & pipeIn, tWorker worker, size_t budgetBytes, size_t maxSessions, std::time_t idleSeconds)
+: mPipeIn(pipeIn), mDir(pipeIn.substr(0, pipeIn.rfind('/'))), mWorker(worker), mLru(budgetBytes, maxSessions, idleSeconds), mInFd(-1), mFinished(false)
+{
+	mDonePipe[0] = mDonePipe[1] = -1;
+}
+
+cWalletHost::~cWalletHost() {
+	vector<string> homes;
+	for (const auto & worker : mWorkers) homes.push_back(worker.first);
+	for (const auto & home : homes) Stop(home);
+	while (waitpid(-1, nullptr, 0) > 0) { } // workers finish their current request and exit on EOF
+	if (mInFd >= 0) { close(mInFd); unlink(mPipeIn.c_str()); rmdir(mDir.c_str()); } // (directory stays while a reply is not read yet)
+	if (mDonePipe[0] >= 0) close(mDonePipe[0]);
+	if (mDonePipe[1] >= 0) close(mDonePipe[1]);
+}
+
+int cWalletHost::Run() {
+	if (mDir.empty() || (mDir == mPipeIn)) { nUtils::reportError("Host pipe must be in a directory: " + mPipeIn); return 1; }
+	if ((mkdir(mDir.c_str(), 0700) != 0) && (errno != EEXIST)) { nUtils::reportError("Can not create host directory " + mDir); return 1; }
+	if (!CheckPrivate(mDir, true)) { nUtils::reportError("Host directory " + mDir + " is not private to this user (mode 0700)"); return 1; }
+	if ((mkfifo(mPipeIn.c_str(), 0600) != 0) && (errno != EEXIST)) { nUtils::reportError("Can not create host pipe " + mPipeIn); return 1; }
+	if (!CheckPrivate(mPipeIn, false)) { nUtils::reportError("Host pipe " + mPipeIn + " is not our private fifo"); return 1; }
+	mInFd = open(mPipeIn.c_str(), O_RDWR | O_NONBLOCK | O_NOFOLLOW); // read+write: no EOF when last client closes
+	if (mInFd < 0) { nUtils::reportError("Can not open host pipe " + mPipeIn); return 1; }
+	if (pipe(mDonePipe) != 0) { nUtils::reportError("Can not create pipe for workers"); return 1; }
+	fcntl(mDonePipe[0], F_SETFL, O_NONBLOCK);
+	signal(SIGPIPE, SIG_IGN); // worker that died while we write to it is handled by ReapWorkers
+	nUtils::cTrace::CatchTerminate(); // SIGTERM ends the loop like QUIT (workers are stopped, trace is written)
+	_note("Wallet host listening on " << mPipeIn);
+
+	const int pollMs = 1000; // to notice idle sessions even with no requests
+	while (!mFinished && !nUtils::cTrace::TerminateRequested()) {
+		vector<struct pollfd> fds{ { mInFd, POLLIN, 0 }, { mDonePipe[0], POLLIN, 0 } };
+		for (const auto & worker : mWorkers) if (!worker.second.mUnsent.empty()) fds.push_back( { worker.second.mRequestFd, POLLOUT, 0 } );
+		const int ready = poll(fds.data(), fds.size(), pollMs);
+		if ((ready < 0) && (errno != EINTR)) { nUtils::reportError("poll failed in wallet host"); return 1; }
+
+		CollectDone(); // first, so a session that just answered can be evicted
+
+		vector<string> failed;
+		for (auto & worker : mWorkers) if (!Flush(worker.second)) failed.push_back(worker.first);
+		for (const auto & home : failed) { _warn("Worker of " << home << " does not take requests, stopping it"); Stop(home, true); }
+
+		char buff[8192];
+		ssize_t got;
+		while ((got = read(mInFd, buff, sizeof(buff))) > 0) mInBuffer.append(buff, got);
+		for (size_t nl = mInBuffer.find('\n'); nl != string::npos; nl = mInBuffer.find('\n')) {
+			const string request = mInBuffer.substr(0, nl);
+			mInBuffer.erase(0, nl + 1);
+			if (!request.empty()) Handle(request);
+		}
+
+		ReapWorkers();
+		Evict("");
+	}
+	_note("Wallet host finished, sessions left: " << mWorkers.size());
+	return 0;
+}
+
+void cWalletHost::Handle(const string & request) {
+	_dbg2("Wallet host got request: " << request);
+	if (request == "QUIT") { mFinished = true; return; }
+	const size_t sep1 = request.find(' ');
+	const size_t sep2 = (sep1 == string::npos) ? string::npos : request.find(' ', sep1 + 1);
+	const size_t sep3 = (sep2 == string::npos) ? string::npos : request.find(' ', sep2 + 1);
+	if ((sep3 == string::npos) || (request.substr(0, sep1) != "run")) { _warn("Invalid request for wallet host: " << request); return; }
+	const string reply = request.substr(sep1 + 1, sep2 - sep1 - 1);
+	const string home = request.substr(sep2 + 1, sep3 - sep2 - 1);
+	const string line = request.substr(sep3 + 1);
+	if (!IsReplyPath(reply)) { _warn("Wallet host refuses reply file outside of " << mDir << ": " << reply); return; } // and does not write there
+	if (!Route(reply, home, line)) ReplyError(reply, "wallet host could not run the command for " + home);
+}
+
+bool cWalletHost::IsReplyPath(const string & reply) const {
+	if (!nUtils::CheckIfBegins(mDir + "/", reply)) return false;
+	const string name = reply.substr(mDir.size() + 1);
+	return !name.empty() && (name.find('/') == string::npos) && (name != ".") && (name != "..") && (reply != mPipeIn);
+}
+
+bool cWalletHost::Route(const string & reply, const string & home, const string & line) {
+	if (!mWorkers.count(home) && !Spawn(home)) return false;
+	cWorkerProc & worker = mWorkers.at(home);
+	worker.mUnsent += "run " + reply + " " + line + "\n";
+	worker.mQueued.push_back(reply);
+	if (!Flush(worker)) { // the rest waits in the queue when the pipe is full (worker busy with a long command)
+		_warn("Worker of " << home << " does not take requests, stopping it");
+		Stop(home, true); // also answers this request
+		return true;
+	}
+	mLru.Touch(home, std::time(nullptr));
+	mLru.Begin(home);
+	Evict(home); // a new session can push others over the budget
+	return true;
+}
+
+bool cWalletHost::Flush(cWorkerProc & worker) {
+	while (!worker.mUnsent.empty()) {
+		const ssize_t wrote = write(worker.mRequestFd, worker.mUnsent.data(), worker.mUnsent.size());
+		if (wrote < 0) {
+			if (errno == EINTR) continue;
+			return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+		}
+		for (size_t nl = worker.mUnsent.find('\n'); (nl != string::npos) && (nl < static_cast<size_t>(wrote)); nl = worker.mUnsent.find('\n', nl + 1)) {
+			worker.mInFlight.push_back(worker.mQueued.front()); // written whole: the worker has it now
+			worker.mQueued.pop_front();
+		}
+		worker.mUnsent.erase(0, wrote);
+	}
+	return true;
+}
+
+bool cWalletHost::Spawn(const string & home) {
+	int requestPipe[2];
+	if (pipe(requestPipe) != 0) return nUtils::reportError("Can not create request pipe for " + home);
+	const pid_t pid = fork();
+	if (pid < 0) {
+		close(requestPipe[0]); close(requestPipe[1]);
+		return nUtils::reportError("Can not fork worker for " + home);
+	}
+	if (pid == 0) { // worker
+		close(requestPipe[1]);
+		close(mInFd);
+		close(mDonePipe[0]);
+		for (const auto & worker : mWorkers) close(worker.second.mRequestFd); // others must see EOF when host closes them
+		int status = 1;
+		try { status = mWorker(home, requestPipe[0], mDonePipe[1]); }
+		catch (const std::exception & e) { _erro("Wallet worker for " << home << " failed: " << e.what()); }
+		_exit(status);
+	}
+	close(requestPipe[0]);
+	fcntl(requestPipe[1], F_SETFL, O_NONBLOCK); // @see Flush
+	mWorkers[home] = cWorkerProc{ pid, requestPipe[1], "", {}, {} };
+	mHomeByPid[pid] = home;
+	mLru.Touch(home, std::time(nullptr));
+	_info("Started worker " << pid << " for wallet " << home << " (sessions: " << mWorkers.size() << ")");
+	return true;
+}
+
+void cWalletHost::Stop(const string & home, bool crashed) {
+	auto found = mWorkers.find(home);
+	if (found == mWorkers.end()) return;
+	_info("Stopping worker " << found->second.mPid << " of wallet " << home);
+	close(found->second.mRequestFd); // worker exits on EOF, after requests already sent; reaped in ReapWorkers
+	vector<string> unanswered(found->second.mQueued.begin(), found->second.mQueued.end());
+	if (crashed) unanswered.insert(unanswered.end(), found->second.mInFlight.begin(), found->second.mInFlight.end());
+	for (const auto & reply : unanswered) {
+		struct stat flag;
+		if (lstat((reply + ".ready").c_str(), &flag) == 0) continue; // answered just before it exited
+		ReplyError(reply, "worker of wallet " + home + " stopped before answering");
+	}
+	mHomeByPid.erase(found->second.mPid);
+	mWorkers.erase(found);
+	mLru.Erase(home);
+}
+
+void cWalletHost::CollectDone() {
+	char buff[512];
+	ssize_t got;
+	while ((got = read(mDonePipe[0], buff, sizeof(buff))) > 0) mDoneBuffer.append(buff, got);
+	for (size_t nl = mDoneBuffer.find('\n'); nl != string::npos; nl = mDoneBuffer.find('\n')) {
+		const pid_t pid = static_cast<pid_t>(std::atol(mDoneBuffer.substr(0, nl).c_str()));
+		mDoneBuffer.erase(0, nl + 1);
+		auto found = mHomeByPid.find(pid);
+		if (found == mHomeByPid.end()) continue; // already stopped
+		auto & in_flight = mWorkers.at(found->second).mInFlight;
+		if (!in_flight.empty()) in_flight.pop_front(); // worker answers in order
+		mLru.End(found->second);
+		mLru.Touch(found->second, std::time(nullptr)); // idle time counts from the answer
+	}
+}
+
+void cWalletHost::ReapWorkers() {
+	pid_t pid;
+	while ((pid = waitpid(-1, nullptr, WNOHANG)) > 0) {
+		auto found = mHomeByPid.find(pid);
+		if (found == mHomeByPid.end()) continue; // stopped by us
+		_warn("Worker " << pid << " of wallet " << found->second << " exited");
+		Stop(found->second, true);
+	}
+}
+
+void cWalletHost::Evict(const string & keep) {
+	for (const auto & worker : mWorkers) mLru.SetBytes(worker.first, ReadRss(worker.second.mPid));
+	for (const auto & home : mLru.PickEvictions(std::time(nullptr), keep)) Stop(home);
+}
+
+bool cWalletHost::CheckPrivate(const string & path, bool isDir) {
+	struct stat info;
+	if (lstat(path.c_str(), &info) != 0) return false;
+	const bool type_ok = isDir ? S_ISDIR(info.st_mode) : S_ISFIFO(info.st_mode);
+	return type_ok && (info.st_uid == getuid()) && ((info.st_mode & (S_IRWXG | S_IRWXO)) == 0);
+}
+
+int cWalletHost::OpenReply(const string & reply) {
+	return open(reply.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW, 0600);
+}
+
+bool cWalletHost::MarkReady(const string & reply) {
+	const int fd = OpenReply(reply + ".ready");
+	if (fd < 0) return false;
+	close(fd);
+	return true;
+}
+
+void cWalletHost::ReplyError(const string & reply, const string & msg) {
+	_erro(msg);
+	unlink(reply.c_str()); // output of a worker that crashed (reply is in our private directory)
+	const int fd = OpenReply(reply);
+	if (fd < 0) { _warn("Can not write reply file " << reply); return; }
+	const string text = "ERROR: " + msg + "\n";
+	if (write(fd, text.c_str(), text.size()) < 0) _warn("Can not write reply file " << reply);
+	close(fd);
+	MarkReady(reply);
+}
+
+size_t cWalletHost::ReadRss(pid_t pid) {
+	std::ifstream statm("/proc/" + ToStr(pid) + "/statm"); // pages: size resident ...
+	size_t size = 0, resident = 0;
+	if (!(statm >> size >> resident)) return 0;
+	return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE)); // counts pages shared with host too - errs on the safe side
+}
+
+} // namespace nUse
+} // namespace nOT
+
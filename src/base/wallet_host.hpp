@@ -0,0 +1,125 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Host process serving many wallets: one warm worker process per wallet home, kept in LRU within a memory budget
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_wallet_host
+#define INCLUDE_OT_NEWCLI_wallet_host
+
+#include "lib_common2.hpp"
+
+#include <ctime>
+#include <deque>
+#include <sys/types.h>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+LRU bookkeeping of wallet sessions (no processes here, so it can be tested alone).
+Session with requests in flight is never picked for eviction.
+*/
+class cSessionLru { MAKE_CLASS_NAME("cSessionLru");
+	public:
+		cSessionLru(size_t budgetBytes, size_t maxSessions, std::time_t idleSeconds);
+
+		bool Has(const string & key) const;
+		void Touch(const string & key, std::time_t now); ///< adds session or makes it most recently used
+		void Begin(const string & key); ///< request sent to session
+		void End(const string & key); ///< session answered a request
+		void SetBytes(const string & key, size_t bytes);
+		void Erase(const string & key);
+
+		/// sessions to stop: idle longer than idleSeconds, then least recently used ones while over budget or count
+		vector<string> PickEvictions(std::time_t now, const string & keep = "") const;
+
+		size_t GetTotalBytes() const;
+		size_t GetCount() const;
+
+	protected:
+		struct cSession {
+			string mKey;
+			std::time_t mLastUse;
+			size_t mBytes;
+			unsigned int mInFlight;
+		};
+
+		const size_t mBudgetBytes;
+		const size_t mMaxSessions;
+		const std::time_t mIdleSeconds;
+
+		list<cSession> mSessions; ///< most recently used first
+		map<string, list<cSession>::iterator> mIndex;
+};
+
+/**
+Serves requests for many wallet homes from one long running process.
+OTAPI keeps its state (data folder, loaded wallet) in process-wide singletons, so each wallet gets its own forked
+worker process, that loads OTAPI once (with HOME set to the wallet home) and then runs requests while it is kept.
+Host itself never loads OTAPI. Requests, read from fifo pipeIn, one per line:
+	run <reply-file> <wallet-home> <command line>
+	QUIT
+Worker writes command output to reply-file, then creates reply-file.ready (as the completion daemon does).
+The directory of pipeIn must be private (owned by us, mode 0700; it is created so), and reply-file must be directly
+in it; reply files are created only if they do not exist yet and never through a symlink.
+Requests are queued per worker and written without blocking, so one busy worker does not stall the others; if a
+worker exits, every request it did not answer gets an error reply.
+Sessions are stopped when idle too long, or least recently used first when their memory (RSS) is over budget.
+Paths with spaces are not supported.
+*/
+class cWalletHost { MAKE_CLASS_NAME("cWalletHost");
+	public:
+		/// runs in forked worker: reads "run <reply-file> <command line>" lines from requestFd until EOF,
+		/// after each request writes its pid and '\n' to doneFd. Returns exit status of worker
+		typedef function<int (const string & home, int requestFd, int doneFd)> tWorker;
+
+		cWalletHost(const string & pipeIn, tWorker worker, size_t budgetBytes, size_t maxSessions, std::time_t idleSeconds);
+		~cWalletHost(); ///< stops all workers
+
+		int Run(); ///< serves requests until QUIT, returns exit status
+
+		/// path exists, is a directory (or fifo), owned by this user and not accessible by others - checked without following links
+		static bool CheckPrivate(const string & path, bool isDir);
+		static int OpenReply(const string & reply); ///< creates new reply file for writing (O_EXCL, O_NOFOLLOW), -1 on error
+		static bool MarkReady(const string & reply); ///< creates reply.ready the same way
+
+	protected:
+		struct cWorkerProc {
+			pid_t mPid;
+			int mRequestFd; ///< write end of worker's request pipe, non-blocking
+			string mUnsent; ///< requests not yet written to the pipe (it was full)
+			std::deque<string> mQueued; ///< reply files of requests in mUnsent
+			std::deque<string> mInFlight; ///< reply files of requests written to worker, not answered yet (in order)
+		};
+
+		void Handle(const string & request);
+		bool IsReplyPath(const string & reply) const; ///< directly in mDir
+		bool Route(const string & reply, const string & home, const string & line);
+		bool Flush(cWorkerProc & worker); ///< writes what the pipe takes now; false on error
+		bool Spawn(const string & home);
+		void Stop(const string & home, bool crashed = false); ///< error replies for requests the worker will not answer
+		void CollectDone();
+		void ReapWorkers(); ///< workers that exited by themselves (crashed) are forgotten
+		void Evict(const string & keep);
+		static void ReplyError(const string & reply, const string & msg); ///< so client waiting for reply does not time out
+		static size_t ReadRss(pid_t pid); ///< 0 if unknown
+
+		const string mPipeIn;
+		const string mDir; ///< of mPipeIn
+		tWorker mWorker;
+		cSessionLru mLru;
+		map<string, cWorkerProc> mWorkers; ///< by wallet home
+		map<pid_t, string> mHomeByPid;
+		int mInFd;
+		int mDonePipe[2];
+		string mInBuffer, mDoneBuffer; ///< partial lines
+		bool mFinished;
+};
+
+} // namespace nUse
+} // namespace nOT
+
+#endif
+
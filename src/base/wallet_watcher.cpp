@@ -0,0 +1,150 @@
+/* See other files here for the LICENCE that applies here. */
+/* See header file .hpp for info */
+
+#include "wallet_watcher.hpp"
+
+#include "lib_common2.hpp"
+
+#ifdef __linux__
+	#include <sys/inotify.h>
+	#include <poll.h>
+	#include <unistd.h>
+	#include <fcntl.h>
+#endif
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+cWalletWatcher::cWalletWatcher(const string & dataFolder)
+: mParentWatches(0), mFd(-1), mActive(false), mChanged(0), mGeneration(0)
+{
+	mWakePipe[0] = mWakePipe[1] = -1;
+#ifdef __linux__
+	mFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (mFd < 0) { _warn("inotify not available, wallet changes will not be watched"); return; }
+	if (pipe(mWakePipe) != 0) { _warn("Can not create pipe for wallet watcher"); close(mFd); mFd = -1; return; }
+
+	const string clientData = dataFolder + "client_data/";
+	Add(dataFolder, "defaults.opt", eDefaults);
+	Add(clientData, "wallet.xml", eWallet);
+	Add(clientData + "nyms/", "", eNyms);
+	Add(clientData + "accounts/", "", eAccounts);
+	Add(clientData + "contracts/", "", eAssets | eServers); // asset and server contracts are in the same place
+	Add(clientData + "addressbook/", "", eAddressBook);
+
+	mActive = !mWatches.empty() || (mParentWatches > 0);
+	if (mActive) mThread = std::thread( [this]() { Worker(); } );
+#else
+	_info("Wallet watcher is not implemented on this platform");
+#endif
+}
+
+cWalletWatcher::~cWalletWatcher() {
+#ifdef __linux__
+	if (mThread.joinable()) {
+		const char wake = 1;
+		if (write(mWakePipe[1], &wake, 1) != 1) _warn("Can not wake wallet watcher");
+		mThread.join();
+	}
+	for (int fd : { mFd, mWakePipe[0], mWakePipe[1] }) if (fd >= 0) close(fd);
+#endif
+}
+
+void cWalletWatcher::Add(const string & dir, const string & file, unsigned segments) {
+#ifdef __linux__
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+	int wd = inotify_add_watch(mFd, dir.c_str(), mask | IN_MASK_ADD); // (add: dir can be watched already as parent)
+	if (wd < 0) {
+		_dbg1("Not watching " << dir << " yet (does not exist?)");
+		mMissing.push_back( cWatch{ dir, file, segments } );
+		WatchParent(dir);
+		return;
+	}
+	mWatches[wd].push_back( cWatch{ dir, file, segments } ); // same dir can be added for many files
+	_dbg2("Watching " << dir << file << " for " << SegmentsToStr(segments));
+#endif
+}
+
+bool cWalletWatcher::WatchParent(const string & dir) {
+#ifdef __linux__
+	const auto slash = dir.rfind('/', dir.size() >= 2 ? dir.size() - 2 : 0); // "a/b/c/" -> "a/b/"
+	if ((slash == string::npos) || (slash == 0)) return false;
+	const string parent = dir.substr(0, slash + 1);
+	const uint32_t mask = IN_CREATE | IN_MOVED_TO | IN_ONLYDIR | IN_MASK_ADD;
+	if (inotify_add_watch(mFd, parent.c_str(), mask) >= 0) { ++mParentWatches; return true; }
+	return WatchParent(parent); // e.g. client_data/ is missing too
+#else
+	return false;
+#endif
+}
+
+unsigned cWalletWatcher::AddMissing() {
+	unsigned appeared = 0;
+	auto missing = mMissing;
+	mMissing.clear();
+	for (const auto & watch : missing) {
+		const size_t before = mMissing.size();
+		Add(watch.mDir, watch.mFile, watch.mSegments); // puts it back to mMissing if still not there
+		if (mMissing.size() == before) {
+			_info("Now watching " << watch.mDir << watch.mFile);
+			appeared |= watch.mSegments;
+		}
+	}
+	return appeared;
+}
+
+unsigned cWalletWatcher::TakeChanged() {
+	if (mChanged.load(std::memory_order_relaxed) == 0) return 0; // usual case - no atomic write
+	return mChanged.exchange(0);
+}
+
+string cWalletWatcher::SegmentsToStr(unsigned segments) {
+	const vector<std::pair<unsigned, string>> names = { {eNyms,"nyms"}, {eAccounts,"accounts"}, {eAssets,"assets"},
+		{eServers,"servers"}, {eDefaults,"defaults"}, {eAddressBook,"addressbook"}, {eWallet,"wallet"} };
+	string ret;
+	for (const auto & name : names) if (segments & name.first) ret += (ret.empty() ? "" : ",") + name.second;
+	return ret;
+}
+
+void cWalletWatcher::Worker() {
+#ifdef __linux__
+	_dbg1("Wallet watcher started");
+	alignas(struct inotify_event) char buff[4096];
+	while (true) {
+		struct pollfd fds[2] = { { mFd, POLLIN, 0 }, { mWakePipe[0], POLLIN, 0 } };
+		if (poll(fds, 2, -1) < 0) continue; // e.g. EINTR
+		if (fds[1].revents) break; // finishing
+
+		unsigned changed = 0;
+		bool new_dir = false;
+		ssize_t len;
+		while ((len = read(mFd, buff, sizeof(buff))) > 0) {
+			for (char * ptr = buff; ptr < buff + len; ) {
+				const struct inotify_event * event = reinterpret_cast<const struct inotify_event *>(ptr);
+				const string name = (event->len) ? event->name : "";
+				if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) new_dir = true;
+				auto found = mWatches.find(event->wd);
+				if (found != mWatches.end()) {
+					for (const auto & watch : found->second) {
+						if (watch.mFile.empty() || (watch.mFile == name)) changed |= watch.mSegments;
+					}
+				}
+				ptr += sizeof(struct inotify_event) + event->len;
+			}
+		}
+		if (new_dir && !mMissing.empty()) changed |= AddMissing();
+		if (changed) {
+			mChanged |= changed;
+			++mGeneration;
+			_info("Wallet files changed: " << SegmentsToStr(changed) << ", generation " << mGeneration);
+		}
+	}
+	_dbg1("Wallet watcher finished");
+#endif
+}
+
+} // namespace nUse
+} // namespace nOT
+
@@ -0,0 +1,70 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+Watching wallet files (inotify) to know which cached data became stale, without asking OTAPI on every hint
+*/
+
+#ifndef INCLUDE_OT_NEWCLI_wallet_watcher
+#define INCLUDE_OT_NEWCLI_wallet_watcher
+
+#include "lib_common2.hpp"
+
+#include <thread>
+#include <atomic>
+
+namespace nOT {
+namespace nUse {
+
+INJECT_OT_COMMON_USING_NAMESPACE_COMMON_2 // <=== namespaces
+
+/**
+Watches (non-recursive) the data folder: defaults file, client_data/wallet.xml, and directories nyms/ accounts/ contracts/ addressbook/.
+A change (by this or other process) marks the affected segments as changed and bumps the generation.
+A directory that does not exist yet is watched from the moment it is created (its parent is watched for that).
+Thread blocks in poll() until something happens, so there is no polling per TAB: the user of cache only calls TakeChanged(),
+which is one atomic operation when nothing changed.
+Works on Linux (inotify); elsewhere IsActive() is false and caller should keep checking OTAPI itself.
+*/
+class cWalletWatcher { MAKE_CLASS_NAME("cWalletWatcher");
+	public:
+		enum eSegment : unsigned {
+			eNyms = 1, eAccounts = 2, eAssets = 4, eServers = 8, eDefaults = 16, eAddressBook = 32,
+			eWallet = 64, ///< wallet.xml itself (it has the names of nyms, accounts, assets, servers)
+		};
+
+		cWalletWatcher(const string & dataFolder); ///< dataFolder ends with '/'
+		~cWalletWatcher();
+
+		bool IsActive() const { return mActive; }
+		unsigned TakeChanged(); ///< segments changed since last call (bits of eSegment), 0 if none
+		uint64_t GetGeneration() const { return mGeneration; } ///< grows with every change
+
+		static string SegmentsToStr(unsigned segments);
+
+	protected:
+		void Add(const string & dir, const string & file, unsigned segments); ///< file="" means any file in dir
+		bool WatchParent(const string & dir); ///< to see dir being created
+		unsigned AddMissing(); ///< watch directories that appeared; returns their segments (files could be there already)
+		void Worker();
+
+		struct cWatch {
+			string mDir;
+			string mFile;
+			unsigned mSegments;
+		};
+
+		map<int, vector<cWatch>> mWatches; ///< inotify watch descriptor -> what it means
+		vector<cWatch> mMissing; ///< directory did not exist yet
+		size_t mParentWatches; ///< watches made only to see missing directories being created
+		int mFd; ///< inotify
+		int mWakePipe[2]; ///< to wake the worker when finishing
+		bool mActive;
+		std::atomic<unsigned> mChanged;
+		std::atomic<uint64_t> mGeneration;
+		std::thread mThread;
+};
+
+} // namespace nUse
+} // namespace nOT
+
+#endif
+
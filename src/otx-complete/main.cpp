@@ -0,0 +1,112 @@
+/* See other files here for the LICENCE that applies here. */
+/*
+otx-complete - minimal client of the completion daemon, for bash TAB completion:
+  otx-complete "ot msg send ali"
+It does not link opentxs (nor editline, nor the command tree), so it starts in about a millisecond,
+sends the line to the daemon and prints the completions.
+When daemon is not running, it runs the full otx --complete-one, which starts the daemon (and answers this first request).
+Protocol is the one of cInteractiveShell::CompleteOnceWithDaemon and cDaemoninfoComplete (keep them in sync):
+  request "complete <reply-file> <line>\n" written to fifo /tmp/ot.in,
+  daemon writes completions (one per line) to <reply-file>, then creates <reply-file>.ready
+*/
+
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+#include <ctime>
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using std::string;
+
+namespace {
+
+const char * const gPipeIn = "/tmp/ot.in"; // as cDaemoninfoComplete::GetPathIn()
+const int gTimeoutMs = 5000;
+
+bool FileExists(const string & path) {
+	struct stat buf;
+	return stat(path.c_str(), &buf) == 0;
+}
+
+/// The full otx, next to our binary (or $OTX_BINARY), to start the daemon with
+string OtxBinary() {
+	const char * env = getenv("OTX_BINARY");
+	if (env && *env) return env;
+	char self[4096];
+	ssize_t len = readlink("/proc/self/exe", self, sizeof(self)-1);
+	if (len > 0) {
+		string dir(self, len);
+		dir = dir.substr(0, dir.rfind('/') + 1);
+		if (FileExists(dir + "otx")) return dir + "otx";
+	}
+	return "otx"; // from PATH
+}
+
+int StartDaemonAndComplete(const string & line) {
+	const string otx = OtxBinary();
+	execlp(otx.c_str(), otx.c_str(), "--complete-one", line.c_str(), (char*)NULL); // its output is our output
+	std::cerr << "otx-complete: can not run " << otx << ": " << strerror(errno) << std::endl;
+	return 1;
+}
+
+/// true if request was sent; false if there is no daemon listening (then stale fifo is removed)
+bool SendRequest(const string & request) {
+	int fd = open(gPipeIn, O_WRONLY | O_NONBLOCK); // non blocking: fails with ENXIO instead of hanging when nobody reads
+	if (fd < 0) {
+		if (errno == ENXIO) unlink(gPipeIn); // left by daemon that died, otx would wait on it forever
+		return false;
+	}
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+	bool ok = write(fd, request.c_str(), request.size()) == (ssize_t)request.size(); // below PIPE_BUF - not mixed with other clients
+	close(fd);
+	return ok;
+}
+
+bool WaitForReply(const string & flagFile) {
+	auto start = std::chrono::steady_clock::now();
+	int sleepUs = 50; // daemon usually answers in well under a millisecond, then back off
+	while (!FileExists(flagFile)) {
+		if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(gTimeoutMs)) return false;
+		std::this_thread::sleep_for(std::chrono::microseconds(sleepUs));
+		sleepUs = std::min(sleepUs * 2, 2000);
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, const char **argv) {
+	if (argc != 2) {
+		std::cerr << "Usage: " << argv[0] << " \"ot msg send ali\"" << std::endl;
+		return 2;
+	}
+	const string line = argv[1];
+	if (line.find('\n') != string::npos) return 2; // would break the line based protocol
+
+	const string reply = "/tmp/ot." + std::to_string(getpid()) + std::to_string(time(NULL)) + ".out";
+	const string replyFlag = reply + ".ready";
+
+	if (!FileExists(gPipeIn) || !SendRequest("complete " + reply + " " + line + "\n")) return StartDaemonAndComplete(line);
+
+	if (!WaitForReply(replyFlag)) {
+		std::cerr << "otx-complete: timeout waiting for completion daemon" << std::endl;
+		return 1;
+	}
+
+	std::ifstream replyFile(reply);
+	string word;
+	while (replyFile >> word) std::cout << word << " ";
+	std::cout << std::endl;
+
+	unlink(reply.c_str());
+	unlink(replyFlag.c_str());
+	return 0;
+}
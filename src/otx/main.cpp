@@ -2,6 +2,7 @@
 
 #include "../base/lib_common1.hpp"
 #include "../base/runoptions.hpp"
+#include "../base/stats.hpp"
 
 #include "../base/otcli.hpp"
 
@@ -25,6 +26,7 @@ int main(int argc, const char **argv) {
 		// +debug +debugfile <-- this will be Executed by gRunOptions
 
 		gCurrentLogger.setOutStreamFromGlobalOptions();
+		nOT::nUtils::gTrace.SetThreadName("main");
 		_dbg1("Running the program with arguments: " + nOT::nUtils::vectorToStr(args_clear));
 
 		#define COMPILER_VERSION "(unknown)"
@@ -58,6 +60,9 @@ int main(int argc, const char **argv) {
 	// nOT::nTests::exampleOfOT(); // TODO from script
 	// nOT::nTests::testcase_run_all_tests(); // TODO from script
 
+	nOT::nUtils::gStats.ReportIfEnabled(); // +stats
+	nOT::nUtils::gTrace.Flush(); // +trace=<file>
+
 	_dbg2("The main will now return with ret="<<ret);
 
 
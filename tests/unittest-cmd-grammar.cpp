@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/cmd_grammar.hpp"
+
+using namespace nOT::nNewcli;
+typedef cCmdGrammar::tToken tToken;
+typedef cCmdGrammar::tStatus tStatus;
+
+namespace {
+
+cCmdGrammar MakeGrammar() {
+	cCmdGrammar grammar;
+	grammar.Compile( {
+		{ "help", 0, 0 },
+		{ "help cmd", 1, 1 },
+		{ "msg ls", 0, 1 },
+		{ "msg send", 2, 1 },
+		{ "nym", 0, 0 },
+		{ "nym info", 1, 0 },
+	} );
+	return grammar;
+}
+
+vector<string> Words(const string & line) {
+	vector<string> words;
+	std::istringstream iss(line);
+	string word;
+	while (iss >> word) words.push_back(word);
+	return words;
+}
+
+vector<tToken> Tokens(const cCmdGrammar::cRun & run) {
+	vector<tToken> tokens;
+	for (const auto & word : run.mWord) tokens.push_back(word.mToken);
+	return tokens;
+}
+
+} // namespace
+
+TEST(cCmdGrammarTest, FindsFormats) {
+	auto grammar = MakeGrammar();
+	EXPECT_EQ(6u, grammar.Size());
+	EXPECT_EQ("msg send", grammar.Format(grammar.FindFormat("msg send")).mName);
+	EXPECT_EQ("nym", grammar.Format(grammar.FindFormat("nym")).mName);
+	EXPECT_EQ(-1, grammar.FindFormat("msg"));
+	EXPECT_EQ(-1, grammar.FindFormat("msg foo"));
+}
+
+TEST(cCmdGrammarTest, ClassifiesWords) {
+	auto grammar = MakeGrammar();
+	auto run = grammar.Run(Words("msg send alice bob hello --cc eve --dryrun --cc mark"), false);
+	ASSERT_EQ(tStatus::ok, run.mStatus);
+	EXPECT_EQ("msg send", grammar.Format(run.mFormat).mName);
+	EXPECT_EQ(2u, run.mNameWords);
+	EXPECT_EQ((vector<tToken>{ tToken::cmdname, tToken::cmdname, tToken::variable, tToken::variable, tToken::variable_ext,
+		tToken::option_name, tToken::option_value, tToken::option_name, tToken::option_name, tToken::option_value }), Tokens(run));
+	EXPECT_EQ(1, run.mWord.at(8).mSub); // second --cc
+	EXPECT_EQ(1, run.mWord.at(9).mSub);
+	EXPECT_EQ(tToken::option_name, run.mNext);
+}
+
+TEST(cCmdGrammarTest, OneAndTwoWordNames) {
+	auto grammar = MakeGrammar();
+	auto run = grammar.Run(Words("nym info alice"), false);
+	EXPECT_EQ("nym info", grammar.Format(run.mFormat).mName);
+	run = grammar.Run(Words("nym --dryrun"), false);
+	EXPECT_EQ("nym", grammar.Format(run.mFormat).mName);
+	EXPECT_EQ(tStatus::ok, run.mStatus);
+	run = grammar.Run(Words("nym"), false);
+	EXPECT_EQ(tToken::cmdname, run.mNext);
+	EXPECT_EQ(2, run.mNextSub);
+	EXPECT_TRUE(run.mNextMayBeOption);
+}
+
+TEST(cCmdGrammarTest, BadNameAndSyntax) {
+	auto grammar = MakeGrammar();
+	auto run = grammar.Run(Words("msg foo alice"), false);
+	EXPECT_EQ(tStatus::bad_name, run.mStatus);
+	EXPECT_EQ(2u, run.mNameWords);
+	EXPECT_EQ(tToken::none, run.mNext);
+
+	run = grammar.Run(Words("msg"), false);
+	EXPECT_EQ(tStatus::bad_name, run.mStatus);
+	EXPECT_EQ(tToken::cmdname, run.mNext);
+
+	run = grammar.Run(Words("msg ls alice bob"), false);
+	EXPECT_EQ(tStatus::syntax, run.mStatus);
+	EXPECT_EQ(3u, run.mErrorWord);
+
+	run = grammar.Run(Words("nym inf"), false);
+	EXPECT_EQ(tStatus::syntax, run.mStatus);
+	run = grammar.Run(Words("nym inf"), true); // tolerated while completing
+	EXPECT_EQ(tStatus::ok, run.mStatus);
+	EXPECT_EQ(tToken::cmdname, run.mWord.at(1).mToken);
+}
+
+TEST(cCmdGrammarTest, QuotedArguments) {
+	auto grammar = MakeGrammar();
+	auto run = grammar.Run(Words("msg send alice \"hello there bob\" hi"), false);
+	ASSERT_EQ(tStatus::ok, run.mStatus);
+	ASSERT_EQ(7u, run.mWord.size());
+	EXPECT_EQ(2, run.mWord.at(5).mSub);
+	EXPECT_TRUE(run.mWord.at(5).mJoin);
+	EXPECT_EQ(tToken::variable_ext, run.mWord.at(6).mToken);
+
+	run = grammar.Run(Words("msg send alice \"hello there"), false);
+	EXPECT_EQ(tStatus::syntax, run.mStatus);
+}
+
+TEST(cCmdGrammarTest, NextKindForCompletion) {
+	auto grammar = MakeGrammar();
+	EXPECT_EQ(tToken::cmdname, grammar.Run({}, true).mNext);
+	EXPECT_EQ(0, grammar.Run({}, true).mNextSub);
+
+	auto run = grammar.Run(Words("msg send"), true);
+	EXPECT_EQ(tToken::variable, run.mNext);
+	EXPECT_EQ(1, run.mNextSub);
+	run = grammar.Run(Words("msg send alice bob"), true);
+	EXPECT_EQ(tToken::variable_ext, run.mNext);
+	run = grammar.Run(Words("msg send alice bob hi"), true);
+	EXPECT_EQ(tToken::option_name, run.mNext);
+	run = grammar.Run(Words("msg send alice --cc"), true);
+	EXPECT_EQ(tToken::option_value, run.mNext);
+}
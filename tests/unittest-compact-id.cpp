@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/compact_id.hpp"
+
+#include <chrono>
+#include <thread>
+#include <type_traits>
+
+using namespace nOT::nUtils;
+
+namespace {
+
+string FakeId(size_t i) { // looks like OT ID: "otx" + 33 characters
+	string id = "otx" + ToStr(i);
+	id.resize(36, 'Q');
+	return id;
+}
+
+} // namespace
+
+TEST(cCompactIdTest, InternsEachStringOnce) {
+	static_assert(std::is_trivially_copyable<cCompactId>::value, "cCompactId must be trivially copyable");
+	static_assert(sizeof(cCompactId) == 4, "cCompactId must stay 4 bytes");
+	const cCompactId a = cCompactId::Intern("otxAAA");
+	const cCompactId b = cCompactId::Intern(string("otx") + "AAA");
+	const cCompactId c = cCompactId::Intern("otxBBB");
+	EXPECT_EQ(a, b);
+	EXPECT_NE(a, c);
+	EXPECT_EQ("otxAAA", a.Str());
+	EXPECT_TRUE(cCompactId().IsEmpty());
+	EXPECT_EQ("", cCompactId().Str());
+
+	cCompactId found;
+	EXPECT_TRUE(cCompactId::Lookup("otxBBB", found));
+	EXPECT_EQ(c, found);
+	const size_t size = cCompactId::GetTableSize();
+	EXPECT_FALSE(cCompactId::Lookup("otxNeverInterned", found));
+	EXPECT_EQ(size, cCompactId::GetTableSize()); // lookup does not add
+	cCompactName name;
+	EXPECT_FALSE(cCompactName::Lookup("otxAAA", name)); // tables are separate
+}
+
+TEST(cCompactIdTest, ConcurrentInternAndRead) {
+	const size_t per_thread = 20000;
+	vector<std::thread> threads;
+	vector<vector<cCompactId>> got(4);
+	for (size_t t = 0; t < got.size(); ++t) {
+		threads.emplace_back([t, per_thread, &got] {
+			for (size_t i = 0; i < per_thread; ++i) {
+				const string id = "concurrent-" + ToStr(i % 5000) + "-" + ToStr((i / 5000 + t) % 4);
+				got[t].push_back(cCompactId::Intern(id));
+				if (got[t].back().Str() != id) throw std::runtime_error("wrong string for handle");
+			}
+		});
+	}
+	for (auto & thread : threads) thread.join();
+	for (size_t t = 0; t < got.size(); ++t)
+		for (size_t i = 0; i < per_thread; ++i)
+			EXPECT_EQ("concurrent-" + ToStr(i % 5000) + "-" + ToStr((i / 5000 + t) % 4), got[t][i].Str());
+}
+
+TEST(cIdNameMapTest, SetRenameEraseFind) {
+	cIdNameMap nyms;
+	nyms.Set("otx1", "alice");
+	nyms.Set("otx2", "bob");
+	EXPECT_EQ(2u, nyms.Size());
+	EXPECT_EQ("alice", nyms.NameOf("otx1"));
+	EXPECT_EQ("otx2", nyms.IdOf("bob"));
+	EXPECT_EQ("", nyms.IdOf("carol"));
+	EXPECT_EQ(nullptr, nyms.FindName("otx3"));
+	EXPECT_THROW(nyms.NameOf("otx3"), std::out_of_range);
+
+	nyms.Set("otx2", "bobby"); // rename
+	EXPECT_EQ("", nyms.IdOf("bob"));
+	EXPECT_EQ("otx2", nyms.IdOf("bobby"));
+	EXPECT_EQ((vector<string>{ "alice", "bobby" }), nyms.GetNames());
+
+	EXPECT_TRUE(nyms.Erase("otx1"));
+	EXPECT_FALSE(nyms.Erase("otx1"));
+	EXPECT_FALSE(nyms.Has("otx1"));
+	EXPECT_EQ("", nyms.IdOf("alice"));
+	EXPECT_EQ((map<string, string>{ { "otx2", "bobby" } }), nyms.ToMap());
+
+	nyms.Set("otx9", "twin"); // same name: always the first ID, as in a scan of ID -> name map
+	nyms.Set("otx3", "twin");
+	nyms.Set("otx7", "twin");
+	EXPECT_EQ("otx3", nyms.IdOf("twin"));
+	EXPECT_TRUE(nyms.Erase("otx3"));
+	EXPECT_EQ("otx7", nyms.IdOf("twin"));
+
+	nyms.FromMap({ { "otx5", "eve" }, { "otx4", "dave" } });
+	EXPECT_EQ((vector<string>{ "otx4", "otx5" }), nyms.GetIds());
+	nyms.Clear();
+	EXPECT_TRUE(nyms.Empty());
+}
+
+// Benchmark: finding ID by name in 100k nyms, map<string,string> scan (as before) vs cIdNameMap index
+TEST(cIdNameMapTest, BenchmarkFindByName) {
+	const size_t count = 100000, lookups = 200;
+	map<string, string> plain;
+	cIdNameMap compact;
+	for (size_t i = 0; i < count; ++i) {
+		plain[FakeId(i)] = "nym-" + ToStr(i);
+		compact.Set(FakeId(i), "nym-" + ToStr(i));
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t found_plain = 0;
+	for (size_t n = 0; n < lookups; ++n) found_plain += !FindMapValue(plain, "nym-" + ToStr(n * 487 % count)).empty();
+	const double ms_plain = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	size_t found_compact = 0;
+	for (size_t n = 0; n < lookups; ++n) found_compact += (compact.IdOf("nym-" + ToStr(n * 487 % count)) == FakeId(n * 487 % count));
+	const double ms_compact = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	EXPECT_EQ(lookups, found_plain);
+	EXPECT_EQ(lookups, found_compact);
+	cout << "nyms=" << count << " lookups=" << lookups << " map-scan=" << ms_plain << "ms compact-index=" << ms_compact << "ms" << endl;
+}
@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/completion_cache.hpp"
+
+using namespace nOT::nOTHint;
+
+TEST(cCompletionCacheTest, IsRefinement) {
+	EXPECT_TRUE(cCompletionCache::IsRefinement("ot msg send al", "ot msg send ali"));
+	EXPECT_TRUE(cCompletionCache::IsRefinement("ot msg send ", "ot msg send al"));
+	EXPECT_TRUE(cCompletionCache::IsRefinement("ot msg send al", "ot msg send al"));
+	EXPECT_FALSE(cCompletionCache::IsRefinement("ot msg send al", "ot msg send al ")); // next word
+	EXPECT_FALSE(cCompletionCache::IsRefinement("ot msg send al", "ot msg send a")); // shorter
+	EXPECT_FALSE(cCompletionCache::IsRefinement("ot msg send al", "ot msg send al\\ ")); // escaped
+	EXPECT_FALSE(cCompletionCache::IsRefinement("ot msg send al", "ot nym ls"));
+}
+
+TEST(cCompletionCacheTest, NarrowsRememberedCandidates) {
+	cCompletionCache cache;
+	vector<string> completions;
+	EXPECT_FALSE(cache.Narrow("ot msg send al", 1, completions));
+	cache.Remember("ot msg send ", 1, { "alice", "alfred", "bob", "--dryrun" });
+
+	ASSERT_TRUE(cache.Narrow("ot msg send al", 1, completions));
+	EXPECT_EQ((vector<string>{ "alice", "alfred" }), completions);
+	ASSERT_TRUE(cache.Narrow("ot msg send ali", 1, completions)); // from the narrowed entry
+	EXPECT_EQ((vector<string>{ "alice" }), completions);
+	ASSERT_TRUE(cache.Narrow("ot msg send x", 1, completions));
+	EXPECT_TRUE(completions.empty());
+	EXPECT_EQ(3u, cache.GetHits());
+}
+
+TEST(cCompletionCacheTest, NewGenerationOrWordIsComputedAgain) {
+	cCompletionCache cache;
+	vector<string> completions;
+	cache.Remember("ot msg send ", 1, { "alice" });
+	EXPECT_FALSE(cache.Narrow("ot msg send al", 2, completions)); // wallet changed
+	EXPECT_FALSE(cache.Narrow("ot msg send alice ", 1, completions)); // next argument
+}
+
+TEST(cCompletionCacheTest, KeepsOnlyCapacity) {
+	cCompletionCache cache(2);
+	vector<string> completions;
+	cache.Remember("ot a", 1, { "a1" });
+	cache.Remember("ot b", 1, { "b1" });
+	cache.Remember("ot c", 1, { "c1" });
+	EXPECT_FALSE(cache.Narrow("ot a1", 1, completions));
+	EXPECT_TRUE(cache.Narrow("ot c1", 1, completions));
+}
@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/fan_out.hpp"
+
+#include <atomic>
+#include <thread>
+
+using namespace nOT::nUtils;
+
+namespace {
+
+vector<string> Targets(size_t count) {
+	vector<string> targets;
+	for (size_t i = 0; i < count; ++i) targets.push_back("nym" + ToStr(i));
+	return targets;
+}
+
+} // namespace
+
+TEST(cFanOutTest, KeepsTargetOrderAndDoesNotStopOnFailure) {
+	cFanOut fanOut(4, 0);
+	auto statuses = fanOut.Run(Targets(20), [] (const string & target) {
+		return (target == "nym3") ? cFanOut::eResult::failed : cFanOut::eResult::ok;
+	} );
+	ASSERT_EQ(20u, statuses.size());
+	for (size_t i = 0; i < statuses.size(); ++i) EXPECT_EQ("nym" + ToStr(i), statuses[i].mTarget);
+	EXPECT_EQ(cFanOut::eResult::failed, statuses[3].mResult);
+	EXPECT_EQ(19u, cFanOut::CountOk(statuses));
+}
+
+TEST(cFanOutTest, RetriesOnlyTransientFailures) {
+	std::atomic<int> calls(0);
+	cFanOut fanOut(1, 2, std::chrono::milliseconds(1));
+	auto statuses = fanOut.Run({ "flaky", "down", "rejects" }, [&calls] (const string & target) -> cFanOut::eResult {
+		++calls;
+		if (target == "flaky") return (calls == 1) ? cFanOut::eResult::transient : cFanOut::eResult::ok;
+		if (target == "down") return cFanOut::eResult::transient;
+		return cFanOut::eResult::failed;
+	} );
+	EXPECT_EQ(cFanOut::eResult::ok, statuses[0].mResult);
+	EXPECT_EQ(2u, statuses[0].mAttempts);
+	EXPECT_EQ(cFanOut::eResult::transient, statuses[1].mResult);
+	EXPECT_EQ(3u, statuses[1].mAttempts); // first try + 2 retries
+	EXPECT_EQ(1u, statuses[2].mAttempts);
+}
+
+TEST(cFanOutTest, BoundsSendsInFlight) {
+	std::atomic<int> now(0), most(0);
+	cFanOut fanOut(3, 0);
+	fanOut.Run(Targets(30), [&] (const string &) {
+		int current = ++now;
+		int seen = most;
+		while (current > seen && !most.compare_exchange_weak(seen, current)) { }
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		--now;
+		return cFanOut::eResult::ok;
+	} );
+	EXPECT_LE(most, 3);
+	EXPECT_GE(most, 2); // really concurrent
+}
+
+TEST(cFanOutTest, ReachabilityIsCheckedOnlyAfterLostReply) {
+	int checks = 0;
+	cFanOut::cReachable server( [&checks] () { ++checks; return (checks == 1) || (checks >= 5); } ); // down for checks 2..4
+	EXPECT_EQ(1, checks); // once, before the fan-out
+	cFanOut fanOut(1, 2, std::chrono::milliseconds(1));
+	auto statuses = fanOut.Run(Targets(5), [&server] (const string & target) -> cFanOut::eResult {
+		if (!server.BeforeSend()) return cFanOut::eResult::transient;
+		if (target == "nym1") { server.ReplyLost(); return cFanOut::eResult::failed; }
+		return cFanOut::eResult::ok;
+	} );
+	EXPECT_EQ(1u, statuses[0].mAttempts);
+	EXPECT_EQ(cFanOut::eResult::failed, statuses[1].mResult); // no reply: not sent again
+	EXPECT_EQ(1u, statuses[1].mAttempts);
+	EXPECT_EQ(cFanOut::eResult::transient, statuses[2].mResult); // not sent: retried, but server is still down
+	EXPECT_EQ(3u, statuses[2].mAttempts);
+	EXPECT_EQ(cFanOut::eResult::ok, statuses[3].mResult);
+	EXPECT_EQ(cFanOut::eResult::ok, statuses[4].mResult);
+	EXPECT_EQ(5, checks); // no check for sends while the server is known to answer
+}
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/file_batch.hpp"
+
+#include <cstdlib>
+
+using namespace nOT::nUse;
+
+namespace {
+
+string MakeDir() {
+	char tmpl[] = "/tmp/otcli-batch-XXXXXX";
+	return mkdtemp(tmpl);
+}
+
+} // namespace
+
+TEST(cFileBatchTest, FindsMatchingFilesSorted) {
+	const string dir = MakeDir();
+	for (auto name : { "b.otc", "a.otc", "notes.txt", ".hidden.otc" }) std::ofstream(dir + "/" + name) << "contract " << name;
+	cFileBatch batch;
+	ASSERT_TRUE(batch.Find(dir, "*.otc"));
+	EXPECT_EQ((vector<string>{ dir + "/a.otc", dir + "/b.otc" }), batch.GetFiles());
+	EXPECT_FALSE(batch.Find(dir, "*.xml"));
+	EXPECT_EQ(0, system(("rm -rf " + dir).c_str()));
+}
+
+TEST(cFileBatchTest, RunWritesOutputsAndReportsFailures) {
+	const string dir = MakeDir();
+	const string outDir = MakeDir();
+	for (int i = 0; i < 20; ++i) std::ofstream(dir + "/c" + ToStr(i) + ".otc") << "contract " << i;
+	std::ofstream(dir + "/bad.otc") << "bad";
+
+	cFileBatch batch;
+	ASSERT_TRUE(batch.Find(dir, "*.otc"));
+	auto results = batch.Run([] (const string & content, string & output, string & detail) -> bool {
+		if (content == "bad") { detail = "refused"; return false; }
+		output = "signed: " + content;
+		return true;
+	}, true, outDir, 4);
+
+	ASSERT_EQ(21u, results.size());
+	EXPECT_FALSE(results.at(0).mOk); // bad.otc sorts first
+	EXPECT_EQ("refused", results.at(0).mDetail);
+	EXPECT_EQ("signed: contract 7", nOT::nUtils::cEnvUtils().ReadFromFile(outDir + "/c7.otc"));
+	EXPECT_EQ("contract 7", nOT::nUtils::cEnvUtils().ReadFromFile(dir + "/c7.otc")); // input untouched
+	EXPECT_FALSE(std::ifstream(outDir + "/bad.otc").good());
+
+	std::ostringstream report;
+	cFileBatch::PrintReport(report, results, 0.5, "Signed");
+	EXPECT_NE(string::npos, report.str().find("20 of 21 files"));
+	EXPECT_NE(string::npos, report.str().find("files/s"));
+	EXPECT_EQ(0, system(("rm -rf " + dir + " " + outDir).c_str()));
+}
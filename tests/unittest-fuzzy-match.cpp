@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/fuzzy_match.hpp"
+
+#include <chrono>
+#include <random>
+
+using namespace nOT::nUtils;
+
+namespace {
+
+// plain DP: min over prefixes of text of edit distance to pattern
+int NaivePrefixDistance(const string & pattern, const string & text) {
+	vector<int> prev(text.size()+1), curr(text.size()+1);
+	for (size_t j=0; j<=text.size(); ++j) prev[j] = j;
+	for (size_t i=1; i<=pattern.size(); ++i) {
+		curr[0] = i;
+		for (size_t j=1; j<=text.size(); ++j)
+			curr[j] = std::min({ prev[j]+1, curr[j-1]+1, prev[j-1] + (pattern[i-1] != text[j-1]) });
+		std::swap(prev, curr);
+	}
+	return *std::min_element(prev.begin(), prev.end());
+}
+
+string RandomWord(std::mt19937 & rng, size_t minLen, size_t maxLen, const string & alphabet) {
+	string word(std::uniform_int_distribution<size_t>(minLen, maxLen)(rng), ' ');
+	for (auto & c : word) c = alphabet[ std::uniform_int_distribution<size_t>(0, alphabet.size()-1)(rng) ];
+	return word;
+}
+
+} // namespace
+
+TEST(cFuzzyMatcherTest, EqualsNaiveDistance) {
+	std::mt19937 rng(42);
+	for (int round = 0; round < 2000; ++round) {
+		const string pattern = RandomWord(rng, 1, 12, "abc");
+		const string text = RandomWord(rng, 0, 16, "abc");
+		const int naive = NaivePrefixDistance(pattern, text);
+		const cFuzzyMatcher matcher(pattern, 3);
+		EXPECT_EQ(naive <= 3 ? naive : -1, matcher.PrefixDistance(text)) << pattern << " " << text;
+	}
+}
+
+TEST(cFuzzyMatcherTest, RanksExactPrefixFirst) {
+	const vector<string> names = { "bob", "alixe_savings", "alice", "alice_savings", "xavier", "lice" };
+	EXPECT_EQ((vector<string>{ "alice", "alice_savings", "alixe_savings", "lice" }), WordsThatMatchFuzzy("alice", names));
+	EXPECT_EQ((vector<string>{ "bob" }), WordsThatMatchFuzzy("bo", names)); // short word: no typos allowed
+	EXPECT_EQ(names.size(), WordsThatMatchFuzzy("", names).size());
+}
+
+// Benchmark: 100k candidates must be ranked within TAB latency budget (5 ms, optimized build)
+TEST(cFuzzyMatcherTest, Benchmark100kCandidates) {
+	std::mt19937 rng(7);
+	vector<string> names;
+	for (int i = 0; i < 100000; ++i) names.push_back( RandomWord(rng, 6, 32, "abcdefghijklmnopqrstuvwxyz_0123456789") );
+	names[500] = "operations_account_eur";
+
+	auto start = std::chrono::steady_clock::now();
+	auto found = WordsThatMatchFuzzy("operatoins_acc", names);
+	const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	ASSERT_FALSE(found.empty());
+	EXPECT_EQ("operations_account_eur", found.at(0));
+	cout << "fuzzy candidates=" << names.size() << " found=" << found.size() << " time=" << ms << "ms" << endl;
+	#ifdef NDEBUG
+		EXPECT_LT(ms, 5.0);
+	#endif
+}
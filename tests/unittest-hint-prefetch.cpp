@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/hint_prefetch.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace nOT::nOTHint;
+
+namespace {
+
+// Stands in for the parser and cUseOT: completes a line to line + "1"/"2"; "hold" waits until released
+struct cFakeUse {
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	vector<string> mComputed;
+	int mWarmed = 0, mReplenished = 0;
+	bool mHeld = false, mReleased = false;
+
+	cHintPrefetcher::tCompute Compute() {
+		return [this] (const string & line, bool & filenames) -> vector<string> {
+			std::unique_lock<std::mutex> lock(mMutex);
+			mComputed.push_back(line);
+			if (line == "hold") {
+				mHeld = true;
+				mCond.notify_all();
+				mCond.wait(lock, [this]() { return mReleased; } );
+			}
+			filenames = (line == "file ");
+			return { line + "1", line + "2" };
+		};
+	}
+	cHintPrefetcher::tWork Warm() { return [this] () { std::lock_guard<std::mutex> lock(mMutex); ++mWarmed; }; }
+	cHintPrefetcher::tWork Replenish() { return [this] () { std::lock_guard<std::mutex> lock(mMutex); ++mReplenished; }; }
+
+	void WaitHeld() { std::unique_lock<std::mutex> lock(mMutex); mCond.wait(lock, [this]() { return mHeld; } ); }
+	void Release() { { std::lock_guard<std::mutex> lock(mMutex); mReleased = true; } mCond.notify_all(); }
+	int Replenished() { std::lock_guard<std::mutex> lock(mMutex); return mReplenished; }
+	int Warmed() { std::lock_guard<std::mutex> lock(mMutex); return mWarmed; }
+	bool Computed(const string & line) { std::lock_guard<std::mutex> lock(mMutex); return std::count(mComputed.begin(), mComputed.end(), line) > 0; }
+};
+
+// the worker stores the answer a moment after computing it
+bool WaitReady(cHintPrefetcher & prefetcher, const string & line, vector<string> & completions) {
+	for (int i = 0; i < 2000; ++i) {
+		if (prefetcher.TryGet(line, completions)) return true;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return false;
+}
+
+template <typename F> bool WaitFor(F condition) {
+	for (int i = 0; (i < 2000) && !condition(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	return condition();
+}
+
+} // namespace
+
+TEST(cHintPrefetcherTest, ServesPredictionOnlyForTheSameLine) {
+	cFakeUse use;
+	cHintPrefetcher prefetcher(use.Compute(), use.Warm(), use.Replenish());
+	prefetcher.Predict("nym ");
+	vector<string> completions;
+	ASSERT_TRUE(WaitReady(prefetcher, "nym ", completions));
+	EXPECT_EQ((vector<string>{ "nym 1", "nym 2" }), completions);
+
+	completions.clear();
+	EXPECT_FALSE(prefetcher.TryGet("nym", completions));
+	EXPECT_FALSE(prefetcher.TryGet("nym  ", completions));
+	EXPECT_FALSE(prefetcher.TryGet("nym x", completions));
+	EXPECT_TRUE(completions.empty());
+	EXPECT_EQ(1, use.Warmed());
+}
+
+TEST(cHintPrefetcherTest, InvalidateDropsReadyAnswersAndRewarms) {
+	cFakeUse use;
+	cHintPrefetcher prefetcher(use.Compute(), use.Warm(), use.Replenish());
+	prefetcher.Predict("nym ");
+	vector<string> completions;
+	ASSERT_TRUE(WaitReady(prefetcher, "nym ", completions));
+	EXPECT_EQ(0, use.Replenished()); // only after a command
+
+	prefetcher.Invalidate();
+	EXPECT_FALSE(prefetcher.TryGet("nym ", completions));
+	EXPECT_TRUE(WaitFor([&use]() { return use.Replenished() == 1; } ));
+	EXPECT_EQ(2, use.Warmed());
+
+	prefetcher.Predict("nym ");
+	ASSERT_TRUE(WaitReady(prefetcher, "nym ", completions)); // computed again, from the new data
+	EXPECT_EQ((vector<string>{ "nym ", "nym " }), use.mComputed);
+}
+
+TEST(cHintPrefetcherTest, AnswerComputedAcrossInvalidateIsNotKept) {
+	cFakeUse use;
+	cHintPrefetcher prefetcher(use.Compute(), use.Warm(), use.Replenish());
+	prefetcher.Predict("hold");
+	use.WaitHeld();
+	prefetcher.Invalidate();
+	use.Release();
+
+	prefetcher.Predict("after"); // worker handles lines in order, so "hold" is done when this is ready
+	vector<string> completions;
+	ASSERT_TRUE(WaitReady(prefetcher, "after", completions));
+	EXPECT_FALSE(prefetcher.TryGet("hold", completions));
+}
+
+TEST(cHintPrefetcherTest, PredictsNextSlotOnlyForSingleAnswer) {
+	cFakeUse use;
+	cHintPrefetcher prefetcher(use.Compute(), use.Warm(), use.Replenish());
+	vector<string> completions;
+	prefetcher.PredictAfter("account new al", { "alice" });
+	ASSERT_TRUE(WaitReady(prefetcher, "account new alice ", completions));
+	EXPECT_EQ((vector<string>{ "account new alice 1", "account new alice 2" }), completions);
+
+	prefetcher.PredictAfter("account new b", { "bob", "bill" }); // user still has to choose
+	prefetcher.Predict("file "); // needs readline's filename completion, left to the TAB handler
+	ASSERT_TRUE(WaitFor([&use]() { return use.Computed("file "); } ));
+	prefetcher.Predict("last"); // worker handles one line at a time, so "file " is done when this is ready
+	ASSERT_TRUE(WaitReady(prefetcher, "last", completions));
+	EXPECT_FALSE(prefetcher.TryGet("account new bob ", completions));
+	EXPECT_FALSE(prefetcher.TryGet("file ", completions));
+}
@@ -0,0 +1,68 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/instrument_cache.hpp"
+
+using namespace nOT::nUse;
+
+namespace {
+
+string FakeMint(int series, long expiration) {
+	return "-----BEGIN SIGNED MINT-----\nHash: SHA256\n\n"
+		"<mint version=\"2.0\"\n notaryID=\"srv\"\n instrumentDefinitionID=\"asset\"\n series=\"" + std::to_string(series)
+		+ "\"\n expiration=\"" + std::to_string(expiration) + "\"\n validFrom=\"1000\"\n validTo=\"9000\">\n</mint>\n"
+		"-----BEGIN MINT SIGNATURE-----\nabc\n-----END MINT SIGNATURE-----\n";
+}
+
+} // namespace
+
+TEST(cInstrumentCacheTest, ReadsMintValidity) {
+	int64_t series = -1;
+	std::time_t expiration = 0;
+	ASSERT_TRUE(cInstrumentCache::ReadMintValidity(FakeMint(3, 5000), series, expiration));
+	EXPECT_EQ(3, series);
+	EXPECT_EQ(5000, expiration);
+	EXPECT_FALSE(cInstrumentCache::ReadMintValidity("not a mint", series, expiration));
+	EXPECT_FALSE(cInstrumentCache::ReadMintValidity("<mint series=\"1\">", series, expiration));
+}
+
+TEST(cInstrumentCacheTest, MintServedUntilExpiration) {
+	cInstrumentCache cache;
+	string mint;
+	EXPECT_FALSE(cache.GetMint("srv", "asset", mint, 100));
+	cache.PutMint("srv", "asset", FakeMint(1, 5000));
+	ASSERT_TRUE(cache.GetMint("srv", "asset", mint, 4999));
+	EXPECT_EQ(FakeMint(1, 5000), mint);
+	EXPECT_FALSE(cache.GetMint("other-srv", "asset", mint, 100));
+	EXPECT_FALSE(cache.GetMint("srv", "asset", mint, 5000)); // expired - dropped
+	EXPECT_FALSE(cache.GetMint("srv", "asset", mint, 100));
+}
+
+TEST(cInstrumentCacheTest, NewSeriesReplacesOld) {
+	cInstrumentCache cache;
+	string mint;
+	cache.PutMint("srv", "asset", FakeMint(1, 5000));
+	cache.PutMint("srv", "asset", FakeMint(2, 8000));
+	ASSERT_TRUE(cache.GetMint("srv", "asset", mint, 6000));
+	EXPECT_EQ(FakeMint(2, 8000), mint);
+}
+
+TEST(cInstrumentCacheTest, UnreadableMintNotCached) {
+	cInstrumentCache cache;
+	string mint;
+	cache.PutMint("srv", "asset", "garbage");
+	EXPECT_FALSE(cache.GetMint("srv", "asset", mint, 100));
+}
+
+TEST(cInstrumentCacheTest, ContractsKeptUntilCleared) {
+	cInstrumentCache cache;
+	string contract;
+	cache.PutContract("asset", "");
+	EXPECT_FALSE(cache.GetContract("asset", contract));
+	cache.PutContract("asset", "<contract/>");
+	cache.PutContract("asset2", "<contract/>"); // same content stored once
+	ASSERT_TRUE(cache.GetContract("asset", contract));
+	EXPECT_EQ("<contract/>", contract);
+	cache.ClearContracts();
+	EXPECT_FALSE(cache.GetContract("asset2", contract));
+}
@@ -0,0 +1,44 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common1.hpp"
+#include "../src/base/latency_histogram.hpp"
+
+using namespace nOT::nUtils;
+
+TEST(cLatencyHistogramTest, SmallValuesAreExact) {
+	cLatencyHistogram histogram;
+	for (uint64_t us = 1; us <= 10; ++us) histogram.Record(us);
+	EXPECT_EQ(10u, histogram.GetCount());
+	EXPECT_EQ(1u, histogram.GetMin());
+	EXPECT_EQ(10u, histogram.GetMax());
+	EXPECT_EQ(5u, histogram.Percentile(50));
+	EXPECT_EQ(10u, histogram.Percentile(99));
+	EXPECT_DOUBLE_EQ(5.5, histogram.GetMean());
+}
+
+TEST(cLatencyHistogramTest, PercentilesWithinPrecision) {
+	cLatencyHistogram histogram;
+	for (uint64_t ms = 1; ms <= 1000; ++ms) histogram.Record(ms * 1000); // 1 ms .. 1 s
+	for (double percent : { 50.0, 90.0, 99.0 }) {
+		const double expected = percent * 10 * 1000;
+		const double got = histogram.Percentile(percent);
+		EXPECT_GE(got, expected);
+		EXPECT_LE(got, expected * 1.07) << "p" << percent;
+	}
+	EXPECT_EQ(1000000u, histogram.Percentile(100));
+	EXPECT_EQ(1000000u, histogram.GetMax());
+}
+
+TEST(cLatencyHistogramTest, AddMergesAndClearResets) {
+	cLatencyHistogram a, b;
+	a.Record(100); b.Record(5000000); b.Record(7);
+	a.Add(b);
+	EXPECT_EQ(3u, a.GetCount());
+	EXPECT_EQ(7u, a.GetMin());
+	EXPECT_EQ(5000000u, a.GetMax());
+	a.Clear();
+	EXPECT_EQ(0u, a.GetCount());
+	EXPECT_EQ(0u, a.Percentile(50));
+	a.Record(UINT64_MAX); // does not overflow the buckets
+	EXPECT_EQ(UINT64_MAX, a.Percentile(50));
+}
@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/ledger_mirror.hpp"
+
+#include <cstdio>
+
+using namespace nOT::nUse;
+
+namespace {
+
+const string gFile = "unittest-ledger-mirror";
+
+vector<string> ReadLines(const string & name) {
+	std::ifstream in(name);
+	vector<string> lines;
+	string line;
+	while (std::getline(in, line)) lines.push_back(line);
+	return lines;
+}
+
+// walks a box like the ls commands do: every transaction is looked up, missing ones are "decoded" (counted)
+size_t Walk(const vector<std::pair<int64_t, string>> & box) {
+	cLedgerMirror mirror(gFile, 1);
+	for (const auto & transaction : box) {
+		const string key = cLedgerMirror::Key(transaction.first, transaction.second);
+		cLedgerMirror::tRow row;
+		if (!mirror.Get(key, row)) mirror.Put(key, cLedgerMirror::tRow{ "decoded " + transaction.second });
+		else EXPECT_EQ("decoded " + transaction.second, row.at(0));
+	}
+	mirror.Save();
+	return mirror.GetMisses();
+}
+
+class cLedgerMirrorTest : public ::testing::Test {
+	protected:
+		void SetUp() override { std::remove(gFile.c_str()); }
+		void TearDown() override { std::remove(gFile.c_str()); }
+};
+
+} // namespace
+
+TEST_F(cLedgerMirrorTest, AddedRowsAreAppended) {
+	EXPECT_EQ(2u, Walk({ {1, "pay alice"}, {2, "pay bob"} }));
+	EXPECT_EQ(3u, ReadLines(gFile).size()); // header and 2 rows
+
+	EXPECT_EQ(1u, Walk({ {1, "pay alice"}, {2, "pay bob"}, {3, "pay carol"} })); // only the new one is decoded
+	const auto lines = ReadLines(gFile);
+	ASSERT_EQ(4u, lines.size());
+	EXPECT_TRUE(nOT::nUtils::CheckIfBegins("3:", lines.at(3))); // appended, not rewritten
+
+	EXPECT_EQ(0u, Walk({ {1, "pay alice"}, {2, "pay bob"}, {3, "pay carol"} }));
+	EXPECT_EQ(4u, ReadLines(gFile).size()); // nothing new: file not touched
+}
+
+TEST_F(cLedgerMirrorTest, RemovedRowsAreDroppedFromFile) {
+	Walk({ {1, "pay alice"}, {2, "pay bob"}, {3, "pay carol"} });
+	EXPECT_EQ(0u, Walk({ {1, "pay alice"}, {3, "pay carol"} }));
+	const auto lines = ReadLines(gFile);
+	ASSERT_EQ(3u, lines.size());
+	for (const auto & line : lines) EXPECT_EQ(string::npos, line.find("bob"));
+
+	EXPECT_EQ(1u, Walk({ {1, "pay alice"}, {2, "pay bob"}, {3, "pay carol"} })); // it comes back: decoded again
+}
+
+TEST_F(cLedgerMirrorTest, ReorderedAndChangedRows) {
+	Walk({ {1, "pay alice"}, {2, "pay bob"}, {3, "pay carol"} });
+	EXPECT_EQ(0u, Walk({ {3, "pay carol"}, {1, "pay alice"}, {2, "pay bob"} })); // other order: all from mirror
+	EXPECT_EQ(3u, ReadLines(gFile).size() - 1);
+
+	EXPECT_EQ(1u, Walk({ {3, "pay carol"}, {1, "pay alice"}, {2, "pay bob 2"} })); // changed contents, same number
+	const auto lines = ReadLines(gFile);
+	ASSERT_EQ(4u, lines.size()); // old version of 2 is gone
+	EXPECT_EQ(1, std::count_if(lines.begin(), lines.end(), [] (const string & line) { return nOT::nUtils::CheckIfBegins("2:", line); }));
+}
+
+TEST_F(cLedgerMirrorTest, FieldsWithTabsAndNewlines) {
+	const cLedgerMirror::tRow row{ "a\tb", "line1\nline2", "back\\slash", "" };
+	{
+		cLedgerMirror mirror(gFile, 4);
+		mirror.Put(cLedgerMirror::Key(7, "x"), row);
+		mirror.Save();
+	}
+	EXPECT_EQ(2u, ReadLines(gFile).size());
+	cLedgerMirror mirror(gFile, 4);
+	cLedgerMirror::tRow loaded;
+	ASSERT_TRUE(mirror.Get(cLedgerMirror::Key(7, "x"), loaded));
+	EXPECT_EQ(row, loaded);
+}
+
+TEST_F(cLedgerMirrorTest, IdenticalContentsAreCountedNotIndexed) { // outpayments: number of the occurrence of same contents
+	EXPECT_NE(cLedgerMirror::Key(0, "cheque"), cLedgerMirror::Key(1, "cheque"));
+	EXPECT_EQ(cLedgerMirror::Key(0, "cheque"), cLedgerMirror::Key(0, "cheque"));
+	EXPECT_EQ(4u, Walk({ {0, "cheque a"}, {0, "cheque b"}, {1, "cheque b"}, {0, "cheque c"} }));
+	EXPECT_EQ(5u, ReadLines(gFile).size());
+	EXPECT_EQ(0u, Walk({ {0, "cheque b"}, {1, "cheque b"}, {0, "cheque c"} })); // 1st removed: the others are not decoded again
+}
+
+TEST_F(cLedgerMirrorTest, FileOfUnknownFormatIsRewritten) {
+	{
+		std::ofstream out(gFile);
+		out << "ot-ledger-mirror 0\n1:abc\told\n";
+	}
+	EXPECT_EQ(1u, Walk({ {1, "pay alice"} }));
+	auto lines = ReadLines(gFile);
+	ASSERT_EQ(2u, lines.size());
+	EXPECT_EQ("ot-ledger-mirror 1", lines.at(0));
+	EXPECT_EQ(0u, Walk({ {1, "pay alice"} })); // reused from now on
+	EXPECT_EQ(2u, ReadLines(gFile).size());
+}
+
+TEST_F(cLedgerMirrorTest, RowsWithWrongFieldCountAreDropped) {
+	Walk({ {1, "pay alice"}, {2, "pay bob"} });
+	{
+		std::ofstream out(gFile, std::ios::app);
+		out << "3:abc\n"; // cut while appending: no fields
+		out << "4:def\tone\ttwo\n";
+	}
+	EXPECT_EQ(0u, Walk({ {1, "pay alice"}, {2, "pay bob"} }));
+	EXPECT_EQ(3u, ReadLines(gFile).size()); // and the file is cleaned
+}
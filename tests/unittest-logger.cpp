@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+
+using namespace nOT::nUtils;
+
+namespace {
+
+struct cTestLogger : public cLogger {
+	void MainOff() { mStream = &g_nullstream; UpdateLevelFloor(); } // as setOutStreamFromGlobalOptions without +debug
+};
+
+} // namespace
+
+TEST(cLoggerTest, LevelsPerChannel) {
+	cTestLogger logger;
+	logger.setDebugLevel(70);
+	EXPECT_FALSE(logger.enabled(50));
+	EXPECT_TRUE(logger.enabled(90));
+	logger.setChannelLevel("net", 20);
+	EXPECT_TRUE(logger.enabled(30, "net"));
+	EXPECT_TRUE(logger.enabled(30, "net/send")); // sub-channel
+	EXPECT_FALSE(logger.enabled(30, "network"));
+	EXPECT_FALSE(logger.enabled(30));
+}
+
+TEST(cLoggerTest, ChannelFilesStayWhenDebugIsOff) {
+	cTestLogger logger;
+	logger.setDebugLevel(50);
+	logger.MainOff();
+	EXPECT_FALSE(logger.enabled(100)); // main output goes nowhere: not even formatted
+	EXPECT_TRUE(logger.enabled(50, "net")); // but channel files are written at the level
+	EXPECT_FALSE(logger.enabled(40, "net"));
+	logger.setChannelLevel("net", 20);
+	EXPECT_TRUE(logger.enabled(20, "net"));
+	EXPECT_FALSE(logger.enabled(20));
+}
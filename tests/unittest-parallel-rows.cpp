@@ -0,0 +1,59 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/parallel_rows.hpp"
+
+#include <chrono>
+
+using namespace nOT::nUtils;
+
+namespace {
+
+// CPU bound work similar in cost to decoding one transaction (parsing few kB of armored text)
+string FakeDecode(size_t i) {
+	string text(4096, 'a' + (i % 26));
+	uint64_t hash = 14695981039346656037ULL;
+	for (int round = 0; round < 8; ++round)
+		for (unsigned char c : text) { hash ^= c; hash *= 1099511628211ULL; }
+	return ToStr(i) + ":" + ToStr(hash);
+}
+
+double MeasureMs(size_t count, size_t threads, vector<string> & result) {
+	auto start = std::chrono::steady_clock::now();
+	result = DecodeRowsParallel<string>(count, FakeDecode, threads);
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+} // namespace
+
+TEST(cParallelRowsTest, KeepsIndexOrder) {
+	const size_t count = 1000;
+	auto rows = DecodeRowsParallel<size_t>(count, [] (size_t i) -> size_t { return i * 3; }, 4);
+	ASSERT_EQ(count, rows.size());
+	for (size_t i = 0; i < count; ++i) EXPECT_EQ(i * 3, rows[i]);
+}
+
+TEST(cParallelRowsTest, RethrowsDecodeError) {
+	auto decode = [] (size_t i) -> int { if (i == 77) throw std::runtime_error("bad row"); return 0; };
+	EXPECT_THROW(DecodeRowsParallel<int>(200, decode, 4), std::runtime_error);
+}
+
+TEST(cParallelRowsTest, EmptyAndSmallInput) {
+	EXPECT_EQ(0u, DecodeRowsParallel<int>(0, [] (size_t) -> int { return 1; }).size());
+	EXPECT_EQ(3u, DecodeRowsParallel<int>(3, [] (size_t) -> int { return 1; }).size());
+}
+
+// Benchmark: prints speedup for growing row count; fails unless parallel results are the same as sequential ones
+TEST(cParallelRowsTest, BenchmarkRowScaling) {
+	const size_t threads = std::max(4u, std::thread::hardware_concurrency()); // more threads than cores still must give the same rows
+	for (size_t count : { 256, 1024, 4096 }) {
+		vector<string> sequential, parallel;
+		const double ms1 = MeasureMs(count, 1, sequential);
+		const double msN = MeasureMs(count, threads, parallel);
+		ASSERT_EQ(count, sequential.size());
+		ASSERT_EQ(sequential, parallel) << "rows=" << count;
+		cout << "rows=" << count << " threads=" << threads
+			<< " sequential=" << ms1 << "ms parallel=" << msN << "ms speedup=" << (ms1 / std::max(msN, 0.001)) << endl;
+	}
+}
@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/payment_batch.hpp"
+
+using namespace nOT::nUse;
+
+namespace {
+
+string WriteFile(const string & name, const string & text) {
+	std::ofstream out(name, std::ios::trunc);
+	out << text;
+	return name;
+}
+
+string ReadFile(const string & name) {
+	std::ifstream in(name);
+	return string( (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>() );
+}
+
+} // namespace
+
+TEST(cPaymentBatchTest, SplitsQuotedFields) {
+	EXPECT_EQ((vector<string>{ "alice", "10", "" }), cPaymentBatch::SplitCsvLine("alice,10,"));
+	EXPECT_EQ((vector<string>{ "bob", "20", "rent, may" }), cPaymentBatch::SplitCsvLine("bob,20,\"rent, may\""));
+	EXPECT_EQ((vector<string>{ "carol", "5", "say \"hi\"" }), cPaymentBatch::SplitCsvLine("carol,5,\"say \"\"hi\"\"\""));
+	EXPECT_EQ((vector<string>{ "dave", "7" }), cPaymentBatch::SplitCsvLine(" dave , 7 \r")); // trimmed, CRLF files
+	EXPECT_EQ("\"a, \"\"b\"\"\"", cPaymentBatch::CsvField("a, \"b\""));
+	EXPECT_EQ("plain", cPaymentBatch::CsvField("plain"));
+}
+
+TEST(cPaymentBatchTest, LoadSkipsHeaderBlankAndCommentLines) {
+	const string csv = WriteFile("unittest-batch.csv",
+		"recipient,amount,memo\n"
+		"alice,10,salary\n"
+		"\n"
+		"   \n"
+		"# bonus below\n"
+		"\"bob, jr\",25,\"bonus, Q1\"\n");
+	cPaymentBatch batch;
+	ASSERT_TRUE(batch.Load(csv));
+	ASSERT_EQ(2u, batch.GetItems().size());
+	EXPECT_EQ(2u, batch.GetItems().at(0).mLine);
+	EXPECT_EQ("alice", batch.GetItems().at(0).mRecipient);
+	EXPECT_EQ(6u, batch.GetItems().at(1).mLine); // line numbers count the skipped lines too
+	EXPECT_EQ("bob, jr", batch.GetItems().at(1).mRecipient);
+	EXPECT_EQ("bonus, Q1", batch.GetItems().at(1).mMemo);
+	EXPECT_EQ(35, batch.GetTotal());
+	std::remove(csv.c_str());
+}
+
+TEST(cPaymentBatchTest, LoadRejectsBadAmounts) {
+	for (const string & bad : { "alice,0\n", "alice,-5\n", "alice,12x\n", "alice,\n", "alice\n", ",10\n", "alice,10,memo,extra\n" }) {
+		const string csv = WriteFile("unittest-batch.csv", "bob,1\n" + bad);
+		cPaymentBatch batch;
+		EXPECT_FALSE(batch.Load(csv)) << bad;
+		std::remove(csv.c_str());
+	}
+	const string csv = WriteFile("unittest-batch.csv", "alice,ten\nbob,1\n"); // not a number in 1st line: header
+	cPaymentBatch batch;
+	EXPECT_TRUE(batch.Load(csv));
+	EXPECT_EQ(1u, batch.GetItems().size());
+	std::remove(csv.c_str());
+	EXPECT_FALSE(batch.Load("unittest-batch-missing.csv"));
+}
+
+TEST(cPaymentBatchTest, ManifestAndSavedInstruments) {
+	cPaymentBatch batch;
+	const string manifest = "unittest-batch.manifest.csv";
+	ASSERT_TRUE(batch.OpenManifest(manifest, "cheque", false));
+	const cBatchItem item{ 3, "alice", 10, "" };
+	const string file = batch.SaveInstrument(item, "cheque", "-----BEGIN CHEQUE-----");
+	EXPECT_EQ("unittest-batch.manifest.3.cheque", file);
+	EXPECT_EQ("-----BEGIN CHEQUE-----", ReadFile(file));
+	batch.Record(item, "ID-alice", true, 77, "", file);
+	batch.Record(cBatchItem{ 4, "bob", 5, "" }, "ID-bob", false, 0, "not enough transaction numbers");
+	EXPECT_EQ(1u, batch.GetIssued());
+	EXPECT_EQ(1u, batch.GetFailed());
+	EXPECT_EQ("line,recipient,recipient_id,amount,status,transaction,detail,file\n"
+		"3,alice,ID-alice,10,issued,77,,unittest-batch.manifest.3.cheque\n"
+		"4,bob,ID-bob,5,failed,,not enough transaction numbers,\n", ReadFile(manifest));
+	std::remove(file.c_str());
+	std::remove(manifest.c_str());
+}
+
+TEST(cPaymentBatchTest, EarlierRunIsNotOverwritten) {
+	const string csv = WriteFile("unittest-batch-rerun.csv", "alice,10\nbob,20\n");
+	const string manifest = "unittest-batch-rerun.manifest.csv";
+	cPaymentBatch first;
+	ASSERT_TRUE(first.Load(csv));
+	ASSERT_TRUE(first.OpenManifest(manifest, "cheque", false));
+	const string cheque = first.SaveInstrument(first.GetItems().at(1), "cheque", "first run");
+	EXPECT_EQ("unittest-batch-rerun.manifest.2.cheque", cheque);
+	EXPECT_EQ("", first.SaveInstrument(first.GetItems().at(1), "cheque", "again")); // the same item twice
+	first.Record(first.GetItems().at(1), "ID-bob", true, 5, "", cheque);
+
+	cPaymentBatch again;
+	ASSERT_TRUE(again.Load(csv));
+	EXPECT_FALSE(again.OpenManifest(manifest, "cheque", false));
+	EXPECT_NE(string::npos, ReadFile(manifest).find("issued")); // kept
+	std::remove(manifest.c_str());
+	EXPECT_FALSE(again.OpenManifest(manifest, "cheque", false)); // manifest gone, but the cheque of earlier run is there
+	EXPECT_EQ("first run", ReadFile(cheque));
+
+	ASSERT_TRUE(again.OpenManifest(manifest, "cheque", true)); // asked for
+	EXPECT_EQ(cheque, again.SaveInstrument(again.GetItems().at(1), "cheque", "second run"));
+	EXPECT_EQ("second run", ReadFile(cheque));
+	EXPECT_EQ("line,recipient,recipient_id,amount,status,transaction,detail,file\n", ReadFile(manifest));
+
+	for (const auto & file : { csv, manifest, cheque }) std::remove(file.c_str());
+}
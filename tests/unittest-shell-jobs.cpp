@@ -0,0 +1,110 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/shell_jobs.hpp"
+
+#include <atomic>
+
+using namespace nOT::nOTHint;
+
+namespace {
+
+// Runs nothing: remembers the order of commands; "fail" fails, "hold" waits until released
+struct cFakeRunner {
+	std::mutex mMutex;
+	std::condition_variable mCond;
+	vector<string> mRan;
+	bool mHeld = false, mReleased = false;
+
+	cShellJobs::tRunner Runner() {
+		return [this] (const string & cmd) -> bool {
+			std::unique_lock<std::mutex> lock(mMutex);
+			mRan.push_back(cmd);
+			if (cmd == "hold") {
+				mHeld = true;
+				mCond.notify_all();
+				mCond.wait(lock, [this]() { return mReleased; } );
+			}
+			if (cmd == "print") cout << "output of print" << endl;
+			return cmd != "fail";
+		};
+	}
+	void WaitHeld() { std::unique_lock<std::mutex> lock(mMutex); mCond.wait(lock, [this]() { return mHeld; } ); }
+	void Release() { { std::lock_guard<std::mutex> lock(mMutex); mReleased = true; } mCond.notify_all(); }
+};
+
+} // namespace
+
+TEST(cShellJobsTest, KeepsOrderOfBackgroundAndForeground) {
+	cFakeRunner runner;
+	cShellJobs jobs(runner.Runner(), 16);
+	EXPECT_EQ(1, jobs.Submit("a"));
+	EXPECT_EQ(2, jobs.Submit("b"));
+	EXPECT_TRUE(jobs.RunForeground("c")); // waits for its turn after a and b
+	EXPECT_EQ((vector<string>{ "a", "b", "c" }), runner.mRan);
+	EXPECT_FALSE(jobs.RunForeground("fail"));
+	EXPECT_FALSE(jobs.IsBusy());
+}
+
+TEST(cShellJobsTest, QueueLimitCountsOnlyWaitingBackgroundJobs) {
+	cFakeRunner runner;
+	cShellJobs jobs(runner.Runner(), 2);
+	EXPECT_EQ(1, jobs.Submit("hold"));
+	runner.WaitHeld(); // running - not in the queue any more
+	EXPECT_EQ(2, jobs.Submit("x"));
+	EXPECT_EQ(3, jobs.Submit("y"));
+	EXPECT_EQ(-1, jobs.Submit("z"));
+	EXPECT_TRUE(jobs.IsBusy());
+	runner.Release();
+	EXPECT_TRUE(jobs.Wait());
+	EXPECT_EQ(4, jobs.Submit("z")); // room again
+	EXPECT_TRUE(jobs.Wait());
+}
+
+TEST(cShellJobsTest, WaitForOneOrAllJobs) {
+	cFakeRunner runner;
+	cShellJobs jobs(runner.Runner(), 16);
+	const int ok = jobs.Submit("a");
+	const int failed = jobs.Submit("fail");
+	EXPECT_TRUE(jobs.Wait(ok));
+	EXPECT_FALSE(jobs.Wait(failed));
+	EXPECT_FALSE(jobs.Wait()); // one of all failed
+	EXPECT_FALSE(jobs.Wait(999)); // no such job
+
+	std::ostringstream report;
+	jobs.DisplayFinished(report);
+	EXPECT_EQ("[1]  Done  a\n[2]  Failed  fail\n", report.str());
+	EXPECT_FALSE(jobs.Wait(ok)); // reported, so forgotten
+	EXPECT_TRUE(jobs.Wait());
+}
+
+TEST(cShellJobsTest, BackgroundOutputIsShownWithItsReport) {
+	cFakeRunner runner;
+	std::ostringstream screen;
+	std::streambuf * const original = cout.rdbuf(screen.rdbuf());
+	{
+		cShellJobs jobs(runner.Runner(), 16);
+		jobs.Submit("print");
+		EXPECT_TRUE(jobs.Wait());
+		cout << "prompt" << endl; // this thread is not captured
+		EXPECT_NE(string::npos, screen.str().find("prompt\n"));
+		EXPECT_EQ(string::npos, screen.str().find("output of print")); // (the screen has also the log)
+		jobs.DisplayFinished(cout);
+		EXPECT_NE(string::npos, screen.str().find("prompt\n[1]  Done  print\noutput of print\n"));
+
+		const size_t before = screen.str().size();
+		EXPECT_TRUE(jobs.RunForeground("print")); // foreground prints as it goes
+		EXPECT_NE(string::npos, screen.str().find("output of print\n", before));
+	}
+	cout.rdbuf(original);
+}
+
+TEST(cShellJobsTest, ParseQueueMax) {
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax(nullptr, 16));
+	EXPECT_EQ(4u, cShellJobs::ParseQueueMax("4", 16));
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax("0", 16));
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax("", 16));
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax("-3", 16));
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax("8x", 16));
+	EXPECT_EQ(16u, cShellJobs::ParseQueueMax("99999999999999999999", 16));
+}
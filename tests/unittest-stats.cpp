@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/stats.hpp"
+
+#include <csignal>
+
+using namespace nOT::nUtils;
+
+TEST(cStatsTest, CallNameIsEntryPointWithoutArguments) {
+	EXPECT_EQ("OTAPI_Wrap::LoadInbox", cStats::CallName("OTAPI_Wrap::", "LoadInbox(srv, nym, GetId(acc))"));
+	EXPECT_EQ("cmd::_Parse", cStats::CallName("", "cmd::_Parse"));
+}
+
+TEST(cStatsTest, CountsCallsAndReturnedBytes) {
+	const bool wasEnabled = gStats.IsEnabled();
+	gStats.Enable(true);
+	for (int i = 0; i < 2; ++i) { // 2nd time the same sites count again
+		EXPECT_EQ("abcd", StatsCall(_stats_site("test::", "Text(1)"), [] () { return string("abcd"); }));
+		EXPECT_EQ(7, StatsCall(_stats_site("test::", "Number()"), [] () { return 7; }));
+	}
+	EXPECT_EQ("abcd", StatsCall(_stats_site("test::", "Text(2)"), [] () { return string("abcd"); })); // other site, same name
+	bool called = false;
+	StatsCall(_stats_site("test::", "Nothing()"), [&called] () { called = true; });
+	EXPECT_TRUE(called);
+
+	std::ostringstream json;
+	gStats.ReportJson(json);
+	EXPECT_NE(string::npos, json.str().find("{\"name\":\"test::Text\",\"calls\":3,")) << json.str();
+	EXPECT_NE(string::npos, json.str().find("\"bytes\":12}")) << json.str();
+	EXPECT_NE(string::npos, json.str().find("{\"name\":\"test::Number\",\"calls\":2,")) << json.str();
+	EXPECT_NE(string::npos, json.str().find("\"name\":\"test::Nothing\"")) << json.str();
+	if (!wasEnabled) gStats.Disable();
+}
+
+TEST(cStatsTest, TraceWritesSpansOnFlush) {
+	const string file = "unittest-trace.json";
+	gTrace.Enable(file);
+	gTrace.SetThreadName("test-main");
+	StatsCall(_stats_site("OTAPI_Wrap::", "LoadInbox(a, b)"), [] () { return string("inbox"); });
+	{
+		_stats_scope("cmd::_Parse");
+	}
+	gTrace.Flush();
+
+	std::ifstream in(file);
+	const string json( (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>() );
+	EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+	EXPECT_NE(string::npos, json.find("{\"name\":\"OTAPI_Wrap::LoadInbox\",\"cat\":\"otapi\",\"ph\":\"X\"")) << json;
+	EXPECT_NE(string::npos, json.find("{\"name\":\"cmd::_Parse\",\"cat\":\"cli\",\"ph\":\"X\"")) << json;
+	EXPECT_NE(string::npos, json.find("\"args\":{\"name\":\"test-main\"}")) << json;
+	EXPECT_FALSE(gTrace.IsEnabled()); // written once
+	std::remove(file.c_str());
+}
+
+TEST(cStatsTest, TraceWritesOutFullBufferInsteadOfDropping) {
+	const string file = "unittest-trace-full.json";
+	cTrace trace;
+	trace.Enable(file);
+	const size_t count = 1000000 + 10; // over the buffer
+	for (size_t i = 0; i < count; ++i) trace.AddSpan("span", "cli", i, 1);
+	trace.Flush();
+
+	std::ifstream in(file);
+	const string json( (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>() );
+	size_t spans = 0;
+	for (size_t pos = json.find("{\"name\":\"span\""); pos != string::npos; pos = json.find("{\"name\":\"span\"", pos + 1)) ++spans;
+	EXPECT_EQ(count, spans);
+	EXPECT_NE(string::npos, json.find("{\"name\":\"trace-write\",\"cat\":\"trace\""));
+	EXPECT_NE(string::npos, json.find("\"otherData\":{\"dropped\":0}}\n"));
+	std::remove(file.c_str());
+}
+
+TEST(cStatsTest, TerminateSignalIsOnlyNoted) {
+	cTrace::CatchTerminate();
+	EXPECT_FALSE(cTrace::TerminateRequested());
+	std::raise(SIGTERM); // the process goes on, its loop can end and Flush
+	EXPECT_TRUE(cTrace::TerminateRequested());
+}
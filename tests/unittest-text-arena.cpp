@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/text_arena.hpp"
+
+using namespace nOT::nUtils;
+
+TEST(cStrViewTest, ComparesAndConverts) {
+	const string text = "alice bob";
+	const cStrView alice(text.data(), 5);
+	EXPECT_EQ(5u, alice.size());
+	EXPECT_TRUE(alice == "alice");
+	EXPECT_TRUE(alice == string("alice"));
+	EXPECT_TRUE(alice != "alic");
+	EXPECT_TRUE(cStrView("alic") < alice);
+	EXPECT_FALSE(alice < cStrView("alic"));
+	EXPECT_EQ("--cc alice", "--cc " + alice);
+	EXPECT_EQ("alice!", alice + "!");
+	const string converted = alice; // where string is needed
+	EXPECT_EQ("alice", converted);
+	EXPECT_EQ(42, std::stoi(cStrView("42")));
+	std::ostringstream out;
+	out << alice;
+	EXPECT_EQ("alice", out.str());
+	EXPECT_TRUE(cStrView().empty());
+}
+
+TEST(cTextArenaTest, SpansStayValidWithinReserve) {
+	cTextArena arena;
+	arena.Reserve(64);
+	const cTextSpan a = arena.Add("msg");
+	const char * before = arena.Get(a).data();
+	const cTextSpan b = arena.Add("send");
+	const cTextSpan empty = arena.Add("");
+	EXPECT_EQ(before, arena.Get(a).data()); // no reallocation within reserve
+	EXPECT_EQ("msg", arena.Get(a).str());
+	EXPECT_EQ("send", arena.Get(b).str());
+	EXPECT_TRUE(arena.Get(empty).empty());
+	EXPECT_EQ(7u, arena.Size());
+}
+
+TEST(cSmallVecTest, InlineThenHeap) {
+	cSmallVec<int, 4> vec;
+	for (int i = 0; i < 4; ++i) vec.push_back(i * 10);
+	vec.insert(1, 5); // spills to heap
+	vec.insert(0, -1);
+	ASSERT_EQ(6u, vec.size());
+	const vector<int> expected = { -1, 0, 5, 10, 20, 30 };
+	EXPECT_TRUE(std::equal(vec.begin(), vec.end(), expected.begin()));
+	cSmallVec<int, 4> small;
+	small.push_back(3);
+	small.insert(0, 1);
+	small.insert(1, 2);
+	EXPECT_EQ(1, small[0]); EXPECT_EQ(2, small[1]); EXPECT_EQ(3, small[2]);
+	small.clear();
+	EXPECT_TRUE(small.empty());
+}
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/trans_num_pool.hpp"
+
+using namespace nOT::nUse;
+
+namespace {
+
+// Stands for the nym's transaction numbers on servers: fetch fills up to count (or fails if server is down)
+struct cFakeServer {
+	map<std::pair<string, string>, int32_t> mHave;
+	vector<int32_t> mFetched; // requested counts, in order
+	bool mDown = false;
+
+	cTransNumPool MakePool(int32_t low, int32_t high) {
+		return cTransNumPool(
+			[this] (const string & server, const string & nym) -> int32_t { return mHave[std::make_pair(server, nym)]; },
+			[this] (int32_t count, const string & server, const string & nym) -> bool {
+				mFetched.push_back(count);
+				if (mDown) return false;
+				auto & have = mHave[std::make_pair(server, nym)];
+				have = std::max(have, count);
+				return true;
+			},
+			low, high);
+	}
+	void Use(const string & server, const string & nym, int32_t count = 1) { mHave[std::make_pair(server, nym)] -= count; }
+};
+
+} // namespace
+
+TEST(cTransNumPoolTest, AcquireFetchesWholeBatchWhenShort) {
+	cFakeServer server;
+	auto pool = server.MakePool(5, 20);
+	EXPECT_TRUE(pool.Acquire("srv", "alice"));
+	EXPECT_EQ(vector<int32_t>{ 20 }, server.mFetched); // up to high watermark, not just 1
+	EXPECT_EQ(1u, pool.GetFetchCount());
+	EXPECT_FALSE(pool.HasPending());
+
+	EXPECT_TRUE(pool.Acquire("srv", "alice", 25)); // more than high is needed: fetch what is needed
+	EXPECT_EQ(25, server.mFetched.back());
+}
+
+TEST(cTransNumPoolTest, NoFetchAboveLowWatermark) {
+	cFakeServer server;
+	server.mHave[std::make_pair(string("srv"), string("alice"))] = 10;
+	auto pool = server.MakePool(5, 20);
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_TRUE(pool.Acquire("srv", "alice"));
+		server.Use("srv", "alice");
+	}
+	EXPECT_FALSE(pool.HasPending()); // 5 left, still at low watermark
+	EXPECT_TRUE(pool.Acquire("srv", "alice"));
+	EXPECT_TRUE(server.mFetched.empty()); // instruments did not wait for server
+	EXPECT_TRUE(pool.HasPending()); // but this use leaves 4 - below low, to top up later
+}
+
+TEST(cTransNumPoolTest, ReplenishTopsUpOnlyPoolsBelowLow) {
+	cFakeServer server;
+	server.mHave[std::make_pair(string("srv"), string("alice"))] = 6;
+	server.mHave[std::make_pair(string("srv"), string("bob"))] = 6;
+	auto pool = server.MakePool(5, 20);
+	EXPECT_TRUE(pool.Acquire("srv", "alice", 2));
+	server.Use("srv", "alice", 2);
+	EXPECT_TRUE(pool.Acquire("srv", "bob", 2)); // marked, but the instrument failed: numbers not used
+	ASSERT_TRUE(pool.HasPending());
+
+	pool.Replenish();
+	EXPECT_EQ(vector<int32_t>{ 20 }, server.mFetched); // only alice
+	EXPECT_EQ(20, server.mHave[std::make_pair(string("srv"), string("alice"))]);
+	EXPECT_FALSE(pool.HasPending());
+	pool.Replenish(); // nothing left to do
+	EXPECT_EQ(1u, server.mFetched.size());
+}
+
+TEST(cTransNumPoolTest, FailedFetch) {
+	cFakeServer server;
+	server.mDown = true;
+	auto pool = server.MakePool(5, 20);
+	EXPECT_FALSE(pool.Acquire("srv", "alice"));
+
+	server.mHave[std::make_pair(string("srv"), string("bob"))] = 1;
+	EXPECT_TRUE(pool.Acquire("srv", "bob")); // enough for this one, even when the batch can not be got
+	server.Use("srv", "bob");
+	pool.Replenish(); // warns, next Acquire tries again
+	EXPECT_FALSE(pool.Acquire("srv", "bob"));
+}
+
+TEST(cTransNumPoolTest, Watermarks) {
+	cFakeServer server;
+	auto pool = server.MakePool(5, 20);
+	pool.SetWatermarks(10, 3);
+	EXPECT_EQ(10, pool.GetLow());
+	EXPECT_EQ(11, pool.GetHigh()); // high is at least low+1
+	pool.SetWatermarks(-4, 8);
+	EXPECT_EQ(0, pool.GetLow());
+	EXPECT_EQ(8, pool.GetHigh());
+}
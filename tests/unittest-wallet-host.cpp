@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/wallet_host.hpp"
+
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace nOT::nUse;
+
+TEST(cSessionLruTest, EvictsIdleAfterTimeout) {
+	cSessionLru lru(1000, 10, 60);
+	lru.Touch("a", 100);
+	lru.Touch("b", 130);
+	EXPECT_TRUE(lru.PickEvictions(150).empty());
+	EXPECT_EQ(vector<string>{ "a" }, lru.PickEvictions(165));
+	EXPECT_EQ((vector<string>{ "a", "b" }), lru.PickEvictions(200));
+}
+
+TEST(cSessionLruTest, EvictsLeastRecentlyUsedOverBudget) {
+	cSessionLru lru(250, 10, 3600);
+	lru.Touch("a", 1); lru.SetBytes("a", 100);
+	lru.Touch("b", 2); lru.SetBytes("b", 100);
+	lru.Touch("c", 3); lru.SetBytes("c", 100);
+	EXPECT_EQ(300u, lru.GetTotalBytes());
+	EXPECT_EQ(vector<string>{ "a" }, lru.PickEvictions(4));
+	lru.Touch("a", 5); // now b is least recently used
+	EXPECT_EQ(vector<string>{ "b" }, lru.PickEvictions(6));
+	EXPECT_EQ(vector<string>{ "c" }, lru.PickEvictions(6, "b")); // b is kept (e.g. just routed to)
+}
+
+TEST(cSessionLruTest, KeepsSessionsWithRequestsInFlight) {
+	cSessionLru lru(0, 1, 10);
+	lru.Touch("a", 1);
+	lru.Touch("b", 2);
+	lru.Begin("a");
+	EXPECT_EQ(vector<string>{ "b" }, lru.PickEvictions(100));
+	lru.End("a");
+	EXPECT_EQ((vector<string>{ "a", "b" }), lru.PickEvictions(100));
+	lru.Erase("a");
+	EXPECT_FALSE(lru.Has("a"));
+	EXPECT_EQ(1u, lru.GetCount());
+}
+
+TEST(cSessionLruTest, EvictsOverSessionCount) {
+	cSessionLru lru(1000000, 2, 3600);
+	lru.Touch("a", 1); lru.Touch("b", 2); lru.Touch("c", 3);
+	EXPECT_EQ(vector<string>{ "a" }, lru.PickEvictions(4));
+}
+
+namespace {
+
+// fake worker: answers "<home>|<line>|<request number in this process>", so a test can see which process served it;
+// wallet "/crash" exits on its first request, "/slow" does not read requests for a while
+int EchoWorker(const string & home, int requestFd, int doneFd) {
+	if (home == "/slow") std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	FILE * requests = fdopen(requestFd, "r");
+	char buff[4096];
+	int served = 0;
+	while (fgets(buff, sizeof(buff), requests)) {
+		if (home == "/crash") return 3;
+		string request(buff);
+		request.erase(request.size() - 1);
+		const size_t sep1 = request.find(' '), sep2 = request.find(' ', sep1 + 1);
+		const string reply = request.substr(sep1 + 1, sep2 - sep1 - 1);
+		const string text = home + "|" + request.substr(sep2 + 1) + "|" + nOT::nUtils::ToStr(++served);
+		const int fd = cWalletHost::OpenReply(reply);
+		if (fd < 0) return 2;
+		if (write(fd, text.c_str(), text.size()) < 0) return 1;
+		close(fd);
+		cWalletHost::MarkReady(reply);
+		const string done = nOT::nUtils::ToStr(getpid()) + "\n";
+		if (write(doneFd, done.c_str(), done.size()) < 0) return 1;
+	}
+	return 0;
+}
+
+void Send(const string & pipe, const string & request) {
+	int fd = open(pipe.c_str(), O_WRONLY);
+	ASSERT_GE(fd, 0);
+	ASSERT_EQ((ssize_t)request.size(), write(fd, request.c_str(), request.size()));
+	close(fd);
+}
+
+bool Exists(const string & path) {
+	struct stat info;
+	return lstat(path.c_str(), &info) == 0;
+}
+
+string WaitReply(const string & reply) {
+	for (int i = 0; i < 2000; ++i) {
+		if (std::ifstream(reply + ".ready").good()) {
+			std::ifstream in(reply);
+			string text;
+			std::getline(in, text);
+			unlink(reply.c_str()); unlink((reply + ".ready").c_str());
+			return text;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	return "timeout";
+}
+
+
+// runs host on a pipe in a new private directory; Stop sends QUIT and returns its exit status
+struct cHostRunner {
+	const string mDir = "/tmp/ot.host.test." + nOT::nUtils::ToStr(getpid());
+	const string mPipe = mDir + "/in";
+	int mStatus = -1;
+	std::thread mThread;
+
+	explicit cHostRunner(size_t maxSessions) {
+		mThread = std::thread([this, maxSessions] {
+			cWalletHost host(mPipe, EchoWorker, 1024u * 1024 * 1024, maxSessions, 3600);
+			mStatus = host.Run();
+		});
+		for (int i = 0; (i < 1000) && !Exists(mPipe) && (mStatus < 0); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	int Stop() {
+		Send(mPipe, "QUIT\n");
+		mThread.join();
+		return mStatus;
+	}
+};
+
+} // namespace
+
+TEST(cWalletHostTest, RoutesToWarmSessionPerWallet) {
+	cHostRunner runner(1); // one session at a time
+	const string & pipe = runner.mPipe;
+	const string reply = runner.mDir + "/1.out";
+	struct stat info;
+	ASSERT_EQ(0, lstat(runner.mDir.c_str(), &info));
+	EXPECT_EQ(0700u, info.st_mode & 0777u);
+
+	Send(pipe, "run " + reply + " /w1 ot account ls\n");
+	EXPECT_EQ("/w1|ot account ls|1", WaitReply(reply));
+	Send(pipe, "run " + reply + " /w1 ot nym ls\n");
+	EXPECT_EQ("/w1|ot nym ls|2", WaitReply(reply)); // same warm worker
+	Send(pipe, "run " + reply + " /w2 ot nym ls\n");
+	EXPECT_EQ("/w2|ot nym ls|1", WaitReply(reply));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50)); // host sees /w2 answered, evicts /w1 (max 1 session)
+	Send(pipe, "run " + reply + " /w1 ot nym ls\n");
+	EXPECT_EQ("/w1|ot nym ls|1", WaitReply(reply)); // new worker
+	EXPECT_EQ(0, runner.Stop());
+}
+
+TEST(cWalletHostTest, RepliesOnlyInsideItsDirectory) {
+	cHostRunner runner(4);
+	const string outside = runner.mDir + ".outside";
+	Send(runner.mPipe, "run " + outside + " /w1 ot nym ls\n");
+	Send(runner.mPipe, "run " + runner.mDir + "/../x.out /w1 ot nym ls\n");
+	const string reply = runner.mDir + "/1.out";
+	Send(runner.mPipe, "run " + reply + " /w1 ot account ls\n");
+	EXPECT_EQ("/w1|ot account ls|1", WaitReply(reply)); // the refused ones were not run
+	EXPECT_FALSE(Exists(outside));
+
+	const string planted = runner.mDir + "/2.out"; // an existing file (or symlink) is never written through
+	ASSERT_EQ(0, symlink(outside.c_str(), planted.c_str()));
+	Send(runner.mPipe, "run " + planted + " /w1 ot nym ls\n");
+	EXPECT_EQ(0u, WaitReply(planted).find("ERROR: ")); // worker could not create it, host answered instead
+	EXPECT_FALSE(Exists(outside));
+	EXPECT_EQ(0, runner.Stop());
+}
+
+TEST(cWalletHostTest, RefusesDirectoryOfOthers) {
+	const string dir = "/tmp/ot.host.test.open." + nOT::nUtils::ToStr(getpid());
+	ASSERT_EQ(0, mkdir(dir.c_str(), 0777));
+	ASSERT_EQ(0, chmod(dir.c_str(), 0777));
+	cWalletHost host(dir + "/in", EchoWorker, 1024u * 1024, 1, 3600);
+	EXPECT_EQ(1, host.Run());
+	EXPECT_FALSE(Exists(dir + "/in"));
+	rmdir(dir.c_str());
+}
+
+TEST(cWalletHostTest, ErrorReplyWhenWorkerExits) {
+	cHostRunner runner(4);
+	const string reply = runner.mDir + "/1.out";
+	Send(runner.mPipe, "run " + reply + " /crash ot nym ls\n");
+	EXPECT_EQ(0u, WaitReply(reply).find("ERROR: ")); // not a timeout
+	EXPECT_EQ(0, runner.Stop());
+}
+
+TEST(cWalletHostTest, BusyWorkerDoesNotStallOthers) {
+	cHostRunner runner(4);
+	const string big(3000, 'x');
+	for (int i = 0; i < 40; ++i) { // more than its pipe takes, while it does not read
+		const string reply = runner.mDir + "/slow" + nOT::nUtils::ToStr(i) + ".out";
+		Send(runner.mPipe, "run " + reply + " /slow " + big + "\n");
+	}
+	const string reply = runner.mDir + "/1.out";
+	const auto start = std::chrono::steady_clock::now();
+	Send(runner.mPipe, "run " + reply + " /w1 ot nym ls\n");
+	EXPECT_EQ("/w1|ot nym ls|1", WaitReply(reply));
+	EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(250)); // did not wait for /slow
+	for (int i = 0; i < 40; ++i) {
+		const string slow = runner.mDir + "/slow" + nOT::nUtils::ToStr(i) + ".out";
+		EXPECT_EQ("/slow|" + big + "|" + nOT::nUtils::ToStr(i + 1), WaitReply(slow)); // all delivered later, in order
+	}
+	EXPECT_EQ(0, runner.Stop());
+}
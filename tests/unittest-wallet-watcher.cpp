@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "../src/base/lib_common2.hpp"
+#include "../src/base/wallet_watcher.hpp"
+
+#include <chrono>
+#include <cstdlib>
+
+using namespace nOT::nUse;
+
+namespace {
+
+string MakeDataFolder(bool withSegments = true) {
+	char tmpl[] = "/tmp/otcli-watcher-XXXXXX";
+	string dir = string(mkdtemp(tmpl)) + "/";
+	if (!withSegments) return dir;
+	for (auto sub : { "client_data", "client_data/nyms", "client_data/accounts", "client_data/contracts", "client_data/addressbook" })
+		EXPECT_EQ(0, system(("mkdir -p " + dir + sub).c_str()));
+	return dir;
+}
+
+void Touch(const string & file) { std::ofstream(file) << "x" << endl; }
+
+// Collects changes until the expected ones came, and then until it is quiet: one write gives more events
+// (e.g. IN_CREATE and IN_CLOSE_WRITE), a late one must not be left for the next check
+unsigned WaitForChange(cWalletWatcher & watcher, unsigned expected) {
+	unsigned changed = 0;
+	for (int i = 0; i < 200 && (changed & expected) != expected; ++i) {
+		changed |= watcher.TakeChanged();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	for (int quiet = 0; quiet < 10; ) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		const unsigned more = watcher.TakeChanged();
+		changed |= more;
+		quiet = more ? 0 : quiet + 1;
+	}
+	return changed;
+}
+
+} // namespace
+
+#ifdef __linux__
+
+TEST(cWalletWatcherTest, MarksOnlyAffectedSegments) {
+	const string dir = MakeDataFolder();
+	cWalletWatcher watcher(dir);
+	ASSERT_TRUE(watcher.IsActive());
+	EXPECT_EQ(0u, watcher.TakeChanged());
+
+	Touch(dir + "client_data/nyms/abc");
+	EXPECT_EQ(unsigned(cWalletWatcher::eNyms), WaitForChange(watcher, cWalletWatcher::eNyms));
+
+	Touch(dir + "defaults.opt");
+	EXPECT_EQ(unsigned(cWalletWatcher::eDefaults), WaitForChange(watcher, cWalletWatcher::eDefaults));
+
+	Touch(dir + "client_data/addressbook/abc");
+	EXPECT_EQ(unsigned(cWalletWatcher::eAddressBook), WaitForChange(watcher, cWalletWatcher::eAddressBook));
+	EXPECT_EQ(0u, watcher.TakeChanged()); // taken already (WaitForChange waited until quiet)
+	EXPECT_GE(watcher.GetGeneration(), 3u);
+	EXPECT_EQ(0, system(("rm -rf " + dir).c_str()));
+}
+
+TEST(cWalletWatcherTest, IgnoresOtherFiles) {
+	const string dir = MakeDataFolder();
+	cWalletWatcher watcher(dir);
+	Touch(dir + "some-log.txt"); // in data folder, but not defaults.opt
+	Touch(dir + "client_data/other.xml");
+	Touch(dir + "client_data/wallet.xml");
+	EXPECT_EQ(unsigned(cWalletWatcher::eWallet), WaitForChange(watcher, cWalletWatcher::eWallet)); // not nyms etc.
+	EXPECT_EQ(0, system(("rm -rf " + dir).c_str()));
+}
+
+TEST(cWalletWatcherTest, WatchesDirectoriesCreatedLater) {
+	const string dir = MakeDataFolder(false); // new wallet: no client_data yet
+	cWalletWatcher watcher(dir);
+	ASSERT_TRUE(watcher.IsActive());
+
+	EXPECT_EQ(0, system(("mkdir -p " + dir + "client_data/nyms").c_str()));
+	WaitForChange(watcher, cWalletWatcher::eNyms); // directory appeared
+	Touch(dir + "client_data/nyms/abc");
+	EXPECT_EQ(unsigned(cWalletWatcher::eNyms), WaitForChange(watcher, cWalletWatcher::eNyms));
+
+	Touch(dir + "client_data/wallet.xml");
+	EXPECT_EQ(unsigned(cWalletWatcher::eWallet), WaitForChange(watcher, cWalletWatcher::eWallet));
+
+	EXPECT_EQ(0, system(("mkdir -p " + dir + "client_data/accounts").c_str()));
+	WaitForChange(watcher, cWalletWatcher::eAccounts);
+	Touch(dir + "client_data/accounts/abc");
+	EXPECT_EQ(unsigned(cWalletWatcher::eAccounts), WaitForChange(watcher, cWalletWatcher::eAccounts));
+	EXPECT_EQ(0, system(("rm -rf " + dir).c_str()));
+}
+
+#endif
+
+TEST(cWalletWatcherTest, SegmentsToStr) {
+	EXPECT_EQ("nyms,addressbook", cWalletWatcher::SegmentsToStr(cWalletWatcher::eNyms | cWalletWatcher::eAddressBook));
+	EXPECT_EQ("", cWalletWatcher::SegmentsToStr(0));
+}